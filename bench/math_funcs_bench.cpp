@@ -0,0 +1,1374 @@
+// Micro-benchmarks for everything in noob/math/math_funcs.hpp.
+//
+// Every public function is timed for float and double, in its scalar form and, where one exists, its batch form.
+// Each case walks a pool of precomputed random inputs so nothing gets constant-folded, and reports the best of several
+// repetitions as ns/op, millions of ops per second and timestamp-counter cycles per op (x86 only, zero elsewhere).
+//
+// Build it next to the headers with whatever flags the engine ships with, eg:
+//	g++ -std=c++14 -O3 -march=native -Iinclude -I/usr/include/eigen3 bench/math_funcs_bench.cpp -o math_funcs_bench -lpthread
+//
+// Usage:
+//	math_funcs_bench [--csv | --json] [--filter <substring>] [--min-ms <milliseconds>] [--reps <count>] [--size <elements>] [--scene <boxes>]
+//
+// --csv and --json print one record per case so two runs can be diffed or loaded into a spreadsheet.
+// --scene sets the number of boxes in the BVH build and query cases (default 2^20).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "noob/math/math_funcs.hpp"
+#include "noob/math/frustum.hpp"
+#include "noob/math/bvh.hpp"
+#include "noob/math/ray_packet.hpp"
+#include "noob/math/aabb_tree.hpp"
+#include "noob/math/sweep_and_prune.hpp"
+#include "noob/math/track.hpp"
+#include "noob/math/skinning.hpp"
+#include "noob/math/transform_hierarchy.hpp"
+#include "noob/math/transform.hpp"
+#include "noob/math/packed.hpp"
+#include "noob/math/parallel_batch.hpp"
+
+namespace
+{
+	///////////////////
+	// HARNESS:
+	///////////////////
+
+	// Keeps the optimizer from discarding a result or hoisting loads out of the timed loop.
+	template <typename T>
+		inline void do_not_optimize(const T& value) noexcept(true)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			asm volatile("" : : "g"(&value) : "memory");
+#else
+			static volatile const void* sink;
+			sink = &value;
+#endif
+		}
+
+	inline void clobber_memory() noexcept(true)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#elif defined(_MSC_VER)
+		_ReadWriteBarrier();
+#endif
+	}
+
+	inline uint64_t read_tsc() noexcept(true)
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	enum class output_format
+	{
+		TABLE, CSV, JSON
+	};
+
+	struct bench_result
+	{
+		std::string name, type, form;
+		size_t ops;
+		double ns_per_op, mops_per_sec, cycles_per_op;
+	};
+
+	class bench_runner
+	{
+		public:
+			output_format format = output_format::TABLE;
+			std::string filter;
+			double min_ms = 20.0;
+			uint32_t reps = 5;
+
+			// Times fn(), which performs ops_per_call operations per invocation.
+			template <typename F>
+				void run(const std::string& name, const char* type, const char* form, size_t ops_per_call, F&& fn)
+				{
+					if (!filter.empty() && name.find(filter) == std::string::npos && std::string(type).find(filter) == std::string::npos && std::string(form).find(filter) == std::string::npos) return;
+
+					typedef std::chrono::steady_clock clock;
+
+					// Warm up and find how many calls fill min_ms.
+					size_t calls = 1;
+					for (;;)
+					{
+						const auto start = clock::now();
+						for (size_t i = 0; i < calls; ++i)
+						{
+							clobber_memory();
+							fn();
+						}
+						const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+						if (ms >= min_ms * 0.5 || calls >= (size_t(1) << 30)) break;
+						calls *= 2;
+					}
+
+					double best_ns = std::numeric_limits<double>::max();
+					double best_cycles = std::numeric_limits<double>::max();
+					for (uint32_t r = 0; r < reps; ++r)
+					{
+						const uint64_t tsc_start = read_tsc();
+						const auto start = clock::now();
+						for (size_t i = 0; i < calls; ++i)
+						{
+							clobber_memory();
+							fn();
+						}
+						const auto stop = clock::now();
+						const uint64_t tsc_stop = read_tsc();
+
+						const double total_ops = static_cast<double>(calls) * static_cast<double>(ops_per_call);
+						best_ns = std::min(best_ns, std::chrono::duration<double, std::nano>(stop - start).count() / total_ops);
+						best_cycles = std::min(best_cycles, static_cast<double>(tsc_stop - tsc_start) / total_ops);
+					}
+
+					bench_result res;
+					res.name = name;
+					res.type = type;
+					res.form = form;
+					res.ops = ops_per_call;
+					res.ns_per_op = best_ns;
+					res.mops_per_sec = 1000.0 / best_ns;
+					res.cycles_per_op = best_cycles;
+					results.push_back(res);
+
+					if (format == output_format::TABLE)
+					{
+						std::printf("%-40s %-7s %-8s %12.3f %12.2f %12.2f\n", res.name.c_str(), res.type.c_str(), res.form.c_str(), res.ns_per_op, res.mops_per_sec, res.cycles_per_op);
+						std::fflush(stdout);
+					}
+				}
+
+			void print_header() const
+			{
+				if (format == output_format::TABLE)
+				{
+					std::printf("%-40s %-7s %-8s %12s %12s %12s\n", "function", "type", "form", "ns/op", "Mops/s", "cycles/op");
+				}
+			}
+
+			void print_footer() const
+			{
+				if (format == output_format::CSV)
+				{
+					std::printf("function,type,form,ops_per_call,ns_per_op,mops_per_sec,cycles_per_op\n");
+					for (const bench_result& r : results)
+					{
+						std::printf("%s,%s,%s,%zu,%.4f,%.4f,%.4f\n", csv_field(r.name).c_str(), csv_field(r.type).c_str(), csv_field(r.form).c_str(), r.ops, r.ns_per_op, r.mops_per_sec, r.cycles_per_op);
+					}
+				}
+				else if (format == output_format::JSON)
+				{
+					std::printf("{\n\t\"compiler\": \"%s\",\n\t\"simd\": \"%s\",\n\t\"results\": [\n", json_string(compiler_name()).c_str(), json_string(simd_name()).c_str());
+					for (size_t i = 0; i < results.size(); ++i)
+					{
+						const bench_result& r = results[i];
+						std::printf("\t\t{\"function\": \"%s\", \"type\": \"%s\", \"form\": \"%s\", \"ops_per_call\": %zu, \"ns_per_op\": %.4f, \"mops_per_sec\": %.4f, \"cycles_per_op\": %.4f}%s\n", json_string(r.name).c_str(), json_string(r.type).c_str(), json_string(r.form).c_str(), r.ops, r.ns_per_op, r.mops_per_sec, r.cycles_per_op, i + 1 < results.size() ? "," : "");
+					}
+					std::printf("\t]\n}\n");
+				}
+			}
+
+			// Names like "convert(vec2)<float,double>" contain commas, so every CSV field is quoted, with quotes doubled.
+			static std::string csv_field(const std::string& field)
+			{
+				std::string results = "\"";
+				for (char c : field)
+				{
+					if (c == '"') results += '"';
+					results += c;
+				}
+				return results + "\"";
+			}
+
+			// Escapes quotes, backslashes and control characters for use inside a JSON string.
+			static std::string json_string(const std::string& text)
+			{
+				std::string results;
+				for (char c : text)
+				{
+					if (c == '"' || c == '\\')
+					{
+						results += '\\';
+						results += c;
+					}
+					else if (static_cast<unsigned char>(c) < 0x20)
+					{
+						char escaped[8];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+						results += escaped;
+					}
+					else results += c;
+				}
+				return results;
+			}
+
+			// Looks up an earlier result, for printing speedups between variants of the same operation.
+			const bench_result* find(const std::string& name, const char* type, const char* form) const
+			{
+				for (const bench_result& r : results)
+				{
+					if (r.name == name && r.type == type && r.form == form) return &r;
+				}
+				return nullptr;
+			}
+
+			void print_speedup(const std::string& label, const bench_result* slow, const bench_result* fast) const
+			{
+				if (format != output_format::TABLE || !slow || !fast) return;
+				std::printf("  -> %s: %.2fx\n", label.c_str(), slow->ns_per_op / fast->ns_per_op);
+			}
+
+			static const char* compiler_name()
+			{
+#if defined(__clang__)
+				return "clang " __clang_version__;
+#elif defined(__GNUC__)
+				return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+				return "msvc";
+#else
+				return "unknown";
+#endif
+			}
+
+			static const char* simd_name()
+			{
+#if defined(NOOB_SIMD_AVX)
+				return "avx";
+#elif defined(NOOB_SIMD_SSE2)
+				return "sse2";
+#else
+				return "none";
+#endif
+			}
+
+		protected:
+			std::vector<bench_result> results;
+	};
+
+	///////////////////
+	// INPUT DATA:
+	///////////////////
+
+	template <typename T> const char* type_name();
+	template <> const char* type_name<float>() { return "float"; }
+	template <> const char* type_name<double>() { return "double"; }
+
+	// Random inputs shared by every case of one scalar type.
+	template <typename T>
+		struct bench_data
+		{
+			bench_data(size_t n, uint32_t seed) : count(n)
+			{
+				std::mt19937 rng(seed);
+				std::uniform_real_distribution<T> coord(-100.0, 100.0);
+				std::uniform_real_distribution<T> unit(-1.0, 1.0);
+				std::uniform_real_distribution<T> angle(0.0, 360.0);
+				std::uniform_real_distribution<T> positive(0.5, 2.0);
+
+				scalars.resize(n);
+				vecs_a.resize(n);
+				vecs_b.resize(n);
+				vecs_c.resize(n);
+				vec4s.resize(n);
+				versors_a.resize(n);
+				versors_b.resize(n);
+				mats.resize(n);
+				affine.resize(n);
+				rigid.resize(n);
+				boxes.resize(n);
+
+				for (size_t i = 0; i < n; ++i)
+				{
+					scalars[i] = angle(rng);
+					vecs_a[i] = noob::vec3_type<T>(coord(rng), coord(rng), coord(rng));
+					vecs_b[i] = noob::vec3_type<T>(coord(rng), coord(rng), coord(rng));
+					vecs_c[i] = noob::vec3_type<T>(coord(rng), coord(rng), coord(rng));
+					vec4s[i] = noob::vec4_type<T>(coord(rng), coord(rng), coord(rng), 1.0);
+					versors_a[i] = noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng)));
+					versors_b[i] = noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng)));
+
+					for (uint32_t k = 0; k < 16; ++k)
+					{
+						mats[i].m[k] = unit(rng);
+					}
+
+					const noob::mat4_type<T> rot = noob::versor_to_mat4(versors_a[i]);
+					rigid[i] = noob::translate(rot, vecs_a[i]);
+					affine[i] = noob::translate(noob::scale(rot, noob::vec3_type<T>(positive(rng), positive(rng), positive(rng))), vecs_b[i]);
+
+					boxes[i].min = noob::vec3_type<T>(std::min(vecs_a[i][0], vecs_b[i][0]), std::min(vecs_a[i][1], vecs_b[i][1]), std::min(vecs_a[i][2], vecs_b[i][2]));
+					boxes[i].max = noob::vec3_type<T>(std::max(vecs_a[i][0], vecs_b[i][0]), std::max(vecs_a[i][1], vecs_b[i][1]), std::max(vecs_a[i][2], vecs_b[i][2]));
+				}
+
+				soa_a.gather(vecs_a);
+				soa_b.gather(vecs_b);
+				soa_out.resize(n);
+				mats_soa.gather(mats.data(), n);
+				mats_soa_out.resize(n);
+				versors_soa_a.gather(versors_a);
+				versors_soa_b.gather(versors_b);
+				versors_soa_out.resize(n);
+				scalar_out.resize(n);
+				success.resize(n);
+				vec_out.resize(n);
+				vec4_out.resize(n);
+			}
+
+			size_t count;
+			std::vector<T> scalars;
+			std::vector<noob::vec3_type<T>> vecs_a, vecs_b, vecs_c;
+			std::vector<noob::vec4_type<T>> vec4s;
+			std::vector<noob::versor_type<T>> versors_a, versors_b;
+			std::vector<noob::mat4_type<T>> mats, affine, rigid;
+			std::vector<noob::bbox_type<T>> boxes;
+			noob::vec3_soa<T> soa_a, soa_b, soa_out;
+			noob::mat4_soa<T> mats_soa, mats_soa_out;
+			noob::versor_soa<T> versors_soa_a, versors_soa_b, versors_soa_out;
+			std::vector<T> scalar_out;
+			std::vector<uint8_t> success;
+			std::vector<noob::vec3_type<T>> vec_out;
+			std::vector<noob::vec4_type<T>> vec4_out;
+		};
+
+	// The plain triple loop that mat4_type::operator* replaced; kept as the baseline for the SIMD specializations.
+	template <typename T>
+		noob::mat4_type<T> reference_multiply(const noob::mat4_type<T>& a, const noob::mat4_type<T>& b) noexcept(true)
+		{
+			noob::mat4_type<T> r;
+			for (uint32_t col = 0; col < 4; ++col)
+			{
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					T sum = 0.0;
+					for (uint32_t i = 0; i < 4; ++i)
+					{
+						sum += a.m[i * 4 + row] * b.m[col * 4 + i];
+					}
+					r.m[col * 4 + row] = sum;
+				}
+			}
+			return r;
+		}
+
+	template <typename T>
+		noob::vec4_type<T> reference_multiply(const noob::mat4_type<T>& a, const noob::vec4_type<T>& v) noexcept(true)
+		{
+			noob::vec4_type<T> r;
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				T sum = 0.0;
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					sum += a.m[i * 4 + row] * v.v[i];
+				}
+				r.v[row] = sum;
+			}
+			return r;
+		}
+
+	// Scalar loop over the pool: fn(i) is one operation.
+	template <typename T, typename F>
+		void run_scalar(bench_runner& runner, const std::string& name, const bench_data<T>& d, F&& fn)
+		{
+			const size_t n = d.count;
+			runner.run(name, type_name<T>(), "scalar", n, [&]()
+					{
+						for (size_t i = 0; i < n; ++i)
+						{
+							do_not_optimize(fn(i));
+						}
+					});
+		}
+
+	// One call that processes the whole pool.
+	template <typename T, typename F>
+		void run_batch(bench_runner& runner, const std::string& name, const bench_data<T>& d, F&& fn)
+		{
+			runner.run(name, type_name<T>(), "batch", d.count, [&]()
+					{
+						fn();
+						clobber_memory();
+					});
+		}
+
+	///////////////////
+	// SUITES:
+	///////////////////
+
+	template <typename T>
+		void bench_conversions(bench_runner& runner, bench_data<T>& d)
+		{
+			typedef typename std::conditional<std::is_same<T, float>::value, double, float>::type other;
+			const std::string suffix = std::string("<") + type_name<T>() + "," + type_name<other>() + ">";
+
+			run_scalar(runner, "convert(vec2)" + suffix, d, [&](size_t i) { return noob::convert<T, other>(noob::vec2_type<T>(d.vecs_a[i][0], d.vecs_a[i][1])); });
+			run_scalar(runner, "convert(vec3)" + suffix, d, [&](size_t i) { return noob::convert<T, other>(d.vecs_a[i]); });
+			run_scalar(runner, "convert(vec4)" + suffix, d, [&](size_t i) { return noob::convert<T, other>(d.vec4s[i]); });
+			run_scalar(runner, "convert(versor)" + suffix, d, [&](size_t i) { return noob::convert<T, other>(d.versors_a[i]); });
+			run_scalar(runner, "convert(mat3)" + suffix, d, [&](size_t i) { const T* m = &d.mats[i].m[0]; return noob::convert<T, other>(noob::mat3_type<T>(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10])); });
+			run_scalar(runner, "convert(mat4)" + suffix, d, [&](size_t i) { return noob::convert<T, other>(d.mats[i]); });
+			run_scalar(runner, "vec3_from_vec4", d, [&](size_t i) { return noob::vec3_from_vec4(d.vec4s[i]); });
+			run_scalar(runner, "vec3_from_array", d, [&](size_t i) { return noob::vec3_from_array(d.vecs_a[i].v); });
+		}
+
+	// The bullet and eigen adaptors only work for float.
+	template <typename T>
+		void bench_float_only(bench_runner&, bench_data<T>&) {}
+
+	void bench_float_only(bench_runner& runner, bench_data<float>& d)
+	{
+		run_scalar(runner, "vec3f_from_bullet", d, [&](size_t i) { return noob::vec3f_from_bullet(btVector3(d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2])); });
+		run_scalar(runner, "vec3f_to_bullet", d, [&](size_t i) { return noob::vec3f_to_bullet(d.vecs_a[i]); });
+		run_scalar(runner, "vec3f_from_eigen", d, [&](size_t i) { return noob::vec3f_from_eigen(Eigen::Vector3f(d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2])); });
+		run_scalar(runner, "vec3f_from_eigen_block", d, [&](size_t i) { const Eigen::Matrix<float, 4, 1> v(d.vec4s[i][0], d.vec4s[i][1], d.vec4s[i][2], d.vec4s[i][3]); return noob::vec3f_from_eigen_block(v.head<3>()); });
+		run_scalar(runner, "versorf_from_bullet", d, [&](size_t i) { return noob::versorf_from_bullet(btQuaternion(d.versors_a[i][1], d.versors_a[i][2], d.versors_a[i][3], d.versors_a[i][0])); });
+		run_scalar(runner, "versorf_to_bullet", d, [&](size_t i) { return noob::versorf_to_bullet(d.versors_a[i]); });
+		run_scalar(runner, "versorf_from_eigen", d, [&](size_t i) { return noob::versorf_from_eigen(Eigen::Quaternion<float>(d.versors_a[i][0], d.versors_a[i][1], d.versors_a[i][2], d.versors_a[i][3])); });
+		run_scalar(runner, "mat4f_from_bullet", d, [&](size_t i) { btTransform t; do_not_optimize(i); return noob::mat4f_from_bullet(t); });
+	}
+
+	template <typename T>
+		void bench_utilities(bench_runner& runner, bench_data<T>& d)
+		{
+			run_scalar(runner, "next_pow2", d, [&](size_t i) { return noob::next_pow2(static_cast<uint32_t>(d.scalars[i] * 1000.0)); });
+			run_scalar(runner, "sign", d, [&](size_t i) { return noob::sign(d.vecs_a[i][0]); });
+			run_scalar(runner, "approximately_zero", d, [&](size_t i) { return noob::approximately_zero(static_cast<float>(d.vecs_a[i][0])); });
+			run_scalar(runner, "compare_floats", d, [&](size_t i) { return noob::compare_floats(static_cast<float>(d.vecs_a[i][0]), static_cast<float>(d.vecs_b[i][0])); });
+			run_scalar(runner, "div_fp", d, [&](size_t i) { return noob::div_fp(d.vecs_a[i][0], d.scalars[i] + 1.0); });
+			run_scalar(runner, "div_dp", d, [&](size_t i) { return noob::div_dp(d.vecs_a[i][0], d.scalars[i] + 1.0); });
+			run_scalar(runner, "min(vec2)", d, [&](size_t i) { return noob::min(noob::vec2_type<T>(d.vecs_a[i][0], d.vecs_a[i][1]), noob::vec2_type<T>(d.vecs_b[i][0], d.vecs_b[i][1])); });
+			run_scalar(runner, "max(vec2)", d, [&](size_t i) { return noob::max(noob::vec2_type<T>(d.vecs_a[i][0], d.vecs_a[i][1]), noob::vec2_type<T>(d.vecs_b[i][0], d.vecs_b[i][1])); });
+		}
+
+	template <typename T>
+		void bench_vectors(bench_runner& runner, bench_data<T>& d)
+		{
+			run_scalar(runner, "negate", d, [&](size_t i) { return noob::negate(d.vecs_a[i]); });
+			run_scalar(runner, "vec3_equality", d, [&](size_t i) { return noob::vec3_equality(d.vecs_a[i], d.vecs_b[i]); });
+			run_scalar(runner, "length_squared", d, [&](size_t i) { return noob::length_squared(d.vecs_a[i]); });
+			run_scalar(runner, "length", d, [&](size_t i) { return noob::length(d.vecs_a[i]); });
+			run_scalar(runner, "normalize(vec3)", d, [&](size_t i) { return noob::normalize(d.vecs_a[i]); });
+			run_scalar(runner, "dot(vec3)", d, [&](size_t i) { return noob::dot(d.vecs_a[i], d.vecs_b[i]); });
+			run_scalar(runner, "cross", d, [&](size_t i) { return noob::cross(d.vecs_a[i], d.vecs_b[i]); });
+			run_scalar(runner, "get_squared_dist", d, [&](size_t i) { return noob::get_squared_dist(d.vecs_a[i], d.vecs_b[i]); });
+			run_scalar(runner, "direction_to_heading", d, [&](size_t i) { return noob::direction_to_heading(d.vecs_a[i]); });
+			run_scalar(runner, "heading_to_direction", d, [&](size_t i) { return noob::heading_to_direction<T>(d.scalars[i]); });
+			run_scalar(runner, "linearly_dependent", d, [&](size_t i) { return noob::linearly_dependent(d.vecs_a[i], d.vecs_b[i], d.vecs_c[i]); });
+			run_scalar(runner, "lerp(vec3)", d, [&](size_t i) { return noob::lerp(d.vecs_a[i], d.vecs_b[i], 0.25f); });
+			run_scalar(runner, "get_normal", d, [&](size_t i) { const std::array<noob::vec3_type<T>, 3> tri = {{ d.vecs_a[i], d.vecs_b[i], d.vecs_c[i] }}; return noob::get_normal(tri); });
+
+			run_batch(runner, "dot(vec3)", d, [&]() { noob::dot(d.soa_a, d.soa_b, d.scalar_out.data()); });
+			run_batch(runner, "cross", d, [&]() { noob::cross(d.soa_a, d.soa_b, d.soa_out); });
+			run_batch(runner, "length_squared", d, [&]() { noob::length_squared(d.soa_a, d.scalar_out.data()); });
+			run_batch(runner, "length", d, [&]() { noob::length(d.soa_a, d.scalar_out.data()); });
+			run_batch(runner, "normalize(vec3)", d, [&]() { noob::normalize(d.soa_a, d.soa_out); });
+			run_batch(runner, "get_squared_dist", d, [&]() { noob::get_squared_dist(d.soa_a, d.soa_b, d.scalar_out.data()); });
+			run_batch(runner, "lerp(vec3)", d, [&]() { noob::lerp(d.soa_a, d.soa_b, static_cast<T>(0.25), d.soa_out); });
+
+			for (const char* fn : { "dot(vec3)", "cross", "length", "normalize(vec3)", "lerp(vec3)" })
+			{
+				runner.print_speedup(std::string(fn) + " batch vs scalar", runner.find(fn, type_name<T>(), "scalar"), runner.find(fn, type_name<T>(), "batch"));
+			}
+		}
+
+	// Compares an operator chain built from vector temporaries against the same chain through noob::lazy().
+	template <typename T>
+		void bench_expression_templates(bench_runner& runner, bench_data<T>& d)
+		{
+			const T s = 0.5;
+			run_scalar(runner, "chain a+(b-c)*s+a*s (eager)", d, [&](size_t i) -> noob::vec3_type<T> { return d.vecs_a[i] + (d.vecs_b[i] - d.vecs_c[i]) * s + d.vecs_a[i] * s; });
+			run_scalar(runner, "chain a+(b-c)*s+a*s (lazy)", d, [&](size_t i) -> noob::vec3_type<T> { return noob::lazy(d.vecs_a[i]) + (noob::lazy(d.vecs_b[i]) - d.vecs_c[i]) * s + noob::lazy(d.vecs_a[i]) * s; });
+			runner.print_speedup("lazy vs eager", runner.find("chain a+(b-c)*s+a*s (eager)", type_name<T>(), "scalar"), runner.find("chain a+(b-c)*s+a*s (lazy)", type_name<T>(), "scalar"));
+		}
+
+	// Angle of the rotation taking a to b, from the chord between the two (sign-corrected) quaternions; stable near zero, unlike acos of the dot.
+	template <typename T>
+		T rotation_error(const noob::versor_type<T>& a, const noob::versor_type<T>& b)
+		{
+			T minus = 0.0, plus = 0.0;
+			for (uint32_t k = 0; k < 4; ++k)
+			{
+				minus += (a.q[k] - b.q[k]) * (a.q[k] - b.q[k]);
+				plus += (a.q[k] + b.q[k]) * (a.q[k] + b.q[k]);
+			}
+			return 4.0 * std::asin(std::min(static_cast<T>(1.0), std::sqrt(std::min(minus, plus)) * static_cast<T>(0.5)));
+		}
+
+	template <typename T>
+		void bench_versors(bench_runner& runner, bench_data<T>& d)
+		{
+			run_scalar(runner, "normalize(versor)", d, [&](size_t i) { return noob::normalize(d.versors_a[i]); });
+			run_scalar(runner, "dot(versor)", d, [&](size_t i) { return noob::dot(d.versors_a[i], d.versors_b[i]); });
+			run_scalar(runner, "versor*versor", d, [&](size_t i) { return d.versors_a[i] * d.versors_b[i]; });
+			run_scalar(runner, "slerp", d, [&](size_t i) { return noob::slerp(d.versors_a[i], d.versors_b[i], 0.3f); });
+			run_scalar(runner, "nlerp", d, [&](size_t i) { return noob::nlerp(d.versors_a[i], d.versors_b[i], static_cast<T>(0.3)); });
+			run_batch(runner, "slerp", d, [&]() { noob::slerp(d.versors_soa_a, d.versors_soa_b, static_cast<T>(0.3), d.versors_soa_out); });
+			run_batch(runner, "slerp_approx", d, [&]() { noob::slerp_approx(d.versors_soa_a, d.versors_soa_b, static_cast<T>(0.3), d.versors_soa_out); });
+			run_batch(runner, "nlerp", d, [&]() { noob::nlerp(d.versors_soa_a, d.versors_soa_b, static_cast<T>(0.3), d.versors_soa_out); });
+			const bench_result* scalar_slerp = runner.find("slerp", type_name<T>(), "scalar");
+			runner.print_speedup("slerp batch vs scalar", scalar_slerp, runner.find("slerp", type_name<T>(), "batch"));
+			runner.print_speedup("slerp_approx batch vs scalar slerp", scalar_slerp, runner.find("slerp_approx", type_name<T>(), "batch"));
+			runner.print_speedup("nlerp batch vs scalar slerp", scalar_slerp, runner.find("nlerp", type_name<T>(), "batch"));
+			if (runner.format == output_format::TABLE && scalar_slerp)
+			{
+				// Largest rotation-angle difference from the scalar slerp over the data set, across the whole [0, 1] range of t.
+				noob::versor_soa<T> approx, fast;
+				T worst_approx = 0.0, worst_nlerp = 0.0;
+				for (uint32_t step = 0; step <= 8; ++step)
+				{
+					const T t = static_cast<T>(step) / 8.0;
+					noob::slerp_approx(d.versors_soa_a, d.versors_soa_b, t, approx);
+					noob::nlerp(d.versors_soa_a, d.versors_soa_b, t, fast);
+					for (size_t i = 0; i < d.count; ++i)
+					{
+						const noob::versor_type<T> exact = noob::slerp(d.versors_a[i], d.versors_b[i], static_cast<float>(t));
+						worst_approx = std::max(worst_approx, rotation_error(exact, approx.get(i)));
+						worst_nlerp = std::max(worst_nlerp, rotation_error(exact, fast.get(i)));
+					}
+				}
+				std::printf("  -> max error vs scalar slerp: slerp_approx %.2e rad, nlerp %.2e rad\n", static_cast<double>(worst_approx), static_cast<double>(worst_nlerp));
+			}
+			run_scalar(runner, "versor_from_axis_rad", d, [&](size_t i) { return noob::versor_from_axis_rad<T>(static_cast<float>(d.scalars[i]), d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2]); });
+			run_scalar(runner, "versor_from_axis_deg", d, [&](size_t i) { return noob::versor_from_axis_deg<T>(static_cast<float>(d.scalars[i]), d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2]); });
+			run_scalar(runner, "versor_to_mat4", d, [&](size_t i) { return noob::versor_to_mat4(d.versors_a[i]); });
+			run_scalar(runner, "versor_from_mat4", d, [&](size_t i) { return noob::versor_from_mat4(d.rigid[i]); });
+		}
+
+	template <typename T>
+		void bench_matrices(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+
+			run_scalar(runner, "zero_mat3", d, [&](size_t i) { do_not_optimize(i); return noob::zero_mat3<T>(); });
+			run_scalar(runner, "identity_mat3", d, [&](size_t i) { do_not_optimize(i); return noob::identity_mat3<T>(); });
+			run_scalar(runner, "zero_mat4", d, [&](size_t i) { do_not_optimize(i); return noob::zero_mat4<T>(); });
+			run_scalar(runner, "identity_mat4", d, [&](size_t i) { do_not_optimize(i); return noob::identity_mat4<T>(); });
+
+			run_scalar(runner, "mat4*mat4 (reference loop)", d, [&](size_t i) { return reference_multiply(d.mats[i], d.mats[n - 1 - i]); });
+			run_scalar(runner, "mat4*mat4", d, [&](size_t i) { return d.mats[i] * d.mats[n - 1 - i]; });
+			runner.print_speedup("mat4*mat4 vs reference loop", runner.find("mat4*mat4 (reference loop)", type_name<T>(), "scalar"), runner.find("mat4*mat4", type_name<T>(), "scalar"));
+			run_scalar(runner, "mat4*vec4 (reference loop)", d, [&](size_t i) { return reference_multiply(d.mats[i], d.vec4s[i]); });
+			run_scalar(runner, "mat4*vec4", d, [&](size_t i) { return d.mats[i] * d.vec4s[i]; });
+			runner.print_speedup("mat4*vec4 vs reference loop", runner.find("mat4*vec4 (reference loop)", type_name<T>(), "scalar"), runner.find("mat4*vec4", type_name<T>(), "scalar"));
+
+			run_scalar(runner, "determinant", d, [&](size_t i) { return noob::determinant(d.mats[i]); });
+			run_scalar(runner, "inverse", d, [&](size_t i) { return noob::inverse(d.mats[i]); });
+			run_scalar(runner, "inverse(mm, results, det)", d, [&](size_t i) { noob::mat4_type<T> r; T det; const bool ok = noob::inverse(d.mats[i], r, det); do_not_optimize(ok); return r; });
+			run_scalar(runner, "inverse_affine", d, [&](size_t i) { return noob::inverse_affine(d.affine[i]); });
+			run_scalar(runner, "inverse_rigid", d, [&](size_t i) { return noob::inverse_rigid(d.rigid[i]); });
+			run_scalar(runner, "inverse_auto", d, [&](size_t i) { return noob::inverse_auto(d.affine[i]); });
+			run_scalar(runner, "is_affine", d, [&](size_t i) { return noob::is_affine(d.affine[i]); });
+			run_scalar(runner, "is_rigid", d, [&](size_t i) { return noob::is_rigid(d.rigid[i]); });
+			run_scalar(runner, "transpose", d, [&](size_t i) { return noob::transpose(d.mats[i]); });
+			run_scalar(runner, "translate", d, [&](size_t i) { return noob::translate(d.mats[i], d.vecs_a[i]); });
+			run_scalar(runner, "rotate", d, [&](size_t i) { return noob::rotate(d.mats[i], d.versors_a[i]); });
+			run_scalar(runner, "rotate_x_deg", d, [&](size_t i) { return noob::rotate_x_deg(d.mats[i], static_cast<float>(d.scalars[i])); });
+			run_scalar(runner, "rotate_y_deg", d, [&](size_t i) { return noob::rotate_y_deg(d.mats[i], static_cast<float>(d.scalars[i])); });
+			run_scalar(runner, "rotate_z_deg", d, [&](size_t i) { return noob::rotate_z_deg(d.mats[i], static_cast<float>(d.scalars[i])); });
+			run_scalar(runner, "scale", d, [&](size_t i) { return noob::scale(d.mats[i], d.vecs_a[i]); });
+			run_scalar(runner, "translation_from_mat4", d, [&](size_t i) { return noob::translation_from_mat4(d.affine[i]); });
+			run_scalar(runner, "scale_from_mat4", d, [&](size_t i) { return noob::scale_from_mat4(d.affine[i]); });
+
+			run_batch(runner, "determinant", d, [&]() { noob::determinant(d.mats_soa, d.scalar_out.data()); });
+			run_batch(runner, "inverse", d, [&]() { do_not_optimize(noob::inverse(d.mats_soa, d.mats_soa_out, d.success.data())); });
+
+			for (const char* fn : { "determinant", "inverse" })
+			{
+				runner.print_speedup(std::string(fn) + " batch vs scalar", runner.find(fn, type_name<T>(), "scalar"), runner.find(fn, type_name<T>(), "batch"));
+			}
+		}
+
+	template <typename T>
+		void bench_transforms(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			const noob::mat4_type<T> m = d.affine[0];
+
+			run_scalar(runner, "transform_points", d, [&](size_t i) { const noob::vec4_type<T> r = m * noob::vec4_type<T>(d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2], 1.0); return noob::vec3_from_vec4(r); });
+			run_batch(runner, "transform_points", d, [&]() { noob::transform_points(m, d.vecs_a.data(), d.vec_out.data(), n); });
+			run_batch(runner, "transform_points(soa)", d, [&]() { noob::transform_points(m, d.soa_a, d.soa_out); });
+			run_batch(runner, "transform_directions", d, [&]() { noob::transform_directions(m, d.vecs_a.data(), d.vec_out.data(), n); });
+			run_batch(runner, "transform_directions(soa)", d, [&]() { noob::transform_directions(m, d.soa_a, d.soa_out); });
+			run_batch(runner, "transform_homogeneous", d, [&]() { noob::transform_homogeneous(m, d.vec4s.data(), d.vec4_out.data(), n); });
+			runner.print_speedup("transform_points batch vs mat4*vec4 loop", runner.find("transform_points", type_name<T>(), "scalar"), runner.find("transform_points", type_name<T>(), "batch"));
+
+			// TRS against the matrices it replaces: composing, and building the matrix from translation, rotation and scale.
+			std::vector<noob::transform_type<T>> trs_a(n), trs_b(n), trs_out(n);
+			std::vector<noob::mat4_type<T>> mat_out(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T s = 0.5 + d.scalars[i] * 0.01;
+				trs_a[i] = noob::transform_type<T>(d.vecs_a[i], d.versors_a[i], noob::vec3_type<T>(s, s, s));
+				trs_b[i] = noob::transform_type<T>(d.vecs_b[i], d.versors_b[i], noob::vec3_type<T>(s, s, s));
+			}
+			run_scalar(runner, "compose(mat4)", d, [&](size_t i) { return d.affine[i] * d.rigid[i]; });
+			run_scalar(runner, "compose(transform)", d, [&](size_t i) { return trs_a[i] * trs_b[i]; });
+			run_batch(runner, "compose(transform)", d, [&]() { noob::compose(trs_a.data(), trs_b.data(), trs_out.data(), n); });
+			run_scalar(runner, "translate(rotate(scale))", d, [&](size_t i) { return noob::translate(noob::rotate(noob::scale(noob::identity_mat4<T>(), trs_a[i].scale), trs_a[i].rotation), trs_a[i].translation); });
+			run_batch(runner, "to_mat4(transform)", d, [&]() { noob::to_mat4(trs_a.data(), mat_out.data(), n); });
+			run_scalar(runner, "decompose", d, [&](size_t i) { return noob::transform_type<T>::from_mat4(d.affine[i]); });
+			run_batch(runner, "decompose", d, [&]() { noob::decompose(d.affine.data(), trs_out.data(), n); });
+			runner.print_speedup("compose transform vs mat4", runner.find("compose(mat4)", type_name<T>(), "scalar"), runner.find("compose(transform)", type_name<T>(), "batch"));
+			runner.print_speedup("to_mat4 vs translate(rotate(scale))", runner.find("translate(rotate(scale))", type_name<T>(), "scalar"), runner.find("to_mat4(transform)", type_name<T>(), "batch"));
+			runner.print_speedup("decompose batch vs scalar", runner.find("decompose", type_name<T>(), "scalar"), runner.find("decompose", type_name<T>(), "batch"));
+		}
+
+	template <typename T>
+		void bench_camera(bench_runner& runner, bench_data<T>& d)
+		{
+			const noob::vec3_type<T> up(0.0, 1.0, 0.0);
+			run_scalar(runner, "look_at", d, [&](size_t i) { return noob::look_at(d.vecs_a[i], d.vecs_b[i], up); });
+			run_scalar(runner, "perspective", d, [&](size_t i) { return noob::perspective<T>(static_cast<float>(30.0 + d.scalars[i] * 0.25), 1.5f, 0.1f, 1000.0f); });
+			run_scalar(runner, "ortho", d, [&](size_t i) { const float w = static_cast<float>(d.scalars[i] + 1.0); return noob::ortho<T>(-w, w, -w, w, 0.1f, 1000.0f); });
+		}
+
+	template <typename T>
+		void bench_geometry(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			run_scalar(runner, "update_bbox_type(bbox, vec3)", d, [&](size_t i) { return noob::update_bbox_type(d.boxes[i], d.vecs_c[i]); });
+			run_scalar(runner, "update_bbox_type(bbox, bbox)", d, [&](size_t i) { return noob::update_bbox_type(d.boxes[i], d.boxes[n - 1 - i]); });
+
+			// Bounds of the whole pool: the incremental pattern, then the batch forms.
+			noob::bbox_soa<T> boxes;
+			boxes.gather(d.boxes);
+			runner.run("bbox of points (update_bbox_type loop)", type_name<T>(), "scalar", n, [&]()
+					{
+						noob::bbox_type<T> b;
+						b.set_empty();
+						for (size_t i = 0; i < n; ++i)
+						{
+							b = noob::update_bbox_type(b, d.vecs_a[i]);
+						}
+						do_not_optimize(b);
+					});
+			run_batch(runner, "compute_bbox", d, [&]() { do_not_optimize(noob::compute_bbox(d.vecs_a)); });
+			run_batch(runner, "compute_bbox(soa)", d, [&]() { do_not_optimize(noob::compute_bbox(d.soa_a)); });
+			run_batch(runner, "merge_bboxes", d, [&]() { do_not_optimize(noob::merge_bboxes(d.boxes.data(), n)); });
+			run_batch(runner, "merge_bboxes(soa)", d, [&]() { do_not_optimize(noob::merge_bboxes(boxes)); });
+			const bench_result* incremental = runner.find("bbox of points (update_bbox_type loop)", type_name<T>(), "scalar");
+			runner.print_speedup("compute_bbox vs update_bbox_type loop", incremental, runner.find("compute_bbox", type_name<T>(), "batch"));
+			runner.print_speedup("compute_bbox(soa) vs update_bbox_type loop", incremental, runner.find("compute_bbox(soa)", type_name<T>(), "batch"));
+		}
+
+	template <typename T>
+		void bench_planes(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			noob::plane<T> p;
+			p.through(d.vecs_a[0], d.vecs_b[0], d.vecs_c[0]);
+			std::vector<noob::plane_side> sides(n);
+			const T eps = 0.01;
+
+			run_scalar(runner, "plane::signed_distance", d, [&](size_t i) { return p.signed_distance(d.vecs_a[i]); });
+			run_scalar(runner, "plane::classify", d, [&](size_t i) { return p.classify(d.vecs_a[i], eps); });
+			run_scalar(runner, "plane::projection", d, [&](size_t i) { return p.projection(d.vecs_a[i]); });
+			run_scalar(runner, "plane::through", d, [&](size_t i) { noob::plane<T> q; q.through(d.vecs_a[i], d.vecs_b[i], d.vecs_c[i]); return q; });
+
+			run_batch(runner, "plane::signed_distance", d, [&]() { noob::signed_distance(p, d.vecs_a.data(), d.scalar_out.data(), n); });
+			run_batch(runner, "plane::signed_distance(soa)", d, [&]() { noob::signed_distance(p, d.soa_a, d.scalar_out.data()); });
+			run_batch(runner, "plane::classify", d, [&]() { noob::classify(p, d.vecs_a.data(), eps, sides.data(), n); });
+			run_batch(runner, "plane::classify(soa)", d, [&]() { noob::classify(p, d.soa_a, eps, sides.data()); });
+			run_batch(runner, "plane::projection", d, [&]() { noob::project(p, d.vecs_a.data(), d.vec_out.data(), n); });
+			run_batch(runner, "plane::projection(soa)", d, [&]() { noob::project(p, d.soa_a, d.soa_out); });
+
+			for (const char* fn : { "plane::signed_distance", "plane::classify", "plane::projection" })
+			{
+				runner.print_speedup(std::string(fn) + " batch vs scalar", runner.find(fn, type_name<T>(), "scalar"), runner.find(fn, type_name<T>(), "batch"));
+			}
+		}
+
+	template <typename T>
+		void bench_culling(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			const noob::mat4_type<T> view_proj = noob::perspective<T>(60.0f, 1.5f, 0.1f, 100.0f) * noob::look_at(noob::vec3_type<T>(0.0, 0.0, 50.0), noob::vec3_type<T>(0.0, 0.0, 0.0), noob::vec3_type<T>(0.0, 1.0, 0.0));
+			noob::frustum<T> f;
+			f.from_mat4(view_proj);
+			noob::bbox_soa<T> boxes;
+			boxes.gather(d.boxes);
+			std::vector<noob::cull_result> results(n);
+			std::vector<uint8_t> hints(n, 0);
+
+			run_scalar(runner, "frustum::from_mat4", d, [&](size_t i) { noob::frustum<T> g; g.from_mat4(d.mats[i]); return g; });
+			run_scalar(runner, "frustum::classify", d, [&](size_t i) { return f.classify(d.boxes[i]); });
+			run_scalar(runner, "frustum::classify(hint)", d, [&](size_t i) { return f.classify(d.boxes[i], hints[i]); });
+			run_batch(runner, "frustum::classify", d, [&]() { do_not_optimize(noob::cull(f, boxes, results.data())); });
+			run_batch(runner, "frustum::classify(hint)", d, [&]() { do_not_optimize(noob::cull(f, boxes, hints.data(), results.data())); });
+			runner.print_speedup("cull batch vs scalar", runner.find("frustum::classify", type_name<T>(), "scalar"), runner.find("frustum::classify", type_name<T>(), "batch"));
+		}
+
+	// A clip of 256 channels with 120 keys each, played forward at 60 Hz: the cursor sampler against a binary search per sample.
+	template <typename T>
+		void bench_tracks(bench_runner& runner)
+		{
+			const size_t channels = 256;
+			const size_t keys = 120;
+			std::mt19937 rng(13);
+			std::uniform_real_distribution<T> unit(-1.0, 1.0);
+			std::vector<noob::vec3_track<T>> translations(channels);
+			std::vector<noob::versor_track<T>> rotations(channels);
+			for (size_t c = 0; c < channels; ++c)
+			{
+				for (size_t k = 0; k < keys; ++k)
+				{
+					const T time = static_cast<T>(k) / 30.0;
+					translations[c].add_key(time, noob::vec3_type<T>(unit(rng), unit(rng), unit(rng)));
+					rotations[c].add_key(time, noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng))));
+				}
+			}
+			const T duration = translations[0].get_end_time();
+			std::vector<uint32_t> translation_cursors(channels, 0), rotation_cursors(channels, 0);
+			std::vector<noob::vec3_type<T>> translation_pose(channels);
+			std::vector<noob::versor_type<T>> rotation_pose(channels);
+			T time = 0.0;
+			auto advance = [&]()
+			{
+				time += static_cast<T>(1.0 / 60.0);
+				if (time > duration) time -= duration;
+			};
+
+			runner.run("track::sample(binary search)", type_name<T>(), "batch", channels * 2, [&]()
+					{
+						advance();
+						for (size_t c = 0; c < channels; ++c)
+						{
+							uint32_t fresh = 0;
+							translation_pose[c] = translations[c].sample(time, fresh);
+							fresh = 0;
+							rotation_pose[c] = rotations[c].sample(time, fresh);
+						}
+						do_not_optimize(translation_pose[0]);
+					});
+			runner.run("track::sample(cursor)", type_name<T>(), "batch", channels * 2, [&]()
+					{
+						advance();
+						noob::sample(translations.data(), channels, time, translation_cursors.data(), translation_pose.data());
+						noob::sample(rotations.data(), channels, time, rotation_cursors.data(), rotation_pose.data());
+						do_not_optimize(translation_pose[0]);
+					});
+			runner.print_speedup("cursor vs binary search", runner.find("track::sample(binary search)", type_name<T>(), "batch"), runner.find("track::sample(cursor)", type_name<T>(), "batch"));
+			// Key lookup alone, without the interpolation (slerp dominates the figures above).
+			runner.run("track::seek(binary search)", type_name<T>(), "batch", channels, [&]()
+					{
+						advance();
+						uint32_t sum = 0;
+						for (size_t c = 0; c < channels; ++c)
+						{
+							uint32_t fresh = 0;
+							sum += translations[c].seek(time, fresh);
+						}
+						do_not_optimize(sum);
+					});
+			runner.run("track::seek(cursor)", type_name<T>(), "batch", channels, [&]()
+					{
+						advance();
+						uint32_t sum = 0;
+						for (size_t c = 0; c < channels; ++c)
+						{
+							sum += translations[c].seek(time, translation_cursors[c]);
+						}
+						do_not_optimize(sum);
+					});
+			runner.print_speedup("seek cursor vs binary search", runner.find("track::seek(binary search)", type_name<T>(), "batch"), runner.find("track::seek(cursor)", type_name<T>(), "batch"));
+		}
+
+	// 64K vertices with four influences over a 64-bone palette. The scalar case is the old path: transform the vertex by each
+	// influence's mat4 and blend the results.
+	template <typename T>
+		void bench_skinning(bench_runner& runner)
+		{
+			const size_t vertices = 1 << 16;
+			const size_t bones = 64;
+			std::mt19937 rng(17);
+			std::uniform_real_distribution<T> unit(-1.0, 1.0);
+			std::vector<noob::mat4_type<T>> mats(bones);
+			std::vector<noob::dual_quat<T>> dqs(bones);
+			for (size_t b = 0; b < bones; ++b)
+			{
+				const noob::versor_type<T> q = noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng)));
+				const noob::vec3_type<T> t(unit(rng), unit(rng), unit(rng));
+				mats[b] = noob::translate(noob::versor_to_mat4(q), t);
+				dqs[b] = noob::dual_quat<T>::from_mat4(mats[b]);
+			}
+			noob::vec3_soa<T> positions, normals, out_positions, out_normals;
+			std::vector<noob::vec4_type<T>> aos_positions(vertices), aos_out(vertices);
+			noob::skin_influences<T> skin;
+			for (size_t i = 0; i < vertices; ++i)
+			{
+				const noob::vec3_type<T> p(unit(rng), unit(rng), unit(rng));
+				positions.push_back(p);
+				normals.push_back(noob::normalize(noob::vec3_type<T>(unit(rng), unit(rng), unit(rng))));
+				aos_positions[i] = noob::vec4_type<T>(p[0], p[1], p[2], 1.0);
+				std::array<T, 4> w = { std::fabs(unit(rng)), std::fabs(unit(rng)), std::fabs(unit(rng)), std::fabs(unit(rng)) };
+				const T sum = w[0] + w[1] + w[2] + w[3];
+				for (T& x : w) x /= sum;
+				const uint16_t first = static_cast<uint16_t>(rng() % bones);
+				skin.push_back({ first, static_cast<uint16_t>((first + 1) % bones), static_cast<uint16_t>((first + 2) % bones), static_cast<uint16_t>((first + 3) % bones) }, w);
+			}
+
+			runner.run("skin(mat4 per influence)", type_name<T>(), "scalar", vertices, [&]()
+					{
+						for (size_t i = 0; i < vertices; ++i)
+						{
+							noob::vec4_type<T> acc(0.0, 0.0, 0.0, 0.0);
+							for (uint32_t k = 0; k < 4; ++k)
+							{
+								const noob::vec4_type<T> v = mats[skin.bone[k][i]] * aos_positions[i];
+								const T w = skin.weight[k][i];
+								acc = noob::vec4_type<T>(acc[0] + v[0] * w, acc[1] + v[1] * w, acc[2] + v[2] * w, 1.0);
+							}
+							aos_out[i] = acc;
+						}
+						do_not_optimize(aos_out[0]);
+					});
+			runner.run("skin_linear", type_name<T>(), "batch", vertices, [&]() { noob::skin_linear(mats.data(), skin, positions, out_positions); });
+			runner.run("skin_linear(normals)", type_name<T>(), "batch", vertices, [&]() { noob::skin_linear(mats.data(), skin, positions, normals, out_positions, out_normals); });
+			runner.run("skin_dual_quat", type_name<T>(), "batch", vertices, [&]() { noob::skin_dual_quat(dqs.data(), skin, positions, out_positions); });
+			runner.run("skin_dual_quat(normals)", type_name<T>(), "batch", vertices, [&]() { noob::skin_dual_quat(dqs.data(), skin, positions, normals, out_positions, out_normals); });
+			runner.print_speedup("skin_linear vs mat4 per influence", runner.find("skin(mat4 per influence)", type_name<T>(), "scalar"), runner.find("skin_linear", type_name<T>(), "batch"));
+			runner.print_speedup("skin_dual_quat vs mat4 per influence", runner.find("skin(mat4 per influence)", type_name<T>(), "scalar"), runner.find("skin_dual_quat", type_name<T>(), "batch"));
+		}
+
+	// A 100K-node scene graph (random parents, 64 roots) propagated once per op: the usual recursion over heap-allocated nodes
+	// against the level-order hierarchy, with every local changed and with 1% of them changed.
+	template <typename T>
+		void bench_transform_hierarchy(bench_runner& runner)
+		{
+			const size_t nodes = 100000;
+			const size_t roots = 64;
+			const size_t moved = nodes / 100;
+			std::mt19937 rng(19);
+			std::uniform_real_distribution<T> unit(-1.0, 1.0);
+			struct scene_node
+			{
+				noob::mat4_type<T> local, world;
+				std::vector<scene_node*> children;
+			};
+			std::vector<std::unique_ptr<scene_node>> graph(nodes);
+			std::vector<noob::mat4_type<T>> locals(nodes);
+			noob::transform_hierarchy<T> hierarchy;
+			hierarchy.reserve(nodes);
+			for (size_t i = 0; i < nodes; ++i)
+			{
+				locals[i] = noob::translate(noob::versor_to_mat4(noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng)))), noob::vec3_type<T>(unit(rng), unit(rng), unit(rng)));
+				graph[i].reset(new scene_node);
+				graph[i]->local = locals[i];
+				// Parents are biased towards recent nodes, which gives a few dozen levels.
+				const uint32_t parent = (i < roots) ? noob::transform_hierarchy<T>::null_node : static_cast<uint32_t>(i - 1 - rng() % std::min(i, static_cast<size_t>(2048)));
+				if (parent != noob::transform_hierarchy<T>::null_node) graph[parent]->children.push_back(graph[i].get());
+				hierarchy.add(parent, locals[i]);
+			}
+			hierarchy.update();
+
+			std::function<void(scene_node*, const noob::mat4_type<T>&)> propagate = [&propagate](scene_node* n, const noob::mat4_type<T>& parent_world)
+			{
+				n->world = parent_world * n->local;
+				for (scene_node* c : n->children)
+				{
+					propagate(c, n->world);
+				}
+			};
+			const noob::mat4_type<T> identity = noob::identity_mat4<T>();
+			runner.run("transform_hierarchy(recursive)", type_name<T>(), "scalar", nodes, [&]()
+					{
+						for (size_t r = 0; r < roots; ++r)
+						{
+							propagate(graph[r].get(), identity);
+						}
+						do_not_optimize(graph[nodes - 1]->world);
+					});
+			runner.run("transform_hierarchy::update(all)", type_name<T>(), "batch", nodes, [&]()
+					{
+						for (size_t i = 0; i < nodes; ++i)
+						{
+							hierarchy.set_local(static_cast<uint32_t>(i), locals[i]);
+						}
+						hierarchy.update();
+						do_not_optimize(hierarchy.get_worlds()[0]);
+					});
+			size_t next = 0;
+			runner.run("transform_hierarchy::update(1%)", type_name<T>(), "batch", nodes, [&]()
+					{
+						for (size_t k = 0; k < moved; ++k)
+						{
+							next = (next + 7919) % nodes;
+							hierarchy.set_local(static_cast<uint32_t>(next), locals[next]);
+						}
+						hierarchy.update();
+						do_not_optimize(hierarchy.get_worlds()[0]);
+					});
+			runner.print_speedup("update(all) vs recursive", runner.find("transform_hierarchy(recursive)", type_name<T>(), "scalar"), runner.find("transform_hierarchy::update(all)", type_name<T>(), "batch"));
+			runner.print_speedup("update(1%) vs recursive", runner.find("transform_hierarchy(recursive)", type_name<T>(), "scalar"), runner.find("transform_hierarchy::update(1%)", type_name<T>(), "batch"));
+		}
+
+	// Strong scaling of the parallel batch wrappers: the same million-element passes on 1, 2, 4, ... threads up to the hardware
+	// concurrency, each against the single-threaded kernel. Results are identical at every thread count, so only time changes.
+	template <typename T>
+		void bench_parallel(bench_runner& runner)
+		{
+			const size_t n = 1 << 20;
+			std::mt19937 rng(23);
+			std::uniform_real_distribution<T> unit(-1.0, 1.0);
+			std::vector<noob::vec3_type<T>> points(n), out(n);
+			noob::vec3_soa<T> soa, soa_out;
+			for (size_t i = 0; i < n; ++i)
+			{
+				points[i] = noob::vec3_type<T>(unit(rng), unit(rng), unit(rng));
+				soa.push_back(points[i]);
+			}
+			const size_t matrices = n / 4;
+			std::vector<noob::mat4_type<T>> mats(matrices), inverted(matrices);
+			for (size_t i = 0; i < matrices; ++i)
+			{
+				const noob::versor_type<T> q = noob::normalize(noob::versor_type<T>(unit(rng), unit(rng), unit(rng), unit(rng)));
+				mats[i] = noob::translate(noob::scale(noob::versor_to_mat4(q), noob::vec3_type<T>(2.0, 2.0, 2.0)), points[i]);
+			}
+			const noob::mat4_type<T> m = mats[0];
+			noob::bbox_type<T> bounds;
+			bounds.min = noob::vec3_type<T>(-1.0, -1.0, -1.0);
+			bounds.max = noob::vec3_type<T>(1.0, 1.0, 1.0);
+			std::vector<uint64_t> codes, keys(n), scratch_keys(n);
+			std::vector<uint32_t> order(n), scratch_values(n);
+			noob::morton_encode63(soa, bounds, codes);
+			const auto reset_keys = [&]()
+			{
+				keys = codes;
+				for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+			};
+
+			noob::set_thread_count(0);
+			const uint32_t max_threads = noob::get_thread_count();
+			std::vector<uint32_t> counts;
+			for (uint32_t t = 1; t < max_threads; t *= 2)
+			{
+				counts.push_back(t);
+			}
+			counts.push_back(max_threads);
+
+			runner.run("parallel baseline transform_points(soa)", type_name<T>(), "batch", n, [&]() { noob::transform_points(m, soa, soa_out); do_not_optimize(soa_out.x[0]); });
+			runner.run("parallel baseline transform_points", type_name<T>(), "batch", n, [&]() { noob::transform_points(m, points.data(), out.data(), n); do_not_optimize(out[0]); });
+			runner.run("parallel baseline normalize(soa)", type_name<T>(), "batch", n, [&]() { noob::normalize(soa, soa_out); do_not_optimize(soa_out.x[0]); });
+			runner.run("parallel baseline compute_bbox(soa)", type_name<T>(), "batch", n, [&]() { do_not_optimize(noob::compute_bbox(soa)); });
+			runner.run("parallel baseline inverse_affine", type_name<T>(), "batch", matrices, [&]()
+					{
+						for (size_t i = 0; i < matrices; ++i)
+						{
+							inverted[i] = noob::inverse_affine(mats[i]);
+						}
+						do_not_optimize(inverted[0]);
+					});
+			runner.run("parallel baseline radix_sort(morton63)", type_name<T>(), "batch", n, [&]() { reset_keys(); noob::radix_sort(keys.data(), order.data(), n, scratch_keys.data(), scratch_values.data()); do_not_optimize(order[0]); });
+			runner.run("parallel baseline permute(soa)", type_name<T>(), "batch", n, [&]() { noob::permute(soa, order.data(), soa_out); do_not_optimize(soa_out.x[0]); });
+			for (uint32_t t : counts)
+			{
+				noob::set_thread_count(t);
+				const std::string threads = " x" + std::to_string(t);
+				runner.run("parallel_transform_points(soa)" + threads, type_name<T>(), "batch", n, [&]() { noob::parallel_transform_points(m, soa, soa_out); do_not_optimize(soa_out.x[0]); });
+				runner.run("parallel_transform_points" + threads, type_name<T>(), "batch", n, [&]() { noob::parallel_transform_points(m, points.data(), out.data(), n); do_not_optimize(out[0]); });
+				runner.run("parallel_normalize(soa)" + threads, type_name<T>(), "batch", n, [&]() { noob::parallel_normalize(soa, soa_out); do_not_optimize(soa_out.x[0]); });
+				runner.run("parallel_compute_bbox(soa)" + threads, type_name<T>(), "batch", n, [&]() { do_not_optimize(noob::parallel_compute_bbox(soa)); });
+				runner.run("parallel_inverse_affine" + threads, type_name<T>(), "batch", matrices, [&]() { noob::parallel_inverse_affine(mats.data(), inverted.data(), matrices); do_not_optimize(inverted[0]); });
+				runner.run("parallel_radix_sort(morton63)" + threads, type_name<T>(), "batch", n, [&]() { reset_keys(); noob::parallel_radix_sort(keys.data(), order.data(), n, scratch_keys.data(), scratch_values.data()); do_not_optimize(order[0]); });
+				runner.run("parallel_permute(soa)" + threads, type_name<T>(), "batch", n, [&]() { noob::parallel_permute(soa, order.data(), soa_out); do_not_optimize(soa_out.x[0]); });
+				runner.print_speedup("parallel_transform_points(soa)" + threads + " vs single-threaded", runner.find("parallel baseline transform_points(soa)", type_name<T>(), "batch"), runner.find("parallel_transform_points(soa)" + threads, type_name<T>(), "batch"));
+				runner.print_speedup("parallel_normalize(soa)" + threads + " vs single-threaded", runner.find("parallel baseline normalize(soa)", type_name<T>(), "batch"), runner.find("parallel_normalize(soa)" + threads, type_name<T>(), "batch"));
+				runner.print_speedup("parallel_compute_bbox(soa)" + threads + " vs single-threaded", runner.find("parallel baseline compute_bbox(soa)", type_name<T>(), "batch"), runner.find("parallel_compute_bbox(soa)" + threads, type_name<T>(), "batch"));
+				runner.print_speedup("parallel_inverse_affine" + threads + " vs single-threaded", runner.find("parallel baseline inverse_affine", type_name<T>(), "batch"), runner.find("parallel_inverse_affine" + threads, type_name<T>(), "batch"));
+				runner.print_speedup("parallel_radix_sort(morton63)" + threads + " vs single-threaded", runner.find("parallel baseline radix_sort(morton63)", type_name<T>(), "batch"), runner.find("parallel_radix_sort(morton63)" + threads, type_name<T>(), "batch"));
+			}
+			noob::set_thread_count(0);
+		}
+
+	// Math policies: the raw functions as loops the compiler may vectorize, then the functions that take a policy, one call at a time.
+	template <typename T>
+		void bench_fast_math(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			const T* x = d.scalars.data();
+			const noob::vec3_type<T>* v = d.vecs_a.data();
+			T* out = d.scalar_out.data();
+			const char* fns[] = { "rsqrt", "sincos", "atan2", "acos" };
+
+			// Captured by value, so the loops can vectorize.
+			run_batch(runner, "rsqrt (precise)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::precise_math::rsqrt(x[i] + static_cast<T>(1.0)); });
+			run_batch(runner, "rsqrt (fast)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::fast_math::rsqrt(x[i] + static_cast<T>(1.0)); });
+			run_batch(runner, "sincos (precise)", d, [=]() { for (size_t i = 0; i < n; ++i) { T s, c; noob::precise_math::sincos(x[i], s, c); out[i] = s + c; } });
+			run_batch(runner, "sincos (fast)", d, [=]() { for (size_t i = 0; i < n; ++i) { T s, c; noob::fast_math::sincos(x[i], s, c); out[i] = s + c; } });
+			run_batch(runner, "atan2 (precise)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::precise_math::atan2(v[i][2], v[i][0]); });
+			run_batch(runner, "atan2 (fast)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::fast_math::atan2(v[i][2], v[i][0]); });
+			// Angles in [0, 360) map onto [-1, 1) for acos.
+			run_batch(runner, "acos (precise)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::precise_math::acos(x[i] / static_cast<T>(180.0) - static_cast<T>(1.0)); });
+			run_batch(runner, "acos (fast)", d, [=]() { for (size_t i = 0; i < n; ++i) out[i] = noob::fast_math::acos(x[i] / static_cast<T>(180.0) - static_cast<T>(1.0)); });
+			for (const char* fn : fns)
+			{
+				runner.print_speedup(std::string(fn) + " fast vs precise", runner.find(std::string(fn) + " (precise)", type_name<T>(), "batch"), runner.find(std::string(fn) + " (fast)", type_name<T>(), "batch"));
+			}
+
+			run_scalar(runner, "normalize(vec3) (fast)", d, [&](size_t i) { return noob::normalize(d.vecs_a[i], noob::fast_math()); });
+			run_scalar(runner, "normalize(versor) (fast)", d, [&](size_t i) { return noob::normalize(d.versors_a[i], noob::fast_math()); });
+			run_scalar(runner, "direction_to_heading (fast)", d, [&](size_t i) { return noob::direction_to_heading(d.vecs_a[i], noob::fast_math()); });
+			run_scalar(runner, "heading_to_direction (fast)", d, [&](size_t i) { return noob::heading_to_direction<T>(d.scalars[i], noob::fast_math()); });
+			run_scalar(runner, "slerp (fast)", d, [&](size_t i) { return noob::slerp(d.versors_a[i], d.versors_b[i], 0.3f, noob::fast_math()); });
+			run_scalar(runner, "versor_from_axis_rad (fast)", d, [&](size_t i) { return noob::versor_from_axis_rad<T>(static_cast<float>(d.scalars[i]), d.vecs_a[i][0], d.vecs_a[i][1], d.vecs_a[i][2], noob::fast_math()); });
+			run_scalar(runner, "rotate_y_deg (fast)", d, [&](size_t i) { return noob::rotate_y_deg(d.mats[i], static_cast<float>(d.scalars[i]), noob::fast_math()); });
+			const char* policy_fns[] = { "normalize(vec3)", "direction_to_heading", "heading_to_direction", "slerp", "versor_from_axis_rad", "rotate_y_deg" };
+			for (const char* fn : policy_fns)
+			{
+				runner.print_speedup(std::string(fn) + " fast vs precise", runner.find(fn, type_name<T>(), "scalar"), runner.find(std::string(fn) + " (fast)", type_name<T>(), "scalar"));
+			}
+		}
+
+	// Morton codes for the pool's points, sorting them into Z-order and permuting the points to match.
+	template <typename T>
+		void bench_morton(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			const noob::bbox_type<T> bounds = noob::compute_bbox(d.vecs_a);
+			std::vector<uint32_t> codes30(n), order(n), scratch_values(n);
+			std::vector<uint64_t> codes63(n), keys63(n), scratch63(n);
+			std::vector<uint32_t> keys30(n), scratch30(n);
+
+			run_scalar(runner, "morton_encode30", d, [&](size_t i) { return noob::morton_encode30(d.vecs_a[i], bounds); });
+			run_scalar(runner, "morton_encode63", d, [&](size_t i) { return noob::morton_encode63(d.vecs_a[i], bounds); });
+			run_scalar(runner, "morton_decode30", d, [&](size_t i) { return noob::morton_decode30(static_cast<uint32_t>(i * 2654435761u) & 0x3FFFFFFFu, bounds); });
+			run_batch(runner, "morton_encode30", d, [&]() { noob::morton_encode30(d.vecs_a.data(), bounds, codes30.data(), n); });
+			run_batch(runner, "morton_encode63", d, [&]() { noob::morton_encode63(d.vecs_a.data(), bounds, codes63.data(), n); });
+			run_batch(runner, "morton_encode30(soa)", d, [&]() { noob::morton_encode30(d.soa_a, bounds, codes30.data(), 0, n); });
+			runner.print_speedup("morton_encode30 batch vs scalar", runner.find("morton_encode30", type_name<T>(), "scalar"), runner.find("morton_encode30", type_name<T>(), "batch"));
+			runner.print_speedup("morton_encode63 batch vs scalar", runner.find("morton_encode63", type_name<T>(), "scalar"), runner.find("morton_encode63", type_name<T>(), "batch"));
+
+			run_batch(runner, "radix_sort(morton30)", d, [&]()
+					{
+						keys30 = codes30;
+						for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+						noob::radix_sort(keys30.data(), order.data(), n, scratch30.data(), scratch_values.data());
+					});
+			run_batch(runner, "radix_sort(morton63)", d, [&]()
+					{
+						keys63 = codes63;
+						for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+						noob::radix_sort(keys63.data(), order.data(), n, scratch63.data(), scratch_values.data());
+					});
+			run_batch(runner, "permute(vec3_soa)", d, [&]() { noob::permute(d.soa_a, order.data(), d.soa_out); });
+		}
+
+	// Packed storage (float only): encode and decode throughput per element, against a memcpy of the unpacked stream.
+	template <typename T>
+		void bench_packed(bench_runner&, bench_data<T>&) {}
+
+	void bench_packed(bench_runner& runner, bench_data<float>& d)
+	{
+		const size_t n = d.count;
+		std::vector<noob::vec3_half> halves(n);
+		std::vector<noob::vec4_half> halves4(n);
+		std::vector<noob::vec3_quantized> quantized(n);
+		std::vector<noob::versor_packed48> versors48(n);
+		std::vector<noob::versor_packed32> versors32(n);
+		std::vector<noob::versor_type<float>> versors_out(n);
+		const noob::bbox_type<float> bounds = noob::compute_bbox(d.vecs_a);
+
+		run_batch(runner, "memcpy(vec3)", d, [&]() { std::memcpy(d.vec_out.data(), d.vecs_a.data(), n * sizeof(noob::vec3_type<float>)); });
+		run_batch(runner, "pack(vec3_half)", d, [&]() { noob::pack(d.vecs_a.data(), halves.data(), n); });
+		run_batch(runner, "unpack(vec3_half)", d, [&]() { noob::unpack(halves.data(), d.vec_out.data(), n); });
+		run_batch(runner, "pack(vec4_half)", d, [&]() { noob::pack(d.vec4s.data(), halves4.data(), n); });
+		run_batch(runner, "unpack(vec4_half)", d, [&]() { noob::unpack(halves4.data(), d.vec4_out.data(), n); });
+		run_batch(runner, "pack(vec3_quantized)", d, [&]() { noob::pack(d.vecs_a.data(), bounds, quantized.data(), n); });
+		run_batch(runner, "unpack(vec3_quantized)", d, [&]() { noob::unpack(quantized.data(), bounds, d.vec_out.data(), n); });
+		run_batch(runner, "memcpy(versor)", d, [&]() { std::memcpy(versors_out.data(), d.versors_a.data(), n * sizeof(noob::versor_type<float>)); });
+		run_batch(runner, "pack(versor_packed48)", d, [&]() { noob::pack(d.versors_a.data(), versors48.data(), n); });
+		run_batch(runner, "unpack(versor_packed48)", d, [&]() { noob::unpack(versors48.data(), versors_out.data(), n); });
+		run_batch(runner, "pack(versor_packed32)", d, [&]() { noob::pack(d.versors_a.data(), versors32.data(), n); });
+		run_batch(runner, "unpack(versor_packed32)", d, [&]() { noob::unpack(versors32.data(), versors_out.data(), n); });
+		runner.print_speedup("unpack(vec3_half) vs memcpy", runner.find("memcpy(vec3)", "float", "batch"), runner.find("unpack(vec3_half)", "float", "batch"));
+		runner.print_speedup("unpack(vec4_half) vs memcpy", runner.find("memcpy(versor)", "float", "batch"), runner.find("unpack(vec4_half)", "float", "batch"));
+		runner.print_speedup("unpack(vec3_quantized) vs memcpy", runner.find("memcpy(vec3)", "float", "batch"), runner.find("unpack(vec3_quantized)", "float", "batch"));
+		runner.print_speedup("unpack(versor_packed48) vs memcpy", runner.find("memcpy(versor)", "float", "batch"), runner.find("unpack(versor_packed48)", "float", "batch"));
+		runner.print_speedup("unpack(versor_packed32) vs memcpy", runner.find("memcpy(versor)", "float", "batch"), runner.find("unpack(versor_packed32)", "float", "batch"));
+	}
+
+	// Every form reports ray-primitive tests per op: one ray at a time, one ray against an SoA batch, and 8-ray packets against one primitive.
+	template <typename T>
+		void bench_ray_kernels(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			const size_t width = 8;
+			std::vector<std::array<noob::vec3_type<T>, 3>> tris(n);
+			noob::triangle_soa<T> tri_soa;
+			noob::bbox_soa<T> box_soa;
+			box_soa.gather(d.boxes);
+			for (size_t i = 0; i < n; ++i)
+			{
+				tris[i] = { d.vecs_a[i], d.vecs_b[i], d.vecs_c[i] };
+				tri_soa.push_back(tris[i]);
+			}
+			const noob::ray_type<T> r(noob::vec3_type<T>(0.0, 0.0, -200.0), noob::normalize(noob::vec3_type<T>(0.1, 0.05, 1.0)));
+			const noob::vec3_type<T> inv_dir(1.0 / r.direction[0], 1.0 / r.direction[1], 1.0 / r.direction[2]);
+			const T t_max = 1000.0;
+			noob::ray_packet<T, width> packet;
+			for (size_t i = 0; i < width; ++i)
+			{
+				packet.set(i, noob::ray_type<T>(r.origin, noob::normalize(d.vecs_a[i])), t_max);
+			}
+			std::vector<uint8_t> hits(n);
+			std::vector<T> t(n), u(n), v(n);
+			alignas(64) T pt[width], pu[width], pv[width];
+
+			run_scalar(runner, "intersects(ray, bbox)", d, [&](size_t i) { T te; return noob::intersects(r, inv_dir, d.boxes[i], t_max, te) ? te : static_cast<T>(-1.0); });
+			run_batch(runner, "intersects(ray, bbox)", d, [&]() { do_not_optimize(noob::intersects(r, inv_dir, box_soa, t_max, hits.data(), t.data())); });
+			runner.run("intersects(ray, bbox)", type_name<T>(), "packet8", (n / width) * width, [&]()
+					{
+						uint32_t m = 0;
+						for (size_t i = 0; i < n / width; ++i) m += noob::intersects(packet, d.boxes[i], pt);
+						do_not_optimize(m);
+					});
+			run_scalar(runner, "intersects(ray, triangle)", d, [&](size_t i) { T tt, uu, vv; return noob::intersects(r, tris[i], t_max, tt, uu, vv) ? tt : static_cast<T>(-1.0); });
+			run_batch(runner, "intersects(ray, triangle)", d, [&]() { do_not_optimize(noob::intersects(r, tri_soa, t_max, hits.data(), t.data(), u.data(), v.data())); });
+			runner.run("intersects(ray, triangle)", type_name<T>(), "packet8", (n / width) * width, [&]()
+					{
+						uint32_t m = 0;
+						for (size_t i = 0; i < n / width; ++i) m += noob::intersects(packet, tri_soa, i, pt, pu, pv);
+						do_not_optimize(m);
+					});
+			runner.print_speedup("ray/bbox batch vs scalar", runner.find("intersects(ray, bbox)", type_name<T>(), "scalar"), runner.find("intersects(ray, bbox)", type_name<T>(), "batch"));
+			runner.print_speedup("ray/bbox packet vs scalar", runner.find("intersects(ray, bbox)", type_name<T>(), "scalar"), runner.find("intersects(ray, bbox)", type_name<T>(), "packet8"));
+			runner.print_speedup("ray/triangle batch vs scalar", runner.find("intersects(ray, triangle)", type_name<T>(), "scalar"), runner.find("intersects(ray, triangle)", type_name<T>(), "batch"));
+			runner.print_speedup("ray/triangle packet vs scalar", runner.find("intersects(ray, triangle)", type_name<T>(), "scalar"), runner.find("intersects(ray, triangle)", type_name<T>(), "packet8"));
+		}
+
+	// Build and query costs on a scene of scene_size boxes scattered through a cube, sized so that queries touch a few dozen of them.
+	template <typename T>
+		void bench_bvh(bench_runner& runner, bench_data<T>& d, size_t scene_size)
+		{
+			const std::string build_name = "bvh::build(" + std::to_string(scene_size) + ")";
+			if (!runner.filter.empty() && std::string("bvh::raycast(closest) bvh::overlap bvh::nearest ").find(runner.filter) == std::string::npos && build_name.find(runner.filter) == std::string::npos && std::string(type_name<T>()) != runner.filter) return;
+
+			std::mt19937 rng(7);
+			const T extent = static_cast<T>(std::cbrt(static_cast<double>(scene_size)) * 4.0);
+			std::uniform_real_distribution<T> coord(-extent, extent);
+			std::uniform_real_distribution<T> dims(0.1, 4.0);
+			std::vector<noob::bbox_type<T>> scene(scene_size);
+			for (noob::bbox_type<T>& b : scene)
+			{
+				b.min = noob::vec3_type<T>(coord(rng), coord(rng), coord(rng));
+				b.max = b.min + noob::vec3_type<T>(dims(rng), dims(rng), dims(rng));
+			}
+
+			noob::bvh<T> tree;
+			runner.run(build_name, type_name<T>(), "batch", scene_size, [&]() { tree.build(scene); });
+			// Filtered out above, but the queries still need a tree.
+			if (tree.empty()) tree.build(scene);
+			if (const bench_result* r = runner.find(build_name, type_name<T>(), "batch"))
+			{
+				if (runner.format == output_format::TABLE) std::printf("  -> %.1f ms per build, %zu nodes\n", r->ns_per_op * static_cast<double>(scene_size) * 1e-6, tree.node_count());
+			}
+
+			const size_t n = d.count;
+			std::vector<noob::ray_type<T>> rays(n);
+			std::vector<noob::bbox_type<T>> probes(n);
+			std::vector<noob::vec3_type<T>> points(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				const noob::vec3_type<T> p(coord(rng), coord(rng), coord(rng));
+				rays[i] = noob::ray_type<T>(p, noob::normalize(d.vecs_a[i]));
+				probes[i].min = p;
+				probes[i].max = p + noob::vec3_type<T>(8.0, 8.0, 8.0);
+				points[i] = p;
+			}
+			std::vector<uint32_t> found;
+			found.reserve(4096);
+
+			run_scalar(runner, "bvh::raycast(closest)", d, [&](size_t i) { uint32_t prim = 0; T t = 0.0; const bool hit = tree.raycast(rays[i], extent * 4, prim, t); return hit ? prim : 0u; });
+			run_scalar(runner, "bvh::overlap", d, [&](size_t i) { found.clear(); return tree.overlap(probes[i], found); });
+			run_scalar(runner, "bvh::nearest", d, [&](size_t i) { uint32_t prim = 0; T dist_sq = 0.0; tree.nearest(points[i], prim, dist_sq); return prim; });
+		}
+
+	// Objects oscillate by more than the fat margin, so every move restructures (update) or refits (set_box) the tree.
+	template <typename T>
+		void bench_aabb_tree(bench_runner& runner, bench_data<T>& d)
+		{
+			const size_t n = d.count;
+			// d.boxes span the whole input range; a broadphase sees much smaller objects.
+			std::vector<noob::bbox_type<T>> boxes(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				boxes[i].min = d.vecs_a[i];
+				boxes[i].max = d.vecs_a[i] + noob::vec3_type<T>(std::fabs(d.vecs_c[i][0]), std::fabs(d.vecs_c[i][1]), std::fabs(d.vecs_c[i][2])) * static_cast<T>(0.1);
+			}
+
+			noob::aabb_tree<T> tree(0.1);
+			std::vector<uint32_t> handles(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				handles[i] = tree.insert(boxes[i], static_cast<uint32_t>(i));
+			}
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			pairs.reserve(n * 4);
+			uint32_t tick = 0;
+
+			auto moved_box = [&](size_t i)
+			{
+				const T offset = (tick & 1) ? 1.0 : -1.0;
+				noob::bbox_type<T> b = boxes[i];
+				b.min = b.min + offset;
+				b.max = b.max + offset;
+				return b;
+			};
+
+			run_scalar(runner, "aabb_tree::insert+remove", d, [&](size_t i) { const uint32_t h = tree.insert(boxes[i]); tree.remove(h); return h; });
+			run_scalar(runner, "aabb_tree::update", d, [&](size_t i) { if (i == 0) ++tick; return tree.update(handles[i], moved_box(i)); });
+			run_batch(runner, "aabb_tree::set_box+refit", d, [&]()
+					{
+						++tick;
+						for (size_t i = 0; i < n; ++i)
+						{
+							tree.set_box(handles[i], moved_box(i));
+						}
+						tree.refit();
+					});
+			run_scalar(runner, "aabb_tree::overlap", d, [&](size_t i) { uint32_t hits = 0; tree.overlap(boxes[n - 1 - i], [&hits](uint32_t) { ++hits; }); return hits; });
+			run_batch(runner, "aabb_tree::find_pairs", d, [&]() { pairs.clear(); tree.find_pairs(pairs); });
+			run_batch(runner, "aabb_tree::find_moved_pairs", d, [&]()
+					{
+						++tick;
+						for (size_t i = 0; i < n; i += 8)
+						{
+							tree.update(handles[i], moved_box(i));
+						}
+						pairs.clear();
+						tree.find_moved_pairs(pairs);
+					});
+		}
+
+	// 50k bodies spread along a corridor, 5% of them nudged each frame: the coherent case sweep-and-prune is built for.
+	template <typename T>
+		void bench_sweep_and_prune(bench_runner& runner)
+		{
+			const size_t bodies = 50000;
+			std::mt19937 rng(11);
+			std::uniform_real_distribution<T> along(-2000.0, 2000.0), across(-100.0, 100.0), dims(0.5, 4.0), nudge(-0.05, 0.05);
+			std::vector<noob::bbox_type<T>> boxes(bodies);
+			for (noob::bbox_type<T>& b : boxes)
+			{
+				b.min = noob::vec3_type<T>(along(rng), across(rng), across(rng));
+				b.max = b.min + noob::vec3_type<T>(dims(rng), dims(rng), dims(rng));
+			}
+			std::vector<std::pair<uint32_t, uint32_t>> pairs(bodies * 4);
+			noob::sweep_and_prune<T> sap;
+			sap.sort(boxes.data(), bodies);
+			uint32_t frame = 0;
+
+			auto move_some = [&]()
+			{
+				const T dir = (++frame & 1) ? 1.0 : -1.0;
+				for (size_t i = frame % 20; i < bodies; i += 20)
+				{
+					const noob::vec3_type<T> d(nudge(rng) + dir * static_cast<T>(0.05), nudge(rng), nudge(rng));
+					boxes[i].min = boxes[i].min + d;
+					boxes[i].max = boxes[i].max + d;
+				}
+			};
+
+			std::vector<T> keys(bodies);
+			std::vector<uint32_t> order(bodies);
+			runner.run("sweep_and_prune::sort(std::sort)", type_name<T>(), "batch", bodies, [&]()
+					{
+						move_some();
+						for (size_t i = 0; i < bodies; ++i)
+						{
+							order[i] = static_cast<uint32_t>(i);
+						}
+						std::sort(order.begin(), order.end(), [&boxes](uint32_t a, uint32_t b) { return boxes[a].min[0] < boxes[b].min[0]; });
+						do_not_optimize(order[0]);
+					});
+			runner.run("sweep_and_prune::sort(full)", type_name<T>(), "batch", bodies, [&]() { move_some(); sap.reset(); sap.sort(boxes.data(), bodies); });
+			runner.run("sweep_and_prune::sort(incremental)", type_name<T>(), "batch", bodies, [&]() { move_some(); sap.sort(boxes.data(), bodies); });
+			runner.run("sweep_and_prune::find_pairs", type_name<T>(), "batch", bodies, [&]() { do_not_optimize(sap.find_pairs(pairs.data(), pairs.size())); });
+			runner.run("sweep_and_prune::update", type_name<T>(), "batch", bodies, [&]() { move_some(); do_not_optimize(sap.update(boxes.data(), bodies, pairs.data(), pairs.size())); });
+			runner.print_speedup("incremental vs full radix sort", runner.find("sweep_and_prune::sort(full)", type_name<T>(), "batch"), runner.find("sweep_and_prune::sort(incremental)", type_name<T>(), "batch"));
+			runner.print_speedup("incremental vs std::sort", runner.find("sweep_and_prune::sort(std::sort)", type_name<T>(), "batch"), runner.find("sweep_and_prune::sort(incremental)", type_name<T>(), "batch"));
+		}
+
+	template <typename T>
+		void bench_all(bench_runner& runner, size_t size, size_t scene_size)
+		{
+			bench_data<T> d(size, 42);
+			bench_conversions(runner, d);
+			bench_float_only(runner, d);
+			bench_utilities(runner, d);
+			bench_vectors(runner, d);
+			bench_expression_templates(runner, d);
+			bench_versors(runner, d);
+			bench_matrices(runner, d);
+			bench_transforms(runner, d);
+			bench_camera(runner, d);
+			bench_geometry(runner, d);
+			bench_planes(runner, d);
+			bench_culling(runner, d);
+			bench_ray_kernels(runner, d);
+			bench_bvh(runner, d, scene_size);
+			bench_aabb_tree(runner, d);
+			bench_sweep_and_prune<T>(runner);
+			bench_tracks<T>(runner);
+			bench_skinning<T>(runner);
+			bench_transform_hierarchy<T>(runner);
+			bench_parallel<T>(runner);
+			bench_fast_math(runner, d);
+			bench_morton(runner, d);
+			bench_packed(runner, d);
+		}
+}
+
+int main(int argc, char** argv)
+{
+	bench_runner runner;
+	size_t size = 1024;
+	size_t scene_size = 1 << 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "--csv") runner.format = output_format::CSV;
+		else if (arg == "--json") runner.format = output_format::JSON;
+		else if (arg == "--filter" && i + 1 < argc) runner.filter = argv[++i];
+		else if (arg == "--min-ms" && i + 1 < argc) runner.min_ms = std::atof(argv[++i]);
+		else if (arg == "--reps" && i + 1 < argc) runner.reps = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+		else if (arg == "--size" && i + 1 < argc) size = static_cast<size_t>(std::max(16, std::atoi(argv[++i])));
+		else if (arg == "--scene" && i + 1 < argc) scene_size = static_cast<size_t>(std::max(16, std::atoi(argv[++i])));
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--csv | --json] [--filter <substring>] [--min-ms <milliseconds>] [--reps <count>] [--size <elements>] [--scene <boxes>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	runner.print_header();
+
+	bench_all<float>(runner, size, scene_size);
+	bench_all<double>(runner, size, scene_size);
+
+	runner.print_footer();
+
+	return 0;
+}
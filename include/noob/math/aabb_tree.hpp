@@ -0,0 +1,468 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	// Incrementally updated AABB tree for moving objects (the usual broadphase layout). Leaves store fattened boxes, so small
+	// motions don't touch the tree at all. Inserts and removes cost O(log n) and keep the tree balanced with AVL-style rotations.
+	// Nodes live in a pool, and the handle returned by insert() stays valid until that leaf is removed.
+	template <typename T>
+		class aabb_tree
+		{
+			public:
+				static constexpr uint32_t null_node = 0xFFFFFFFF;
+
+				explicit aabb_tree(T fat_margin = 0.1) noexcept(true) : margin(fat_margin) {}
+
+				uint32_t insert(const noob::bbox_type<T>& b, uint32_t user = 0)
+				{
+					const uint32_t leaf = allocate();
+					node& n = nodes[leaf];
+					n.box = fatten(b);
+					n.user = user;
+					n.height = 0;
+					insert_leaf(leaf);
+					mark_moved(leaf);
+					++leaf_count;
+					return leaf;
+				}
+
+				void remove(uint32_t handle)
+				{
+					remove_leaf(handle);
+					// Both queues must forget the handle: release() reuses its parent link for the free list, which refit() would follow.
+					// Neither queue is ordered, so the last entry takes the removed one's slot.
+					node& n = nodes[handle];
+					if (n.dirty_slot != null_node)
+					{
+						dirty[n.dirty_slot] = dirty.back();
+						nodes[dirty.back()].dirty_slot = n.dirty_slot;
+						dirty.pop_back();
+						n.dirty_slot = null_node;
+					}
+					if (n.moved_slot != null_node)
+					{
+						moved[n.moved_slot] = moved.back();
+						nodes[moved.back()].moved_slot = n.moved_slot;
+						moved.pop_back();
+						n.moved_slot = null_node;
+					}
+					release(handle);
+					--leaf_count;
+				}
+
+				// Reinserts the leaf right away if b has left its fat box, predicting the next move by displacement.
+				// Returns false (and does nothing) if it's still inside.
+				bool update(uint32_t handle, const noob::bbox_type<T>& b, const noob::vec3_type<T>& displacement = noob::vec3_type<T>(0.0, 0.0, 0.0))
+				{
+					if (contains(nodes[handle].box, b)) return false;
+
+					remove_leaf(handle);
+					noob::bbox_type<T> fat = fatten(b);
+					for (uint32_t a = 0; a < 3; ++a)
+					{
+						const T d = displacement[a] * static_cast<T>(2.0);
+						if (d < 0.0) fat.min.v[a] += d;
+						else fat.max.v[a] += d;
+					}
+					nodes[handle].box = fat;
+					insert_leaf(handle);
+					mark_moved(handle);
+					return true;
+				}
+
+				// Cheaper alternative to update() for many objects per tick: only replaces the fat box of the leaf and queues it
+				// for refit(). The tree isn't restructured, so it's best when objects move coherently and don't swap neighbourhoods.
+				bool set_box(uint32_t handle, const noob::bbox_type<T>& b)
+				{
+					node& n = nodes[handle];
+					if (contains(n.box, b)) return false;
+					n.box = fatten(b);
+					if (n.dirty_slot == null_node)
+					{
+						n.dirty_slot = static_cast<uint32_t>(dirty.size());
+						dirty.push_back(handle);
+					}
+					mark_moved(handle);
+					return true;
+				}
+
+				// Recomputes ancestors of the leaves changed by set_box(). Each walk stops as soon as an ancestor's bounds don't change.
+				void refit()
+				{
+					for (uint32_t leaf : dirty)
+					{
+						nodes[leaf].dirty_slot = null_node;
+						for (uint32_t i = nodes[leaf].parent; i != null_node; i = nodes[i].parent)
+						{
+							const noob::bbox_type<T> b = merge(nodes[nodes[i].left].box, nodes[nodes[i].right].box);
+							if (equal(b, nodes[i].box)) break;
+							nodes[i].box = b;
+						}
+					}
+					dirty.clear();
+				}
+
+				void clear() noexcept(true)
+				{
+					nodes.clear();
+					dirty.clear();
+					moved.clear();
+					root = free_list = null_node;
+					leaf_count = 0;
+				}
+
+				// The fat box stored for a leaf.
+				const noob::bbox_type<T>& get_box(uint32_t handle) const noexcept(true)
+				{
+					return nodes[handle].box;
+				}
+
+				uint32_t get_user(uint32_t handle) const noexcept(true)
+				{
+					return nodes[handle].user;
+				}
+
+				size_t size() const noexcept(true)
+				{
+					return leaf_count;
+				}
+
+				uint32_t get_height() const noexcept(true)
+				{
+					return root == null_node ? 0 : static_cast<uint32_t>(nodes[root].height);
+				}
+
+				// Calls fn(handle) for every leaf whose fat box overlaps b.
+				template <typename F>
+					void overlap(const noob::bbox_type<T>& b, F&& fn) const
+					{
+						if (root == null_node) return;
+						uint32_t stack[stack_size];
+						uint32_t top = 0;
+						stack[top++] = root;
+						while (top != 0)
+						{
+							const node& n = nodes[stack[--top]];
+							if (!noob::overlaps(n.box, b)) continue;
+							if (n.left == null_node)
+							{
+								fn(static_cast<uint32_t>(&n - nodes.data()));
+							}
+							else
+							{
+								stack[top++] = n.left;
+								stack[top++] = n.right;
+							}
+						}
+					}
+
+				// Calls fn(handle, t_enter) for every leaf whose fat box the ray enters within [0, t_max]. fn returns the new t_max.
+				template <typename F>
+					void raycast(const noob::ray_type<T>& r, T t_max, F&& fn) const
+					{
+						if (root == null_node) return;
+						const noob::vec3_type<T> inv_dir(static_cast<T>(1.0) / r.direction[0], static_cast<T>(1.0) / r.direction[1], static_cast<T>(1.0) / r.direction[2]);
+						uint32_t stack[stack_size];
+						uint32_t top = 0;
+						stack[top++] = root;
+						while (top != 0)
+						{
+							const uint32_t i = stack[--top];
+							const node& n = nodes[i];
+							T t;
+							if (!noob::intersects(r, inv_dir, n.box, t_max, t)) continue;
+							if (n.left == null_node)
+							{
+								t_max = fn(i, t);
+							}
+							else
+							{
+								stack[top++] = n.left;
+								stack[top++] = n.right;
+							}
+						}
+					}
+
+				// Every pair of leaves whose fat boxes overlap, each once with the smaller handle first.
+				void find_pairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+				{
+					if (root != null_node) self_pairs(root, pairs);
+				}
+
+				// Only the overlapping pairs that involve a leaf inserted or moved since the last call, each once with the smaller
+				// handle first. This is what a broadphase needs every tick; pairs of two resting objects are already known.
+				void find_moved_pairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs)
+				{
+					for (uint32_t m : moved)
+					{
+						overlap(nodes[m].box, [&](uint32_t other)
+								{
+									// A pair of two moved leaves is reported from the smaller handle only.
+									if (other == m || (nodes[other].moved_slot != null_node && other < m)) return;
+									pairs.push_back(std::make_pair(std::min(m, other), std::max(m, other)));
+								});
+					}
+					for (uint32_t m : moved)
+					{
+						nodes[m].moved_slot = null_node;
+					}
+					moved.clear();
+				}
+
+			protected:
+				static constexpr uint32_t stack_size = 256;
+
+				struct node
+				{
+					noob::bbox_type<T> box;
+					// Next free node while on the free list.
+					uint32_t parent;
+					// null_node for leaves.
+					uint32_t left, right;
+					// Zero for leaves, -1 while free.
+					int32_t height;
+					uint32_t user;
+					// Index into dirty and moved, or null_node while not queued.
+					uint32_t dirty_slot, moved_slot;
+				};
+
+				static bool contains(const noob::bbox_type<T>& outer, const noob::bbox_type<T>& inner) noexcept(true)
+				{
+					return outer.min[0] <= inner.min[0] && outer.min[1] <= inner.min[1] && outer.min[2] <= inner.min[2] && outer.max[0] >= inner.max[0] && outer.max[1] >= inner.max[1] && outer.max[2] >= inner.max[2];
+				}
+
+				static bool equal(const noob::bbox_type<T>& a, const noob::bbox_type<T>& b) noexcept(true)
+				{
+					return a.min[0] == b.min[0] && a.min[1] == b.min[1] && a.min[2] == b.min[2] && a.max[0] == b.max[0] && a.max[1] == b.max[1] && a.max[2] == b.max[2];
+				}
+
+				static noob::bbox_type<T> merge(const noob::bbox_type<T>& a, const noob::bbox_type<T>& b) noexcept(true)
+				{
+					return noob::update_bbox_type(a, b);
+				}
+
+				noob::bbox_type<T> fatten(const noob::bbox_type<T>& b) const noexcept(true)
+				{
+					noob::bbox_type<T> results;
+					results.min = b.min - margin;
+					results.max = b.max + margin;
+					return results;
+				}
+
+				void mark_moved(uint32_t leaf)
+				{
+					if (nodes[leaf].moved_slot == null_node)
+					{
+						nodes[leaf].moved_slot = static_cast<uint32_t>(moved.size());
+						moved.push_back(leaf);
+					}
+				}
+
+				uint32_t allocate()
+				{
+					uint32_t i;
+					if (free_list != null_node)
+					{
+						i = free_list;
+						free_list = nodes[i].parent;
+					}
+					else
+					{
+						i = static_cast<uint32_t>(nodes.size());
+						nodes.emplace_back();
+					}
+					node& n = nodes[i];
+					n.parent = n.left = n.right = null_node;
+					n.height = 0;
+					n.user = 0;
+					n.dirty_slot = n.moved_slot = null_node;
+					return i;
+				}
+
+				void release(uint32_t i) noexcept(true)
+				{
+					nodes[i].parent = free_list;
+					nodes[i].height = -1;
+					free_list = i;
+				}
+
+				void insert_leaf(uint32_t leaf)
+				{
+					if (root == null_node)
+					{
+						root = leaf;
+						nodes[leaf].parent = null_node;
+						return;
+					}
+
+					// Descend towards the sibling that adds the least surface area, counting the growth of every ancestor on the way.
+					const noob::bbox_type<T> leaf_box = nodes[leaf].box;
+					uint32_t index = root;
+					while (nodes[index].left != null_node)
+					{
+						const node& n = nodes[index];
+						const T area = noob::surface_area(n.box);
+						const T combined = noob::surface_area(merge(n.box, leaf_box));
+						const T cost = 2.0 * combined;
+						const T inherited = 2.0 * (combined - area);
+						const T cost_left = descend_cost(n.left, leaf_box) + inherited;
+						const T cost_right = descend_cost(n.right, leaf_box) + inherited;
+						if (cost < cost_left && cost < cost_right) break;
+						index = cost_left < cost_right ? n.left : n.right;
+					}
+
+					const uint32_t sibling = index;
+					const uint32_t old_parent = nodes[sibling].parent;
+					const uint32_t new_parent = allocate();
+					nodes[new_parent].parent = old_parent;
+					nodes[new_parent].box = merge(leaf_box, nodes[sibling].box);
+					nodes[new_parent].height = nodes[sibling].height + 1;
+					nodes[new_parent].left = sibling;
+					nodes[new_parent].right = leaf;
+					nodes[sibling].parent = new_parent;
+					nodes[leaf].parent = new_parent;
+
+					if (old_parent == null_node) root = new_parent;
+					else if (nodes[old_parent].left == sibling) nodes[old_parent].left = new_parent;
+					else nodes[old_parent].right = new_parent;
+
+					fix_upwards(nodes[leaf].parent);
+				}
+
+				T descend_cost(uint32_t child, const noob::bbox_type<T>& leaf_box) const noexcept(true)
+				{
+					const T merged = noob::surface_area(merge(leaf_box, nodes[child].box));
+					return nodes[child].left == null_node ? merged : merged - noob::surface_area(nodes[child].box);
+				}
+
+				void remove_leaf(uint32_t leaf)
+				{
+					if (leaf == root)
+					{
+						root = null_node;
+						return;
+					}
+
+					const uint32_t parent = nodes[leaf].parent;
+					const uint32_t grandparent = nodes[parent].parent;
+					const uint32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+					if (grandparent == null_node)
+					{
+						root = sibling;
+						nodes[sibling].parent = null_node;
+						release(parent);
+						return;
+					}
+
+					if (nodes[grandparent].left == parent) nodes[grandparent].left = sibling;
+					else nodes[grandparent].right = sibling;
+					nodes[sibling].parent = grandparent;
+					release(parent);
+					fix_upwards(grandparent);
+				}
+
+				// Rebalances and refreshes bounds and heights from index up to the root.
+				void fix_upwards(uint32_t index) noexcept(true)
+				{
+					while (index != null_node)
+					{
+						index = balance(index);
+						node& n = nodes[index];
+						n.height = 1 + std::max(nodes[n.left].height, nodes[n.right].height);
+						n.box = merge(nodes[n.left].box, nodes[n.right].box);
+						index = n.parent;
+					}
+				}
+
+				// If a's subtrees differ in height by more than one, rotates the taller child up. Returns the subtree's new root.
+				uint32_t balance(uint32_t ia) noexcept(true)
+				{
+					node& a = nodes[ia];
+					if (a.left == null_node || a.height < 2) return ia;
+
+					const uint32_t ib = a.left, ic = a.right;
+					const int32_t diff = nodes[ic].height - nodes[ib].height;
+					if (diff > 1) return rotate_up(ia, ic, ib, false);
+					if (diff < -1) return rotate_up(ia, ib, ic, true);
+					return ia;
+				}
+
+				// Makes child c (the taller one) the parent of a. other is a's remaining child, and c_was_left says which side c hung from.
+				uint32_t rotate_up(uint32_t ia, uint32_t ic, uint32_t other, bool c_was_left) noexcept(true)
+				{
+					node& a = nodes[ia];
+					node& c = nodes[ic];
+					const uint32_t f = c.left, g = c.right;
+
+					c.left = ia;
+					c.parent = a.parent;
+					a.parent = ic;
+
+					if (c.parent == null_node) root = ic;
+					else if (nodes[c.parent].left == ia) nodes[c.parent].left = ic;
+					else nodes[c.parent].right = ic;
+
+					// The taller grandchild stays under c; the shorter one takes c's old place under a.
+					const bool f_taller = nodes[f].height > nodes[g].height;
+					const uint32_t keep = f_taller ? f : g;
+					const uint32_t give = f_taller ? g : f;
+					c.right = keep;
+					if (c_was_left) a.left = give;
+					else a.right = give;
+					nodes[give].parent = ia;
+
+					a.box = merge(nodes[other].box, nodes[give].box);
+					c.box = merge(a.box, nodes[keep].box);
+					a.height = 1 + std::max(nodes[other].height, nodes[give].height);
+					c.height = 1 + std::max(a.height, nodes[keep].height);
+					return ic;
+				}
+
+				void self_pairs(uint32_t i, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+				{
+					const node& n = nodes[i];
+					if (n.left == null_node) return;
+					self_pairs(n.left, pairs);
+					self_pairs(n.right, pairs);
+					cross_pairs(n.left, n.right, pairs);
+				}
+
+				// Descends the larger of the two subtrees until both sides are leaves.
+				void cross_pairs(uint32_t ia, uint32_t ib, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+				{
+					const node& a = nodes[ia];
+					const node& b = nodes[ib];
+					if (!noob::overlaps(a.box, b.box)) return;
+					const bool a_leaf = a.left == null_node, b_leaf = b.left == null_node;
+					if (a_leaf && b_leaf)
+					{
+						pairs.push_back(std::make_pair(std::min(ia, ib), std::max(ia, ib)));
+					}
+					else if (b_leaf || (!a_leaf && noob::surface_area(a.box) >= noob::surface_area(b.box)))
+					{
+						cross_pairs(a.left, ib, pairs);
+						cross_pairs(a.right, ib, pairs);
+					}
+					else
+					{
+						cross_pairs(ia, b.left, pairs);
+						cross_pairs(ia, b.right, pairs);
+					}
+				}
+
+				std::vector<node> nodes;
+				std::vector<uint32_t> dirty, moved;
+				uint32_t root = null_node;
+				uint32_t free_list = null_node;
+				size_t leaf_count = 0;
+				T margin;
+		};
+}
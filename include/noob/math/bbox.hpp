@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include "vec3.hpp"
 
 namespace noob
@@ -12,11 +14,26 @@ namespace noob
 				return noob::vec3_type<T>(std::fabs(min.v[0]) + std::fabs(max.v[0]), std::fabs(min.v[1]) + std::fabs(max.v[1]), std::fabs(max.v[2]) + std::fabs(max.v[2]));
 			}
 
+			// A point-sized box at the origin. Not a starting point for accumulating bounds (it always contains the origin); use
+			// set_empty() for that.
 			void reset() noexcept(true)
 			{
 				min = max = noob::vec3_type<T>(0.0, 0.0, 0.0);
 			}
 
+			// min at +infinity and max at -infinity, so the first point or box merged in becomes the whole box.
+			void set_empty() noexcept(true)
+			{
+				const T inf = std::numeric_limits<T>::infinity();
+				min = noob::vec3_type<T>(inf, inf, inf);
+				max = noob::vec3_type<T>(-inf, -inf, -inf);
+			}
+
+			bool empty() const noexcept(true)
+			{
+				return min.v[0] > max.v[0] || min.v[1] > max.v[1] || min.v[2] > max.v[2];
+			}
+
 			noob::vec3_type<T> min, max;
 		};
 }
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+#include "bbox.hpp"
+#include "vec3_soa.hpp"
+
+namespace noob
+{
+	// Structure-of-arrays storage for bbox_types: the min and max corners each get one stream per component,
+	// so culling and overlap kernels can test one box per SIMD lane.
+	template <typename T>
+		struct bbox_soa
+		{
+			size_t size() const noexcept(true)
+			{
+				return min.size();
+			}
+
+			void resize(size_t n)
+			{
+				min.resize(n);
+				max.resize(n);
+			}
+
+			void reserve(size_t n)
+			{
+				min.reserve(n);
+				max.reserve(n);
+			}
+
+			void clear() noexcept(true)
+			{
+				min.clear();
+				max.clear();
+			}
+
+			void push_back(const bbox_type<T>& arg)
+			{
+				min.push_back(arg.min);
+				max.push_back(arg.max);
+			}
+
+			bbox_type<T> get(size_t i) const noexcept(true)
+			{
+				bbox_type<T> results;
+				results.min = min.get(i);
+				results.max = max.get(i);
+				return results;
+			}
+
+			void set(size_t i, const bbox_type<T>& arg) noexcept(true)
+			{
+				min.set(i, arg.min);
+				max.set(i, arg.max);
+			}
+
+			// AoS -> SoA
+			void gather(const bbox_type<T>* src, size_t count)
+			{
+				resize(count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					set(i, src[i]);
+				}
+			}
+
+			void gather(const std::vector<bbox_type<T>>& src)
+			{
+				gather(src.data(), src.size());
+			}
+
+			// SoA -> AoS. dst must hold size() elements.
+			void scatter(bbox_type<T>* dst) const noexcept(true)
+			{
+				const size_t count = size();
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[i] = get(i);
+				}
+			}
+
+			void scatter(std::vector<bbox_type<T>>& dst) const
+			{
+				dst.resize(size());
+				scatter(dst.data());
+			}
+
+			noob::vec3_soa<T> min, max;
+		};
+}
@@ -0,0 +1,641 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "math_funcs.hpp"
+#include "parallel.hpp"
+
+namespace noob
+{
+	// One node of a four-wide BVH. Lane k holds the bounds of child k in SoA form, so a query tests all four children together.
+	// child[k] >= 0 is the index of an inner node. child[k] < 0 is a leaf whose primitives are [~child[k], ~child[k] + count[k])
+	// in leaf order. Unused lanes have count 0 and inverted bounds so no test can hit them. 128 bytes for float: two cache lines.
+	template <typename T>
+		struct alignas(64) bvh4_node
+		{
+			T min_x[4], min_y[4], min_z[4];
+			T max_x[4], max_y[4], max_z[4];
+			int32_t child[4];
+			uint32_t count[4];
+		};
+
+	// Bounding volume hierarchy over bbox_type primitives. Built top-down with binned SAH, then collapsed into bvh4_nodes.
+	// Binning over large ranges and the two halves of large subtrees run on separate threads; the result doesn't depend on the thread count.
+	template <typename T>
+		class bvh
+		{
+			public:
+				void build(const noob::bbox_type<T>* prims, size_t count, uint32_t max_leaf_size = 4)
+				{
+					clear();
+					if (count == 0) return;
+
+					leaf_size = std::max(1u, std::min(max_leaf_size, 255u));
+					refs.resize(count);
+
+					// Root bounds, reduced per chunk then merged in chunk order.
+					const size_t chunks = noob::parallel_chunks(count, parallel_grain);
+					std::vector<bin> partial(chunks);
+					noob::parallel_for(count, parallel_grain, [&](size_t chunk, size_t begin, size_t end)
+							{
+								bin b;
+								for (size_t i = begin; i < end; ++i)
+								{
+									prim_ref& r = refs[i];
+									r.box = prims[i];
+									r.centroid = (prims[i].min + prims[i].max) * static_cast<T>(0.5);
+									r.index = static_cast<uint32_t>(i);
+									b.add(r.box, r.centroid);
+								}
+								partial[chunk] = b;
+							});
+					bin root;
+					for (const bin& b : partial)
+					{
+						root.merge(b);
+					}
+
+					build_nodes.resize(2 * count - 1);
+					std::atomic<uint32_t> next(1);
+					next_build_node = &next;
+					build_recursive(0, 0, count, root.bounds, root.centroid_bounds, 0, 0);
+					build_nodes.resize(next.load());
+
+					// Flatten into four-wide nodes; the walk is depth-first, so the layout is deterministic.
+					nodes.reserve(build_nodes.size() / 2 + 1);
+					collapse(0);
+					bounds = build_nodes[0].bounds;
+
+					prim_indices.resize(count);
+					leaf_boxes.resize(count);
+					noob::parallel_for(count, parallel_grain, [&](size_t, size_t begin, size_t end)
+							{
+								for (size_t i = begin; i < end; ++i)
+								{
+									prim_indices[i] = refs[i].index;
+									leaf_boxes[i] = refs[i].box;
+								}
+							});
+
+					std::vector<build_node>().swap(build_nodes);
+					std::vector<prim_ref>().swap(refs);
+					next_build_node = nullptr;
+				}
+
+				void build(const std::vector<noob::bbox_type<T>>& prims, uint32_t max_leaf_size = 4)
+				{
+					build(prims.data(), prims.size(), max_leaf_size);
+				}
+
+				void clear() noexcept(true)
+				{
+					nodes.clear();
+					prim_indices.clear();
+					leaf_boxes.clear();
+					bounds.reset();
+				}
+
+				bool empty() const noexcept(true)
+				{
+					return nodes.empty();
+				}
+
+				size_t size() const noexcept(true)
+				{
+					return prim_indices.size();
+				}
+
+				size_t node_count() const noexcept(true)
+				{
+					return nodes.size();
+				}
+
+				noob::bbox_type<T> get_bounds() const noexcept(true)
+				{
+					return bounds;
+				}
+
+				// Calls fn(prim, t_enter) for every primitive whose box the ray enters within [0, t_max], nearest nodes first.
+				// fn returns the new t_max, so a closest-hit search can shrink the interval as it finds hits.
+				template <typename F>
+					void raycast(const noob::ray_type<T>& r, T t_max, F&& fn) const
+					{
+						if (nodes.empty()) return;
+						const noob::vec3_type<T> inv_dir(static_cast<T>(1.0) / r.direction[0], static_cast<T>(1.0) / r.direction[1], static_cast<T>(1.0) / r.direction[2]);
+
+						uint32_t stack[stack_size];
+						T stack_t[stack_size];
+						uint32_t top = 0;
+						stack[top] = 0;
+						stack_t[top++] = 0.0;
+
+						while (top != 0)
+						{
+							--top;
+							if (stack_t[top] > t_max) continue;
+							const bvh4_node<T>& node = nodes[stack[top]];
+
+							T t_enter[4];
+							bool hit[4];
+							for (uint32_t k = 0; k < 4; ++k)
+							{
+								const T x0 = (node.min_x[k] - r.origin[0]) * inv_dir[0], x1 = (node.max_x[k] - r.origin[0]) * inv_dir[0];
+								const T y0 = (node.min_y[k] - r.origin[1]) * inv_dir[1], y1 = (node.max_y[k] - r.origin[1]) * inv_dir[1];
+								const T z0 = (node.min_z[k] - r.origin[2]) * inv_dir[2], z1 = (node.max_z[k] - r.origin[2]) * inv_dir[2];
+								const T t0 = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), static_cast<T>(0.0)));
+								const T t1 = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::min(std::max(z0, z1), t_max));
+								t_enter[k] = t0;
+								hit[k] = t0 <= t1;
+							}
+
+							// Leaves are handled right away; inner children are pushed far to near so the nearest is popped next.
+							uint32_t inner[4];
+							uint32_t inner_count = 0;
+							for (uint32_t k = 0; k < 4; ++k)
+							{
+								if (!hit[k]) continue;
+								if (node.child[k] < 0)
+								{
+									const uint32_t first = ~static_cast<uint32_t>(node.child[k]);
+									for (uint32_t i = first; i < first + node.count[k]; ++i)
+									{
+										T t;
+										if (noob::intersects(r, inv_dir, leaf_boxes[i], t_max, t))
+										{
+											t_max = fn(prim_indices[i], t);
+										}
+									}
+								}
+								else
+								{
+									uint32_t j = inner_count++;
+									for (; j > 0 && t_enter[inner[j - 1]] < t_enter[k]; --j)
+									{
+										inner[j] = inner[j - 1];
+									}
+									inner[j] = k;
+								}
+							}
+							for (uint32_t j = 0; j < inner_count; ++j)
+							{
+								stack[top] = static_cast<uint32_t>(node.child[inner[j]]);
+								stack_t[top++] = t_enter[inner[j]];
+							}
+						}
+					}
+
+				// Closest primitive box hit by the ray within [0, t_max].
+				bool raycast(const noob::ray_type<T>& r, T t_max, uint32_t& prim, T& t) const
+				{
+					bool found = false;
+					raycast(r, t_max, [&](uint32_t p, T t_enter)
+							{
+								if (!found || t_enter < t)
+								{
+									found = true;
+									prim = p;
+									t = t_enter;
+								}
+								return t;
+							});
+					return found;
+				}
+
+				// Calls fn(prim) for every primitive whose box overlaps b.
+				template <typename F>
+					void overlap(const noob::bbox_type<T>& b, F&& fn) const
+					{
+						if (nodes.empty()) return;
+
+						uint32_t stack[stack_size];
+						uint32_t top = 0;
+						stack[top++] = 0;
+
+						while (top != 0)
+						{
+							const bvh4_node<T>& node = nodes[stack[--top]];
+							bool hit[4];
+							for (uint32_t k = 0; k < 4; ++k)
+							{
+								hit[k] = node.min_x[k] <= b.max[0] && node.max_x[k] >= b.min[0] && node.min_y[k] <= b.max[1] && node.max_y[k] >= b.min[1] && node.min_z[k] <= b.max[2] && node.max_z[k] >= b.min[2];
+							}
+							for (uint32_t k = 0; k < 4; ++k)
+							{
+								if (!hit[k]) continue;
+								if (node.child[k] < 0)
+								{
+									const uint32_t first = ~static_cast<uint32_t>(node.child[k]);
+									for (uint32_t i = first; i < first + node.count[k]; ++i)
+									{
+										if (noob::overlaps(leaf_boxes[i], b)) fn(prim_indices[i]);
+									}
+								}
+								else
+								{
+									stack[top++] = static_cast<uint32_t>(node.child[k]);
+								}
+							}
+						}
+					}
+
+				// Appends the primitives overlapping b to results and returns how many were added.
+				size_t overlap(const noob::bbox_type<T>& b, std::vector<uint32_t>& results) const
+				{
+					const size_t before = results.size();
+					overlap(b, [&results](uint32_t p) { results.push_back(p); });
+					return results.size() - before;
+				}
+
+				// Primitive whose box is closest to p, searching no further than sqrt(max_dist_sq). Distance is zero inside a box.
+				bool nearest(const noob::vec3_type<T>& p, T max_dist_sq, uint32_t& prim, T& dist_sq) const
+				{
+					if (nodes.empty()) return false;
+
+					uint32_t stack[stack_size];
+					T stack_d[stack_size];
+					uint32_t top = 0;
+					stack[top] = 0;
+					stack_d[top++] = 0.0;
+					T best = max_dist_sq;
+					bool found = false;
+
+					while (top != 0)
+					{
+						--top;
+						if (stack_d[top] > best) continue;
+						const bvh4_node<T>& node = nodes[stack[top]];
+
+						T d[4];
+						for (uint32_t k = 0; k < 4; ++k)
+						{
+							const T dx = std::max(std::max(node.min_x[k] - p[0], p[0] - node.max_x[k]), static_cast<T>(0.0));
+							const T dy = std::max(std::max(node.min_y[k] - p[1], p[1] - node.max_y[k]), static_cast<T>(0.0));
+							const T dz = std::max(std::max(node.min_z[k] - p[2], p[2] - node.max_z[k]), static_cast<T>(0.0));
+							d[k] = dx * dx + dy * dy + dz * dz;
+						}
+
+						uint32_t inner[4];
+						uint32_t inner_count = 0;
+						for (uint32_t k = 0; k < 4; ++k)
+						{
+							if (node.count[k] == 0 && node.child[k] < 0) continue;
+							if (d[k] > best) continue;
+							if (node.child[k] < 0)
+							{
+								const uint32_t first = ~static_cast<uint32_t>(node.child[k]);
+								for (uint32_t i = first; i < first + node.count[k]; ++i)
+								{
+									const T dd = noob::get_squared_dist(p, leaf_boxes[i]);
+									if (dd <= best && (!found || dd < dist_sq))
+									{
+										found = true;
+										prim = prim_indices[i];
+										dist_sq = dd;
+										best = dd;
+									}
+								}
+							}
+							else
+							{
+								uint32_t j = inner_count++;
+								for (; j > 0 && d[inner[j - 1]] < d[k]; --j)
+								{
+									inner[j] = inner[j - 1];
+								}
+								inner[j] = k;
+							}
+						}
+						for (uint32_t j = 0; j < inner_count; ++j)
+						{
+							stack[top] = static_cast<uint32_t>(node.child[inner[j]]);
+							stack_d[top++] = d[inner[j]];
+						}
+					}
+					return found;
+				}
+
+				bool nearest(const noob::vec3_type<T>& p, uint32_t& prim, T& dist_sq) const
+				{
+					return nearest(p, std::numeric_limits<T>::max(), prim, dist_sq);
+				}
+
+			protected:
+				static constexpr uint32_t bin_count = 16;
+				// Ranges smaller than this are binned and built on a single thread.
+				static constexpr size_t parallel_grain = 16384;
+				// After this many levels, splits fall back to the object median, which bounds the depth (and the traversal stacks).
+				static constexpr uint32_t max_sah_depth = 48;
+				static constexpr uint32_t stack_size = 256;
+
+				struct bin
+				{
+					bin() noexcept(true)
+					{
+						bounds.min = centroid_bounds.min = noob::vec3_type<T>(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max());
+						bounds.max = centroid_bounds.max = noob::vec3_type<T>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest());
+					}
+
+					void add(const noob::bbox_type<T>& b, const noob::vec3_type<T>& c) noexcept(true)
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+						{
+							bounds.min.v[a] = std::min(bounds.min.v[a], b.min.v[a]);
+							bounds.max.v[a] = std::max(bounds.max.v[a], b.max.v[a]);
+							centroid_bounds.min.v[a] = std::min(centroid_bounds.min.v[a], c.v[a]);
+							centroid_bounds.max.v[a] = std::max(centroid_bounds.max.v[a], c.v[a]);
+						}
+						++count;
+					}
+
+					void merge(const bin& other) noexcept(true)
+					{
+						if (other.count == 0) return;
+						bounds = noob::update_bbox_type(bounds, other.bounds);
+						centroid_bounds = noob::update_bbox_type(centroid_bounds, other.centroid_bounds);
+						count += other.count;
+					}
+
+					noob::bbox_type<T> bounds, centroid_bounds;
+					size_t count = 0;
+				};
+
+				// Primitives are partitioned by value rather than through an index array, so binning reads memory in order.
+				struct prim_ref
+				{
+					noob::bbox_type<T> box;
+					noob::vec3_type<T> centroid;
+					uint32_t index;
+				};
+
+				// Binary node used while building. Inner nodes have count 0 and their children at left and left + 1.
+				struct build_node
+				{
+					noob::bbox_type<T> bounds;
+					uint32_t left, first, count;
+				};
+
+				void build_recursive(uint32_t index, size_t begin, size_t end, const noob::bbox_type<T>& node_bounds, const noob::bbox_type<T>& centroid_bounds, uint32_t depth, uint32_t forks)
+				{
+					build_node& node = build_nodes[index];
+					node.bounds = node_bounds;
+					const size_t count = end - begin;
+
+					if (count <= leaf_size)
+					{
+						make_leaf(node, begin, count);
+						return;
+					}
+
+					size_t mid = begin;
+					noob::bbox_type<T> left_bounds, right_bounds, left_centroids, right_centroids;
+
+					uint32_t axis = 0;
+					const noob::vec3_type<T> extent = centroid_bounds.max - centroid_bounds.min;
+					if (extent[1] > extent[axis]) axis = 1;
+					if (extent[2] > extent[axis]) axis = 2;
+
+					split_result split = split_result::NONE;
+					if (depth < max_sah_depth && extent[axis] > 0.0)
+					{
+						split = split_sah(begin, end, node_bounds, centroid_bounds, mid, left_bounds, right_bounds, left_centroids, right_centroids);
+					}
+					else if (count <= leaf_size * 4 && extent[axis] <= 0.0)
+					{
+						// Coincident centroids: nothing separates these.
+						split = split_result::LEAF;
+					}
+
+					if (split == split_result::LEAF)
+					{
+						make_leaf(node, begin, count);
+						return;
+					}
+
+					if (split == split_result::NONE)
+					{
+						// Object median along the widest centroid axis.
+						mid = begin + count / 2;
+						prim_ref* pr = refs.data();
+						std::nth_element(pr + begin, pr + mid, pr + end, [axis](const prim_ref& a, const prim_ref& b) { return a.centroid[axis] < b.centroid[axis] || (a.centroid[axis] == b.centroid[axis] && a.index < b.index); });
+						bin l, r;
+						for (size_t i = begin; i < mid; ++i)
+						{
+							l.add(pr[i].box, pr[i].centroid);
+						}
+						for (size_t i = mid; i < end; ++i)
+						{
+							r.add(pr[i].box, pr[i].centroid);
+						}
+						left_bounds = l.bounds;
+						left_centroids = l.centroid_bounds;
+						right_bounds = r.bounds;
+						right_centroids = r.centroid_bounds;
+					}
+
+					const uint32_t left = next_build_node->fetch_add(2);
+					node.left = left;
+					node.first = 0;
+					node.count = 0;
+
+					if (count >= parallel_grain && (1u << forks) < noob::get_thread_count())
+					{
+						noob::parallel_invoke([&]() { build_recursive(left, begin, mid, left_bounds, left_centroids, depth + 1, forks + 1); }, [&]() { build_recursive(left + 1, mid, end, right_bounds, right_centroids, depth + 1, forks + 1); });
+					}
+					else
+					{
+						build_recursive(left, begin, mid, left_bounds, left_centroids, depth + 1, forks);
+						build_recursive(left + 1, mid, end, right_bounds, right_centroids, depth + 1, forks);
+					}
+				}
+
+				void make_leaf(build_node& node, size_t begin, size_t count) noexcept(true)
+				{
+					node.left = 0;
+					node.first = static_cast<uint32_t>(begin);
+					node.count = static_cast<uint32_t>(count);
+				}
+
+				enum class split_result
+				{
+					SPLIT, LEAF, NONE
+				};
+
+				// Bins centroids on all three axes and partitions [begin, end) at the cheapest SAH plane. Returns LEAF if keeping the
+				// range together is cheaper (only considered while it's small enough to be one) and NONE if no plane separates it.
+				split_result split_sah(size_t begin, size_t end, const noob::bbox_type<T>& node_bounds, const noob::bbox_type<T>& centroid_bounds, size_t& mid, noob::bbox_type<T>& left_bounds, noob::bbox_type<T>& right_bounds, noob::bbox_type<T>& left_centroids, noob::bbox_type<T>& right_centroids)
+				{
+					T scale[3];
+					for (uint32_t a = 0; a < 3; ++a)
+					{
+						const T extent = centroid_bounds.max[a] - centroid_bounds.min[a];
+						scale[a] = extent > 0.0 ? static_cast<T>(bin_count) * static_cast<T>(0.9999) / extent : static_cast<T>(0.0);
+					}
+					const noob::vec3_type<T> origin = centroid_bounds.min;
+					const prim_ref* pr = refs.data();
+
+					const size_t count = end - begin;
+					auto bin_range = [&](std::array<bin, 3 * bin_count>& bins, size_t b, size_t e)
+					{
+						for (size_t i = begin + b; i < begin + e; ++i)
+						{
+							for (uint32_t a = 0; a < 3; ++a)
+							{
+								const uint32_t k = std::min(static_cast<uint32_t>((pr[i].centroid[a] - origin[a]) * scale[a]), bin_count - 1);
+								bins[a * bin_count + k].add(pr[i].box, pr[i].centroid);
+							}
+						}
+					};
+
+					std::array<bin, 3 * bin_count> bins;
+					const size_t chunks = noob::parallel_chunks(count, parallel_grain);
+					if (chunks > 1)
+					{
+						std::vector<std::array<bin, 3 * bin_count>> partial(chunks);
+						noob::parallel_for(count, parallel_grain, [&](size_t chunk, size_t b, size_t e) { bin_range(partial[chunk], b, e); });
+						for (size_t c = 0; c < chunks; ++c)
+						{
+							for (uint32_t k = 0; k < 3 * bin_count; ++k)
+							{
+								bins[k].merge(partial[c][k]);
+							}
+						}
+					}
+					else
+					{
+						bin_range(bins, 0, count);
+					}
+
+					// Sweep each axis: costs[s] is the cost of putting bins [0, s] on the left.
+					T best_cost = std::numeric_limits<T>::max();
+					uint32_t best_axis = 0, best_split = 0;
+					for (uint32_t a = 0; a < 3; ++a)
+					{
+						if (scale[a] == 0.0) continue;
+						const bin* ab = &bins[a * bin_count];
+						T right_cost[bin_count];
+						bin r;
+						for (uint32_t s = bin_count - 1; s > 0; --s)
+						{
+							r.merge(ab[s]);
+							right_cost[s - 1] = r.count ? noob::surface_area(r.bounds) * static_cast<T>(r.count) : static_cast<T>(0.0);
+						}
+						bin l;
+						for (uint32_t s = 0; s < bin_count - 1; ++s)
+						{
+							l.merge(ab[s]);
+							if (l.count == 0 || l.count == count) continue;
+							const T cost = noob::surface_area(l.bounds) * static_cast<T>(l.count) + right_cost[s];
+							if (cost < best_cost)
+							{
+								best_cost = cost;
+								best_axis = a;
+								best_split = s;
+							}
+						}
+					}
+
+					if (best_cost == std::numeric_limits<T>::max()) return split_result::NONE;
+					// Traversal step costs about as much as one primitive test.
+					const T leaf_cost = noob::surface_area(node_bounds) * static_cast<T>(count);
+					if (count <= leaf_size * 4 && leaf_cost <= best_cost + noob::surface_area(node_bounds)) return split_result::LEAF;
+
+					const bin* ab = &bins[best_axis * bin_count];
+					bin l, r;
+					for (uint32_t s = 0; s < bin_count; ++s)
+					{
+						if (s <= best_split) l.merge(ab[s]);
+						else r.merge(ab[s]);
+					}
+					left_bounds = l.bounds;
+					left_centroids = l.centroid_bounds;
+					right_bounds = r.bounds;
+					right_centroids = r.centroid_bounds;
+
+					const T o = origin[best_axis], sc = scale[best_axis];
+					prim_ref* first = refs.data() + begin;
+					prim_ref* pivot = std::partition(first, refs.data() + end, [&](const prim_ref& p)
+							{
+								return std::min(static_cast<uint32_t>((p.centroid[best_axis] - o) * sc), bin_count - 1) <= best_split;
+							});
+					mid = begin + static_cast<size_t>(pivot - first);
+					return split_result::SPLIT;
+				}
+
+				// Emits the four-wide node for binary node index and returns its position. Lanes start as the two children and the
+				// largest inner lane is opened up until there are four of them or only leaves remain.
+				int32_t collapse(uint32_t index)
+				{
+					uint32_t lanes[4];
+					uint32_t lane_count = 1;
+					lanes[0] = index;
+					while (lane_count < 4)
+					{
+						int32_t widest = -1;
+						T widest_area = static_cast<T>(-1.0);
+						for (uint32_t k = 0; k < lane_count; ++k)
+						{
+							const build_node& n = build_nodes[lanes[k]];
+							if (n.count == 0 && surface_area(n.bounds) > widest_area)
+							{
+								widest = static_cast<int32_t>(k);
+								widest_area = surface_area(n.bounds);
+							}
+						}
+						if (widest < 0) break;
+						const uint32_t left = build_nodes[lanes[widest]].left;
+						lanes[widest] = left;
+						lanes[lane_count++] = left + 1;
+					}
+
+					const int32_t position = static_cast<int32_t>(nodes.size());
+					nodes.emplace_back();
+					for (uint32_t k = 0; k < 4; ++k)
+					{
+						int32_t child = -1;
+						uint32_t count = 0;
+						noob::bbox_type<T> b;
+						if (k < lane_count)
+						{
+							const build_node& n = build_nodes[lanes[k]];
+							b = n.bounds;
+							if (n.count != 0)
+							{
+								child = ~static_cast<int32_t>(n.first);
+								count = n.count;
+							}
+							else
+							{
+								child = collapse(lanes[k]);
+							}
+						}
+						else
+						{
+							b.min = noob::vec3_type<T>(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max());
+							b.max = noob::vec3_type<T>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest());
+						}
+						bvh4_node<T>& node = nodes[position];
+						node.min_x[k] = b.min[0]; node.min_y[k] = b.min[1]; node.min_z[k] = b.min[2];
+						node.max_x[k] = b.max[0]; node.max_y[k] = b.max[1]; node.max_z[k] = b.max[2];
+						node.child[k] = child;
+						node.count[k] = count;
+					}
+					return position;
+				}
+
+				std::vector<bvh4_node<T>, noob::aligned_allocator<bvh4_node<T>>> nodes;
+				std::vector<uint32_t> prim_indices;
+				std::vector<noob::bbox_type<T>> leaf_boxes;
+				noob::bbox_type<T> bounds;
+				uint32_t leaf_size = 4;
+
+				// Build-time scratch.
+				std::vector<build_node> build_nodes;
+				std::vector<prim_ref> refs;
+				std::atomic<uint32_t>* next_build_node = nullptr;
+		};
+}
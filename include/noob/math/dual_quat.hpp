@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cmath>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	// Both helpers are declared inline: once a translation unit has several callers, GCC at -O2 otherwise keeps them out of
+	// line, which more than doubled the cost of transform_type::operator*.
+	namespace detail
+	{
+		// Hamilton product a * b, without the renormalization versor_type::operator* does (dual parts aren't unit length).
+		template <typename T>
+			static inline noob::versor_type<T> quat_multiply(const noob::versor_type<T>& a, const noob::versor_type<T>& b) noexcept(true)
+			{
+				noob::versor_type<T> r;
+				r.q[0] = a.q[0] * b.q[0] - a.q[1] * b.q[1] - a.q[2] * b.q[2] - a.q[3] * b.q[3];
+				r.q[1] = a.q[0] * b.q[1] + a.q[1] * b.q[0] + a.q[2] * b.q[3] - a.q[3] * b.q[2];
+				r.q[2] = a.q[0] * b.q[2] - a.q[1] * b.q[3] + a.q[2] * b.q[0] + a.q[3] * b.q[1];
+				r.q[3] = a.q[0] * b.q[3] + a.q[1] * b.q[2] - a.q[2] * b.q[1] + a.q[3] * b.q[0];
+				return r;
+			}
+
+		// q * v * conjugate(q) for unit q, as v + 2 * r x (r x v + w * v) with r the vector part of q.
+		template <typename T>
+			static inline noob::vec3_type<T> quat_rotate(const noob::versor_type<T>& q, const noob::vec3_type<T>& v) noexcept(true)
+			{
+				const T w = q.q[0], rx = q.q[1], ry = q.q[2], rz = q.q[3];
+				const T cx = ry * v[2] - rz * v[1] + w * v[0];
+				const T cy = rz * v[0] - rx * v[2] + w * v[1];
+				const T cz = rx * v[1] - ry * v[0] + w * v[2];
+				const T two = 2.0;
+				return noob::vec3_type<T>(v[0] + two * (ry * cz - rz * cy), v[1] + two * (rz * cx - rx * cz), v[2] + two * (rx * cy - ry * cx));
+			}
+	}
+
+	// Rigid transform (rotation then translation) as a unit dual quaternion real + e * dual, both w-first like versor_type.
+	// Blending these instead of matrices keeps skinned joints from collapsing (see skin_dual_quat() in skinning.hpp).
+	template <typename T>
+		struct dual_quat
+		{
+			dual_quat() noexcept(true) = default;
+
+			constexpr dual_quat(const noob::versor_type<T>& r, const noob::versor_type<T>& d) noexcept(true) : real(r), dual(d) {}
+
+			// rotation must be unit length.
+			static dual_quat from_rotation_translation(const noob::versor_type<T>& rotation, const noob::vec3_type<T>& translation) noexcept(true)
+			{
+				const noob::versor_type<T> t(static_cast<T>(0.0), translation[0], translation[1], translation[2]);
+				const noob::versor_type<T> d = detail::quat_multiply(t, rotation);
+				return dual_quat(rotation, noob::versor_type<T>(d.q[0] * 0.5, d.q[1] * 0.5, d.q[2] * 0.5, d.q[3] * 0.5));
+			}
+
+			// m must be rigid (orthonormal rotation plus translation); any scale or shear is lost.
+			static dual_quat from_mat4(const noob::mat4_type<T>& m) noexcept(true)
+			{
+				return from_rotation_translation(noob::versor_from_mat4(m), noob::vec3_type<T>(m.m[12], m.m[13], m.m[14]));
+			}
+
+			static dual_quat identity() noexcept(true)
+			{
+				return dual_quat(noob::versor_type<T>(1.0, 0.0, 0.0, 0.0), noob::versor_type<T>(0.0, 0.0, 0.0, 0.0));
+			}
+
+			noob::versor_type<T> get_rotation() const noexcept(true)
+			{
+				return real;
+			}
+
+			// 2 * dual * conjugate(real)
+			noob::vec3_type<T> get_translation() const noexcept(true)
+			{
+				const noob::versor_type<T> conj(real.q[0], -real.q[1], -real.q[2], -real.q[3]);
+				const noob::versor_type<T> t = detail::quat_multiply(dual, conj);
+				return noob::vec3_type<T>(t.q[1] * 2.0, t.q[2] * 2.0, t.q[3] * 2.0);
+			}
+
+			noob::mat4_type<T> to_mat4() const noexcept(true)
+			{
+				noob::mat4_type<T> m = noob::versor_to_mat4(real);
+				const noob::vec3_type<T> t = get_translation();
+				m.m[12] = t[0];
+				m.m[13] = t[1];
+				m.m[14] = t[2];
+				return m;
+			}
+
+			// Applies rhs first, then this.
+			dual_quat operator*(const dual_quat& rhs) const noexcept(true)
+			{
+				const noob::versor_type<T> a = detail::quat_multiply(real, rhs.dual);
+				const noob::versor_type<T> b = detail::quat_multiply(dual, rhs.real);
+				return dual_quat(detail::quat_multiply(real, rhs.real), noob::versor_type<T>(a.q[0] + b.q[0], a.q[1] + b.q[1], a.q[2] + b.q[2], a.q[3] + b.q[3]));
+			}
+
+			// Rescales to a unit real part, as needed after blending.
+			void normalize() noexcept(true)
+			{
+				const T inv = static_cast<T>(1.0) / std::sqrt(real.q[0] * real.q[0] + real.q[1] * real.q[1] + real.q[2] * real.q[2] + real.q[3] * real.q[3]);
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					real.q[k] *= inv;
+					dual.q[k] *= inv;
+				}
+			}
+
+			noob::vec3_type<T> transform_point(const noob::vec3_type<T>& p) const noexcept(true)
+			{
+				return rotate(p) + get_translation();
+			}
+
+			noob::vec3_type<T> rotate(const noob::vec3_type<T>& v) const noexcept(true)
+			{
+				return detail::quat_rotate(real, v);
+			}
+
+			noob::versor_type<T> real, dual;
+		};
+
+	typedef dual_quat<float> dual_quatf;
+	typedef dual_quat<double> dual_quatd;
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "simd.hpp"
+
+namespace noob
+{
+	// Approximate transcendentals for code that can trade the last few bits for speed: rsqrt refined by Newton's method,
+	// sine and cosine from one shared range reduction, and polynomial atan2 and acos. They have no data-dependent branches,
+	// so loops over them vectorize (apart from the SSE rsqrt, a scalar intrinsic). They assume finite inputs and don't set errno.
+	//
+	// Maximum errors against a long double reference, over the stated range:
+	//
+	//	                         float                       double
+	//	rsqrt (x > 0)            2.7e-7 relative (SSE)       1.7e-16 relative (just 1 / sqrt)
+	//	                         8.9e-8 relative (no SSE)
+	//	sincos (|x| <= 8192)     9.4e-8 absolute             1.8e-16 absolute
+	//	atan2                    2.8e-7 radians              4.6e-16 radians
+	//	acos (|x| <= 1)          3.1e-7 radians              5.8e-16 radians
+	//
+	// That is about an ulp or two of the largest results. Past |x| = 8192 the sincos range reduction loses accuracy
+	// linearly in |x|.
+	//
+	// precise_math and fast_math wrap the standard library and these, so functions taking a math policy (normalize(),
+	// slerp(), rotate_x_deg(), versor_from_axis_rad(), direction_to_heading() and so on) can be switched per call, eg:
+	//	noob::normalize(v, noob::fast_math());
+	// Defining NOOB_FAST_MATH makes fast_math the default everywhere.
+
+	namespace detail
+	{
+		// Minimax polynomials on the reduced ranges below, in z = x * x.
+
+		// (sin(x) - x) / x^3 and (cos(x) - 1 + x^2 / 2) / x^4 for |x| <= pi / 4.
+		static inline float sin_poly(float z) noexcept(true)
+		{
+			return -1.66666646623143786e-01f + z * (8.33274827062974966e-03f + z * -1.95878908804124004e-04f);
+		}
+
+		static inline double sin_poly(double z) noexcept(true)
+		{
+			return -1.66666666666666646e-01 + z * (8.33333333333094733e-03 + z * (-1.98412698367575033e-04 + z * (2.75573161022232753e-06 + z * (-2.50511318062938357e-08 + z * 1.59181279078825327e-10))));
+		}
+
+		static inline float cos_poly(float z) noexcept(true)
+		{
+			return 4.16666646595022068e-02f + z * (-1.38883030358948662e-03f + z * 2.45479420850715942e-05f);
+		}
+
+		static inline double cos_poly(double z) noexcept(true)
+		{
+			return 4.16666666666666654e-02 + z * (-1.38888888888873956e-03 + z * (2.48015872987635852e-05 + z * (-2.75573172709239736e-07 + z * (2.08761461462025357e-09 + z * -1.13826259469575478e-11))));
+		}
+
+		// (atan(x) - x) / x^3 for |x| <= tan(pi / 8).
+		static inline float atan_poly(float z) noexcept(true)
+		{
+			return -3.33332865639427456e-01f + z * (1.99912377430301470e-01f + z * (-1.40241428418639721e-01f + z * 8.52049203588131769e-02f));
+		}
+
+		static inline double atan_poly(double z) noexcept(true)
+		{
+			return -3.33333333333333302e-01 + z * (1.99999999999955199e-01 + z * (-1.42857142846665094e-01 + z * (1.11111110152607566e-01 + z * (-9.09090457846998635e-02 + z * (7.69218320103293178e-02 + z * (-6.66451160690036516e-02 + z * (5.85815035763832411e-02 + z * (-5.08545736521348356e-02 + z * (3.92318764707550492e-02 + z * -1.91771488364568184e-02)))))))));
+		}
+
+		// (asin(x) - x) / x^3 for |x| <= 1 / 2.
+		static inline float asin_poly(float z) noexcept(true)
+		{
+			return 1.66666724147953052e-01f + z * (7.49885507260082078e-02f + z * (4.50013800699102521e-02f + z * (2.65545422061607420e-02f + z * 3.80850235610938532e-02f)));
+		}
+
+		static inline double asin_poly(double z) noexcept(true)
+		{
+			return 1.66666666666666486e-01 + z * (7.50000000002076344e-02 + z * (4.46428571034243875e-02 + z * (3.03819473670729814e-02 + z * (2.23720476321490155e-02 + z * (1.73552599532606190e-02 + z * (1.39296528921259577e-02 + z * (1.18754946641791828e-02 + z * (7.80294743329101207e-03 + z * (1.60355218897072165e-02 + z * (-1.07490647192698767e-02 + z * 2.81692293243325237e-02))))))))));
+		}
+
+		// pi / 2 split so that k * first is exact: the Cody-Waite reduction x - k * pi / 2 then keeps its low bits.
+		static inline void half_pi_parts(float& a, float& b, float& c) noexcept(true)
+		{
+			a = 1.5703125f;
+			b = 4.837512969970703125e-4f;
+			c = 7.54978995489188216e-8f;
+		}
+
+		static inline void half_pi_parts(double& a, double& b, double& c) noexcept(true)
+		{
+			a = 1.57079625129699707031;
+			b = 7.54978941586159635336e-8;
+			c = 5.39030285815811905290e-15;
+		}
+	}
+
+	namespace fast
+	{
+		// 1 / sqrt(x) for x > 0. rsqrtss is good to 12 bits and one Newton step doubles that. This shortens the latency of a
+		// lone call, but it is a scalar intrinsic: in loops the compiler would vectorize, precise_math's sqrtps and divps
+		// keep up better. Without SSE, a bit-level guess would need three Newton steps and loses to the plain divide.
+		static inline float rsqrt(float x) noexcept(true)
+		{
+#if defined(NOOB_SIMD_SSE2)
+			const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+			return y * (1.5f - 0.5f * x * y * y);
+#else
+			return 1.0f / std::sqrt(x);
+#endif
+		}
+
+		// The same goes for doubles, which have no estimate instruction at all.
+		static inline double rsqrt(double x) noexcept(true)
+		{
+			return 1.0 / std::sqrt(x);
+		}
+
+		template <typename T>
+			static inline void sincos(T x, T& s, T& c) noexcept(true)
+			{
+				const T two_over_pi = 0.636619772367581343076;
+				const T half = 0.5;
+				const T one = 1.0;
+				// Nearest multiple of pi / 2, rounded with a truncating conversion so fast-math flags can't fold it away.
+				const int64_t q = static_cast<int64_t>(x * two_over_pi + std::copysign(half, x));
+				const T k = static_cast<T>(q);
+				T a, b, d;
+				detail::half_pi_parts(a, b, d);
+				const T r = ((x - k * a) - k * b) - k * d;
+				const T z = r * r;
+				const T sr = r + r * z * detail::sin_poly(z);
+				const T cr = one - half * z + z * z * detail::cos_poly(z);
+				// Quadrant q: sin(x) is sin(r), cos(r), -sin(r), -cos(r) for q mod 4 = 0..3, and cos(x) the next one along.
+				// The quadrant picks are weights of exactly 0 and 1 and signs of exactly 1 and -1, giving the same results as
+				// selects, but without the branches compilers turn scalar selects into (the quadrant is rarely predictable).
+				const T w = static_cast<T>(q & 1);
+				const T sv = sr * (one - w) + cr * w;
+				const T cv = cr * (one - w) + sr * w;
+				s = sv * (one - static_cast<T>(q & 2));
+				c = cv * (one - static_cast<T>((q + 1) & 2));
+			}
+
+		template <typename T>
+			static inline T sin(T x) noexcept(true)
+			{
+				T s, c;
+				sincos(x, s, c);
+				return s;
+			}
+
+		template <typename T>
+			static inline T cos(T x) noexcept(true)
+			{
+				T s, c;
+				sincos(x, s, c);
+				return c;
+			}
+
+		// As std::atan2, signed zeros included; atan2(0, 0) is 0.
+		template <typename T>
+			static inline T atan2(T y, T x) noexcept(true)
+			{
+				const T quarter_pi = 0.785398163397448309616;
+				const T half_pi = 1.57079632679489661923;
+				const T pi = 3.14159265358979323846;
+				const T tan_eighth_pi = 0.414213562373095048802;
+				const T ax = std::fabs(x), ay = std::fabs(y);
+				const T lo = std::min(ax, ay), hi = std::max(ax, ay);
+				// Ratios above tan(pi / 8) fold down through atan(t) = pi / 4 + atan((t - 1) / (t + 1)), with one divide either way.
+				const bool fold = lo > tan_eighth_pi * hi;
+				const T num = fold ? lo - hi : lo;
+				const T den = fold ? lo + hi : hi;
+				const T t = num / (den == static_cast<T>(0.0) ? static_cast<T>(1.0) : den);
+				const T z = t * t;
+				T r = t + t * z * detail::atan_poly(z) + (fold ? quarter_pi : static_cast<T>(0.0));
+				r = ay > ax ? half_pi - r : r;
+				r = std::signbit(x) ? pi - r : r;
+				return std::copysign(r, y);
+			}
+
+		// NaN outside [-1, 1], like std::acos.
+		template <typename T>
+			static inline T acos(T x) noexcept(true)
+			{
+				const T half_pi = 1.57079632679489661923;
+				const T pi = 3.14159265358979323846;
+				const T half = 0.5;
+				const T a = std::fabs(x);
+				// Near 1, acos(a) = 2 * asin(sqrt((1 - a) / 2)), which keeps the polynomial's argument within 1 / 2.
+				const bool high = a > half;
+				const T z = high ? (static_cast<T>(1.0) - a) * half : a * a;
+				const T s = high ? std::sqrt(z) : a;
+				const T p = s + s * z * detail::asin_poly(z);
+				const T r = high ? p + p : half_pi - p;
+				return x < static_cast<T>(0.0) ? pi - r : r;
+			}
+	}
+
+	// Math policies for the functions that take one.
+	struct precise_math
+	{
+		template <typename T>
+			static T rsqrt(T x) noexcept(true)
+			{
+				return static_cast<T>(1.0) / std::sqrt(x);
+			}
+
+		template <typename T>
+			static void sincos(T x, T& s, T& c) noexcept(true)
+			{
+				s = std::sin(x);
+				c = std::cos(x);
+			}
+
+		template <typename T>
+			static T sin(T x) noexcept(true)
+			{
+				return std::sin(x);
+			}
+
+		template <typename T>
+			static T atan2(T y, T x) noexcept(true)
+			{
+				return std::atan2(y, x);
+			}
+
+		template <typename T>
+			static T acos(T x) noexcept(true)
+			{
+				return std::acos(x);
+			}
+	};
+
+	struct fast_math
+	{
+		template <typename T>
+			static T rsqrt(T x) noexcept(true)
+			{
+				return fast::rsqrt(x);
+			}
+
+		template <typename T>
+			static void sincos(T x, T& s, T& c) noexcept(true)
+			{
+				fast::sincos(x, s, c);
+			}
+
+		template <typename T>
+			static T sin(T x) noexcept(true)
+			{
+				return fast::sin(x);
+			}
+
+		template <typename T>
+			static T atan2(T y, T x) noexcept(true)
+			{
+				return fast::atan2(y, x);
+			}
+
+		template <typename T>
+			static T acos(T x) noexcept(true)
+			{
+				return fast::acos(x);
+			}
+	};
+
+#if defined(NOOB_FAST_MATH)
+	typedef fast_math default_math;
+#else
+	typedef precise_math default_math;
+#endif
+}
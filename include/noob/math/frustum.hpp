@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	enum class cull_result : uint8_t
+	{
+		OUTSIDE = 0, INTERSECTING = 1, INSIDE = 2
+	};
+
+	// Six inward-facing normalized planes, in the order left, right, bottom, top, near, far.
+	template <typename T>
+		class frustum
+		{
+			public:
+				// Gribb/Hartmann extraction. Pass projection * view for world-space planes, or projection alone for view-space ones.
+				// Expects an OpenGL-style clip volume (-w <= z <= w), as produced by perspective() and ortho().
+				void from_mat4(const mat4_type<T>& view_proj) noexcept(true)
+				{
+					const T* m = &view_proj.m[0];
+					for (uint32_t i = 0; i < 3; ++i)
+					{
+						// Row 3 plus and minus row i.
+						planes[i * 2] = noob::plane<T>(noob::vec3_type<T>(m[3] + m[i], m[7] + m[4 + i], m[11] + m[8 + i]), m[15] + m[12 + i]);
+						planes[i * 2 + 1] = noob::plane<T>(noob::vec3_type<T>(m[3] - m[i], m[7] - m[4 + i], m[11] - m[8 + i]), m[15] - m[12 + i]);
+					}
+					for (noob::plane<T>& p : planes)
+					{
+						p.normalize();
+					}
+				}
+
+				const noob::plane<T>& get_plane(uint32_t i) const noexcept(true)
+				{
+					return planes[i];
+				}
+
+				bool contains(const noob::vec3_type<T>& p) const noexcept(true)
+				{
+					for (const noob::plane<T>& pl : planes)
+					{
+						if (pl.signed_distance(p) < 0.0) return false;
+					}
+					return true;
+				}
+
+				noob::cull_result classify(const noob::bbox_type<T>& b) const noexcept(true)
+				{
+					uint8_t hint = 0;
+					return classify(b, hint);
+				}
+
+				// Plane-coherent test: starts with the plane that rejected this box last time and stores the rejecting plane back into hint.
+				// Objects that stay outside across frames are usually rejected by the first plane tested.
+				noob::cull_result classify(const noob::bbox_type<T>& b, uint8_t& hint) const noexcept(true)
+				{
+					const noob::vec3_type<T> c = (b.min + b.max) * static_cast<T>(0.5);
+					const noob::vec3_type<T> e = (b.max - b.min) * static_cast<T>(0.5);
+					noob::cull_result results = noob::cull_result::INSIDE;
+					uint32_t k = hint < 6 ? hint : 0;
+					for (uint32_t tested = 0; tested < 6; ++tested)
+					{
+						const noob::vec3_type<T> n = planes[k].normal();
+						const T dist = planes[k].signed_distance(c);
+						const T radius = std::fabs(n.v[0]) * e.v[0] + std::fabs(n.v[1]) * e.v[1] + std::fabs(n.v[2]) * e.v[2];
+						if (dist + radius < 0.0)
+						{
+							hint = static_cast<uint8_t>(k);
+							return noob::cull_result::OUTSIDE;
+						}
+						if (dist - radius < 0.0) results = noob::cull_result::INTERSECTING;
+						k = (k == 5) ? 0 : k + 1;
+					}
+					return results;
+				}
+
+			protected:
+				std::array<noob::plane<T>, 6> planes;
+		};
+
+	// Classifies every box against the frustum and returns how many are not OUTSIDE. Branch-free over all six planes,
+	// using the center/extent form of the box so each plane costs two dot products per lane.
+	template <typename T>
+		static size_t cull(const noob::frustum<T>& f, const noob::bbox_soa<T>& boxes, noob::cull_result* results) noexcept(true)
+		{
+			T nx[6], ny[6], nz[6], d[6], ax[6], ay[6], az[6];
+			for (uint32_t k = 0; k < 6; ++k)
+			{
+				const noob::vec3_type<T> n = f.get_plane(k).normal();
+				nx[k] = n.v[0];
+				ny[k] = n.v[1];
+				nz[k] = n.v[2];
+				d[k] = f.get_plane(k).offset();
+				ax[k] = std::fabs(n.v[0]);
+				ay[k] = std::fabs(n.v[1]);
+				az[k] = std::fabs(n.v[2]);
+			}
+
+			const T* min_x = boxes.min.x.data(); const T* min_y = boxes.min.y.data(); const T* min_z = boxes.min.z.data();
+			const T* max_x = boxes.max.x.data(); const T* max_y = boxes.max.y.data(); const T* max_z = boxes.max.z.data();
+			uint8_t* r = reinterpret_cast<uint8_t*>(results);
+			const size_t count = boxes.size();
+			size_t visible = 0;
+
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T cx = (min_x[i] + max_x[i]) * static_cast<T>(0.5), ex = (max_x[i] - min_x[i]) * static_cast<T>(0.5);
+				const T cy = (min_y[i] + max_y[i]) * static_cast<T>(0.5), ey = (max_y[i] - min_y[i]) * static_cast<T>(0.5);
+				const T cz = (min_z[i] + max_z[i]) * static_cast<T>(0.5), ez = (max_z[i] - min_z[i]) * static_cast<T>(0.5);
+				uint32_t outside = 0, straddling = 0;
+				for (uint32_t k = 0; k < 6; ++k)
+				{
+					const T dist = nx[k] * cx + ny[k] * cy + nz[k] * cz + d[k];
+					const T radius = ax[k] * ex + ay[k] * ey + az[k] * ez;
+					outside |= (dist + radius < 0.0);
+					straddling |= (dist - radius < 0.0);
+				}
+				// OUTSIDE = 0, INTERSECTING = 1, INSIDE = 2
+				const uint32_t res = (1 - outside) * (2 - straddling);
+				r[i] = static_cast<uint8_t>(res);
+				visible += (1 - outside);
+			}
+			return visible;
+		}
+
+	// Plane-coherent batch version: hints holds one byte per box, carried across frames (zero-initialize it the first time).
+	// Pays off when most boxes are rejected; for mostly visible scenes the branch-free cull() above is faster.
+	template <typename T>
+		static size_t cull(const noob::frustum<T>& f, const noob::bbox_soa<T>& boxes, uint8_t* hints, noob::cull_result* results) noexcept(true)
+		{
+			const size_t count = boxes.size();
+			size_t visible = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = f.classify(boxes.get(i), hints[i]);
+				visible += (results[i] != noob::cull_result::OUTSIDE);
+			}
+			return visible;
+		}
+}
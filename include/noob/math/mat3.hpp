@@ -14,25 +14,14 @@ namespace noob
 			mat3_type() noexcept(true) = default;
 
 			/* note: entered in COLUMNS */
-			mat3_type(T a, T b, T c, T d, T e, T f, T g, T h, T i) noexcept(true)
-			{
-				m[0] = a;
-				m[1] = b;
-				m[2] = c;
-				m[3] = d;
-				m[4] = e;
-				m[5] = f;
-				m[6] = g;
-				m[7] = h;
-				m[8] = i;
-			}
+			constexpr mat3_type(T a, T b, T c, T d, T e, T f, T g, T h, T i) noexcept(true) : m{{a, b, c, d, e, f, g, h, i}} {}
 
 			T& operator[](uint32_t x) noexcept(true)
 			{
 				return m[x];
 			}
 
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return m[x];
 			}
@@ -3,6 +3,7 @@
 #include <array>
 
 #include "vec4.hpp"
+#include "simd.hpp"
 
 namespace noob
 {
@@ -16,40 +17,18 @@ namespace noob
 		{
 			mat4_type() noexcept(true) = default;
 
-			mat4_type(T a, T b, T c, T d, T e, T f, T g, T h, T i, T j, T k, T l, T mm, T n, T o, T p) noexcept(true)
-			{
-				m[0] = a;
-				m[1] = b;
-				m[2] = c;
-				m[3] = d;
-				m[4] = e;
-				m[5] = f;
-				m[6] = g;
-				m[7] = h;
-				m[8] = i;
-				m[9] = j;
-				m[10] = k;
-				m[11] = l;
-				m[12] = mm;
-				m[13] = n;
-				m[14] = o;
-				m[15] = p;
-			}
+			constexpr mat4_type(T a, T b, T c, T d, T e, T f, T g, T h, T i, T j, T k, T l, T mm, T n, T o, T p) noexcept(true) : m{{a, b, c, d, e, f, g, h, i, j, k, l, mm, n, o, p}} {}
 
-			mat4_type(const std::array<T,16>& mm) noexcept(true)
-			{
-				for (uint32_t i = 0; i < 16; i++)
-				{
-					m[i] = mm[i];
-				}
-			}
+			constexpr mat4_type(const std::array<T,16>& mm) noexcept(true) : m(mm) {}
+
+			mat4_type(const mat4_type&) noexcept(true) = default;
 
 			T& operator[](uint32_t x) noexcept(true)
 			{
 				return m[x];
 			}
 
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return m[x];
 			}
@@ -82,8 +61,6 @@ namespace noob
 			mat4_type operator*(const mat4_type& rhs) const noexcept(true)
 			{
 				mat4_type r;
-				std::fill_n(&r.m[0], 16, 0.0);
-
 				uint32_t r_index = 0;
 				for (uint32_t col = 0; col < 4; col++)
 				{
@@ -101,15 +78,115 @@ namespace noob
 				return r;
 			}
 
-			mat4_type& operator=(const mat4_type& rhs) noexcept(true)
+			mat4_type& operator=(const mat4_type&) noexcept(true) = default;
+
+			std::array<T, 16> m;
+		};
+
+	// SIMD specializations: each result column is a linear combination of our columns weighted by the matching rhs column,
+	// summed in the same order as the scalar loop above so results agree with it.
+#if defined(NOOB_SIMD_SSE2)
+	template <>
+		inline vec4_type<float> mat4_type<float>::operator*(const vec4_type<float>& rhs) const noexcept(true)
+		{
+			__m128 r = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(rhs.v[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(rhs.v[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(rhs.v[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(rhs.v[3])));
+			vec4_type<float> results;
+			_mm_storeu_ps(&results.v[0], r);
+			return results;
+		}
+
+	template <>
+		inline mat4_type<float> mat4_type<float>::operator*(const mat4_type<float>& rhs) const noexcept(true)
+		{
+			const __m128 c0 = _mm_loadu_ps(&m[0]);
+			const __m128 c1 = _mm_loadu_ps(&m[4]);
+			const __m128 c2 = _mm_loadu_ps(&m[8]);
+			const __m128 c3 = _mm_loadu_ps(&m[12]);
+			mat4_type<float> r;
+			for (uint32_t col = 0; col < 16; col += 4)
 			{
-				for (uint32_t i = 0; i < 16; i++)
+				__m128 sum = _mm_mul_ps(c0, _mm_set1_ps(rhs.m[col]));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(rhs.m[col + 1])));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(rhs.m[col + 2])));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(rhs.m[col + 3])));
+				_mm_storeu_ps(&r.m[col], sum);
+			}
+			return r;
+		}
+#endif
+
+#if defined(NOOB_SIMD_AVX)
+	// A whole column of doubles fits in one AVX register.
+	template <>
+		inline vec4_type<double> mat4_type<double>::operator*(const vec4_type<double>& rhs) const noexcept(true)
+		{
+			__m256d r = _mm256_mul_pd(_mm256_loadu_pd(&m[0]), _mm256_set1_pd(rhs.v[0]));
+			r = _mm256_add_pd(r, _mm256_mul_pd(_mm256_loadu_pd(&m[4]), _mm256_set1_pd(rhs.v[1])));
+			r = _mm256_add_pd(r, _mm256_mul_pd(_mm256_loadu_pd(&m[8]), _mm256_set1_pd(rhs.v[2])));
+			r = _mm256_add_pd(r, _mm256_mul_pd(_mm256_loadu_pd(&m[12]), _mm256_set1_pd(rhs.v[3])));
+			vec4_type<double> results;
+			_mm256_storeu_pd(&results.v[0], r);
+			return results;
+		}
+
+	template <>
+		inline mat4_type<double> mat4_type<double>::operator*(const mat4_type<double>& rhs) const noexcept(true)
+		{
+			const __m256d c0 = _mm256_loadu_pd(&m[0]);
+			const __m256d c1 = _mm256_loadu_pd(&m[4]);
+			const __m256d c2 = _mm256_loadu_pd(&m[8]);
+			const __m256d c3 = _mm256_loadu_pd(&m[12]);
+			mat4_type<double> r;
+			for (uint32_t col = 0; col < 16; col += 4)
+			{
+				__m256d sum = _mm256_mul_pd(c0, _mm256_set1_pd(rhs.m[col]));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(c1, _mm256_set1_pd(rhs.m[col + 1])));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(c2, _mm256_set1_pd(rhs.m[col + 2])));
+				sum = _mm256_add_pd(sum, _mm256_mul_pd(c3, _mm256_set1_pd(rhs.m[col + 3])));
+				_mm256_storeu_pd(&r.m[col], sum);
+			}
+			return r;
+		}
+#elif defined(NOOB_SIMD_SSE2)
+	// Without AVX each column of doubles is handled as two halves (rows 0-1 and rows 2-3).
+	template <>
+		inline vec4_type<double> mat4_type<double>::operator*(const vec4_type<double>& rhs) const noexcept(true)
+		{
+			vec4_type<double> results;
+			for (uint32_t row = 0; row < 4; row += 2)
+			{
+				__m128d r = _mm_mul_pd(_mm_loadu_pd(&m[row]), _mm_set1_pd(rhs.v[0]));
+				r = _mm_add_pd(r, _mm_mul_pd(_mm_loadu_pd(&m[4 + row]), _mm_set1_pd(rhs.v[1])));
+				r = _mm_add_pd(r, _mm_mul_pd(_mm_loadu_pd(&m[8 + row]), _mm_set1_pd(rhs.v[2])));
+				r = _mm_add_pd(r, _mm_mul_pd(_mm_loadu_pd(&m[12 + row]), _mm_set1_pd(rhs.v[3])));
+				_mm_storeu_pd(&results.v[row], r);
+			}
+			return results;
+		}
+
+	template <>
+		inline mat4_type<double> mat4_type<double>::operator*(const mat4_type<double>& rhs) const noexcept(true)
+		{
+			mat4_type<double> r;
+			for (uint32_t row = 0; row < 4; row += 2)
+			{
+				const __m128d c0 = _mm_loadu_pd(&m[row]);
+				const __m128d c1 = _mm_loadu_pd(&m[4 + row]);
+				const __m128d c2 = _mm_loadu_pd(&m[8 + row]);
+				const __m128d c3 = _mm_loadu_pd(&m[12 + row]);
+				for (uint32_t col = 0; col < 16; col += 4)
 				{
-					m[i] = rhs.m[i];
+					__m128d sum = _mm_mul_pd(c0, _mm_set1_pd(rhs.m[col]));
+					sum = _mm_add_pd(sum, _mm_mul_pd(c1, _mm_set1_pd(rhs.m[col + 1])));
+					sum = _mm_add_pd(sum, _mm_mul_pd(c2, _mm_set1_pd(rhs.m[col + 2])));
+					sum = _mm_add_pd(sum, _mm_mul_pd(c3, _mm_set1_pd(rhs.m[col + 3])));
+					_mm_storeu_pd(&r.m[col + row], sum);
 				}
-				return *this;
 			}
-
-			std::array<T, 16> m;
-		};
+			return r;
+		}
+#endif
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "mat4.hpp"
+
+namespace noob
+{
+	// Structure-of-arrays storage for mat4s: m[k] holds element k (same column-major numbering as mat4_type) of every matrix,
+	// so batch functions can process one matrix per SIMD lane.
+	template <typename T>
+		struct mat4_soa
+		{
+			size_t size() const noexcept(true)
+			{
+				return m[0].size();
+			}
+
+			void resize(size_t n)
+			{
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					m[k].resize(n);
+				}
+			}
+
+			void clear() noexcept(true)
+			{
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					m[k].clear();
+				}
+			}
+
+			mat4_type<T> get(size_t i) const noexcept(true)
+			{
+				mat4_type<T> results;
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					results.m[k] = m[k][i];
+				}
+				return results;
+			}
+
+			void set(size_t i, const mat4_type<T>& arg) noexcept(true)
+			{
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					m[k][i] = arg.m[k];
+				}
+			}
+
+			// AoS -> SoA
+			void gather(const mat4_type<T>* src, size_t count)
+			{
+				resize(count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					set(i, src[i]);
+				}
+			}
+
+			// SoA -> AoS. dst must hold size() elements.
+			void scatter(mat4_type<T>* dst) const noexcept(true)
+			{
+				const size_t count = size();
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[i] = get(i);
+				}
+			}
+
+			std::array<std::vector<T>, 16> m;
+		};
+}
@@ -2,12 +2,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 
-#define GLM_FORCE_CXX98
-#include <glm/gtc/type_ptr.hpp>
-#include <glm/gtc/quaternion.hpp>
 #include <btBulletDynamicsCommon.h>
 /*
 #ifdef NOOB_PLATFORM_LINUX
@@ -41,6 +40,14 @@
 #include "mat4.hpp"
 #include "plane.hpp"
 #include "bbox.hpp"
+#include "ray.hpp"
+#include "vec3_soa.hpp"
+#include "mat4_soa.hpp"
+#include "versor_soa.hpp"
+#include "bbox_soa.hpp"
+#include "simd.hpp"
+#include "fast_math.hpp"
+#include "vec_expr.hpp"
 
 namespace noob
 {
@@ -50,6 +57,7 @@ namespace noob
 	typedef versor_type<float> versorf;
 	typedef mat3_type<float> mat3f;
 	typedef mat4_type<float> mat4f;
+	typedef ray_type<float> rayf;
 
 	typedef vec2_type<double> vec2d;
 	typedef vec3_type<double> vec3d;
@@ -57,6 +65,7 @@ namespace noob
 	typedef versor_type<double> versord;
 	typedef mat3_type<double> mat3d;
 	typedef mat4_type<double> mat4d;
+	typedef ray_type<double> rayd;
 
 	typedef vec2_type<uint32_t> vec2ui;
 	typedef vec3_type<uint32_t> vec3ui;
@@ -70,32 +79,32 @@ namespace noob
 	/////////////////////////
 	//TODO: Replace with expression templates...
 	template<typename From, typename To>
-		static noob::vec2_type<To> convert(const noob::vec2_type<From> Vec)
+		static constexpr noob::vec2_type<To> convert(const noob::vec2_type<From> Vec)
 		{
 			return noob::vec2_type<To>(static_cast<To>(Vec[0]), static_cast<To>(Vec[1]));
 		}
 
 	template<typename From, typename To>
-		static noob::vec3_type<To> convert(const noob::vec3_type<From> Vec)
+		static constexpr noob::vec3_type<To> convert(const noob::vec3_type<From> Vec)
 		{
 			return noob::vec3_type<To>(static_cast<To>(Vec[0]), static_cast<To>(Vec[1]), static_cast<To>(Vec[2]));
 		}
 
 	template<typename From, typename To>
-		static noob::vec4_type<To> convert(const noob::vec4_type<From> Vec)
+		static constexpr noob::vec4_type<To> convert(const noob::vec4_type<From> Vec)
 		{
 			return noob::vec4_type<To>(static_cast<To>(Vec[0]), static_cast<To>(Vec[1]), static_cast<To>(Vec[2]), static_cast<To>(Vec[3]));
 		}
 
 	template<typename From, typename To>
-		static noob::versor_type<To> convert(const noob::versor_type<From> Versor)
+		static constexpr noob::versor_type<To> convert(const noob::versor_type<From> Versor)
 		{
 			return noob::versor_type<To>(static_cast<To>(Versor[0]), static_cast<To>(Versor[1]), static_cast<To>(Versor[2]), static_cast<To>(Versor[3]));
 		}
 
 
 	template<typename From, typename To>
-		static noob::mat3_type<To> convert(const noob::mat3_type<From> Mat)
+		static constexpr noob::mat3_type<To> convert(const noob::mat3_type<From> Mat)
 		{
 			return noob::mat3_type<To>(static_cast<To>(Mat[0]), static_cast<To>(Mat[1]), static_cast<To>(Mat[2]), static_cast<To>(Mat[3]), static_cast<To>(Mat[4]), static_cast<To>(Mat[5]), static_cast<To>(Mat[6]), static_cast<To>(Mat[7]), static_cast<To>(Mat[8]));
 		}
@@ -103,7 +112,7 @@ namespace noob
 	// Comment: Yuck. Yuck. YUCK!
 	// Followup: This kind of code happens to be why people actually *want* to look up horrible, miserable things such as C++ template metaprogramming
 	template<typename From, typename To>
-		static noob::mat4_type<To> convert(const noob::mat4_type<From> Mat)
+		static constexpr noob::mat4_type<To> convert(const noob::mat4_type<From> Mat)
 		{
 			return noob::mat4_type<To>(static_cast<To>(Mat[0]), static_cast<To>(Mat[1]), static_cast<To>(Mat[2]), static_cast<To>(Mat[3]), static_cast<To>(Mat[4]), static_cast<To>(Mat[5]), static_cast<To>(Mat[6]), static_cast<To>(Mat[7]), static_cast<To>(Mat[8]), static_cast<To>(Mat[9]), static_cast<To>(Mat[10]), static_cast<To>(Mat[11]), static_cast<To>(Mat[12]), static_cast<To>(Mat[13]), static_cast<To>(Mat[14]), static_cast<To>(Mat[15]));
 		}
@@ -188,13 +197,13 @@ namespace noob
 	// CURRENT LOCATION FOR MIN/MAX FUNCTIONS
 	//////////////////////////////////////////
 	template <typename T>
-		static vec2_type<T> min(const noob::vec2_type<T> A, const noob::vec2_type<T> B)
+		static constexpr vec2_type<T> min(const noob::vec2_type<T> A, const noob::vec2_type<T> B)
 		{
 			return noob::vec2_type<T>(std::min(A[0], B[0]), std::min(A[1], B[1]));
 		}
 
 	template <typename T>
-		static vec2_type<T> max(const noob::vec2_type<T> A, const noob::vec2_type<T> B)
+		static constexpr vec2_type<T> max(const noob::vec2_type<T> A, const noob::vec2_type<T> B)
 		{
 			return noob::vec2_type<T>(std::max(A[0], B[0]), std::max(A[1], B[1]));
 		}
@@ -206,23 +215,15 @@ namespace noob
 	// CONVERSION UTILITY FUNCTIONS:
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename T>
-		static vec3_type<T> vec3_from_vec4(const vec4_type<T>& vv) noexcept(true)
+		static constexpr vec3_type<T> vec3_from_vec4(const vec4_type<T>& vv) noexcept(true)
 		{
-			noob::vec3_type<T> v;
-			v.v[0] = vv.v[0];
-			v.v[1] = vv.v[1];
-			v.v[2] = vv.v[2];
-			return v;
+			return noob::vec3_type<T>(vv.v[0], vv.v[1], vv.v[2]);
 		}
 
 	template <typename T>
-		static vec3_type<T> vec3_from_array(const std::array<T, 3>& a) noexcept(true)
+		static constexpr vec3_type<T> vec3_from_array(const std::array<T, 3>& a) noexcept(true)
 		{
-			noob::vec3_type<T> v;
-			v.v[0] = a[0];
-			v.v[1] = a[1];
-			v.v[2] = a[2];
-			return v;
+			return noob::vec3_type<T>(a[0], a[1], a[2]);
 		}
 
 	static vec3f vec3f_from_bullet(const btVector3& btVec) noexcept(true)
@@ -259,19 +260,20 @@ namespace noob
 		return results;
 	}
 
+	// versor_type is w first; btQuaternion and Eigen::Quaternion store x first, so these converters reorder.
 	static versorf versorf_from_bullet(const btQuaternion & arg) noexcept(true)
 	{
 		noob::versorf qq;
-		qq.q[0] = arg[0];
-		qq.q[1] = arg[1];
-		qq.q[2] = arg[2];
-		qq.q[3] = arg[3];
+		qq.q[0] = arg.w();
+		qq.q[1] = arg.x();
+		qq.q[2] = arg.y();
+		qq.q[3] = arg.z();
 		return qq;
 	}
 
 	static btQuaternion versorf_to_bullet(const noob::versorf & arg) noexcept(true)
 	{
-		btQuaternion results(arg.q[0], arg.q[1], arg.q[2], arg[3]);
+		btQuaternion results(arg.q[1], arg.q[2], arg.q[3], arg.q[0]);
 		return results;
 	}
 
@@ -279,10 +281,10 @@ namespace noob
 	static versorf versorf_from_eigen(const Eigen::Quaternion<float>& arg) noexcept(true)
 	{
 		noob::versorf qq;
-		qq.q[0] = arg.x();
-		qq.q[1] = arg.y();
-		qq.q[2] = arg.z();
-		qq.q[3] = arg.w();
+		qq.q[0] = arg.w();
+		qq.q[1] = arg.x();
+		qq.q[2] = arg.y();
+		qq.q[3] = arg.z();
 		return qq;
 	}
 
@@ -297,7 +299,7 @@ namespace noob
 	// VECTOR FUNCTIONS:
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename T>
-		static noob::vec3_type<T> negate(const noob::vec3_type<T>& arg) noexcept(true)
+		static constexpr noob::vec3_type<T> negate(const noob::vec3_type<T>& arg) noexcept(true)
 		{
 			return arg * -1.0;
 		}
@@ -313,7 +315,7 @@ namespace noob
 		}
 
 	template <typename T>
-		static float length_squared(const vec3_type<T> v) noexcept(true)
+		static constexpr float length_squared(const vec3_type<T> v) noexcept(true)
 		{
 			return v.v[0] * v.v[0] + v.v[1] * v.v[1] + v.v[2] * v.v[2];
 		}
@@ -324,29 +326,29 @@ namespace noob
 			return sqrt(v.v[0] * v.v[0] + v.v[1] * v.v[1] + v.v[2] * v.v[2]);
 		}
 
-	template <typename T>
-		static vec3_type<T> normalize(const vec3_type<T> v) noexcept(true)
+	// Functions taking a math policy M use the standard library by default (fast_math.hpp has the details), eg:
+	//	noob::normalize(v, noob::fast_math());
+
+	template <typename T, typename M = noob::default_math>
+		static vec3_type<T> normalize(const vec3_type<T> v, M = M()) noexcept(true)
 		{
-			vec3_type<T> vb;
-			float len = length(v);
-			if (0.0 == len)
+			const T len_sq = v.v[0] * v.v[0] + v.v[1] * v.v[1] + v.v[2] * v.v[2];
+			if (static_cast<T>(0.0) == len_sq)
 			{
 				return vec3_type<T>(0.0, 0.0, 0.0);
 			}
-			vb.v[0] = v.v[0] / len;
-			vb.v[1] = v.v[1] / len;
-			vb.v[2] = v.v[2] / len;
-			return vb;
+			const T inv_len = M::rsqrt(len_sq);
+			return vec3_type<T>(v.v[0] * inv_len, v.v[1] * inv_len, v.v[2] * inv_len);
 		}
 
 	template <typename T>
-		static float dot(const vec3_type<T>& a, const vec3_type<T>& b) noexcept(true)
+		static constexpr float dot(const vec3_type<T>& a, const vec3_type<T>& b) noexcept(true)
 		{
 			return a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2];
 		}
 
 	template <typename T>
-		static vec3_type<T> cross(const vec3_type<T>& a, const vec3_type<T>& b) noexcept(true)
+		static constexpr vec3_type<T> cross(const vec3_type<T>& a, const vec3_type<T>& b) noexcept(true)
 		{
 			float x = a.v[1] * b.v[2] - a.v[2] * b.v[1];
 			float y = a.v[2] * b.v[0] - a.v[0] * b.v[2];
@@ -355,7 +357,7 @@ namespace noob
 		}
 
 	template <typename T>
-		static float get_squared_dist(const vec3_type<T> from, const vec3_type<T> to) noexcept(true)
+		static constexpr float get_squared_dist(const vec3_type<T> from, const vec3_type<T> to) noexcept(true)
 		{
 			float x = (to.v[0] - from.v[0]) * (to.v[0] - from.v[0]);
 			float y = (to.v[1] - from.v[1]) * (to.v[1] - from.v[1]);
@@ -364,33 +366,214 @@ namespace noob
 		}
 
 	// Converts an un-normalized direction into a heading in degrees.
-	template <typename T>	
-		static float direction_to_heading(const vec3_type<T> d) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static float direction_to_heading(const vec3_type<T> d, M = M()) noexcept(true)
 		{
-			return atan2(-d.v[0], d.v[2]) * NOOB_ONE_RAD_IN_DEG;
+			return M::atan2(-d.v[0], d.v[2]) * NOOB_ONE_RAD_IN_DEG;
 		}
 
-	template <typename T>
-		static vec3_type<T> heading_to_direction(float degrees) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static vec3_type<T> heading_to_direction(float degrees, M = M()) noexcept(true)
 		{
-			float rad = degrees * NOOB_ONE_DEG_IN_RAD;
-			return vec3_type<T>(-sinf(rad), 0.0f, -cosf(rad));
+			T s, c;
+			M::sincos(static_cast<T>(degrees * NOOB_ONE_DEG_IN_RAD), s, c);
+			return vec3_type<T>(-s, 0.0, -c);
 		}
 
 	template <typename T>
-		static bool linearly_dependent(const noob::vec3_type<T>& a, const noob::vec3_type<T>& b, const noob::vec3_type<T>& c) noexcept(true)
+		static constexpr bool linearly_dependent(const noob::vec3_type<T>& a, const noob::vec3_type<T>& b, const noob::vec3_type<T>& c) noexcept(true)
 		{
 			// if (a cross b) dot c = 0
-			if (dot(cross(a, b), c) == 0.0) return true;
-			else return false;
+			return dot(cross(a, b), c) == 0.0;
 		}
 
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// QUATERNION FUNCTIONS:
+	// BATCH VECTOR FUNCTIONS:
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// These mirror the single-vector functions above over vec3_soa streams. The loops are branch-free over plain component
+	// arrays so the compiler vectorizes them at the target width (4 float lanes with SSE, 8 with AVX, 16 with AVX-512).
+	// Build with -fno-math-errno (or equivalent) so the square roots vectorize too.
+	// Outputs may be the same streams as the inputs (in-place), but must not partially overlap them.
+	template <typename T>
+		static void dot(const vec3_soa<T>& a, const vec3_soa<T>& b, T* results) noexcept(true)
+		{
+			const size_t count = a.size();
+			const T* ax = a.x.data(); const T* ay = a.y.data(); const T* az = a.z.data();
+			const T* bx = b.x.data(); const T* by = b.y.data(); const T* bz = b.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+			}
+		}
+
+	template <typename T>
+		static void cross(const vec3_soa<T>& a, const vec3_soa<T>& b, vec3_soa<T>& results)
+		{
+			const size_t count = a.size();
+			results.resize(count);
+			const T* ax = a.x.data(); const T* ay = a.y.data(); const T* az = a.z.data();
+			const T* bx = b.x.data(); const T* by = b.y.data(); const T* bz = b.z.data();
+			T* rx = results.x.data(); T* ry = results.y.data(); T* rz = results.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T x = ay[i] * bz[i] - az[i] * by[i];
+				const T y = az[i] * bx[i] - ax[i] * bz[i];
+				const T z = ax[i] * by[i] - ay[i] * bx[i];
+				rx[i] = x;
+				ry[i] = y;
+				rz[i] = z;
+			}
+		}
+
+	template <typename T>
+		static void length_squared(const vec3_soa<T>& a, T* results) noexcept(true)
+		{
+			dot(a, a, results);
+		}
+
+	template <typename T>
+		static void length(const vec3_soa<T>& a, T* results) noexcept(true)
+		{
+			const size_t count = a.size();
+			const T* ax = a.x.data(); const T* ay = a.y.data(); const T* az = a.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+			}
+		}
+
+	// Range form: normalizes elements [begin, end) only, into an already-sized results.
+	template <typename T>
+		static void normalize(const vec3_soa<T>& a, vec3_soa<T>& results, size_t begin, size_t end) noexcept(true)
+		{
+			const T* ax = a.x.data(); const T* ay = a.y.data(); const T* az = a.z.data();
+			T* rx = results.x.data(); T* ry = results.y.data(); T* rz = results.z.data();
+			NOOB_IVDEP
+			for (size_t i = begin; i < end; ++i)
+			{
+				// Clamping the length keeps the loop branch-free: a zero vector divides out to zero.
+				const T len = std::max(std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]), std::numeric_limits<T>::min());
+				rx[i] = ax[i] / len;
+				ry[i] = ay[i] / len;
+				rz[i] = az[i] / len;
+			}
+		}
 
+	// Zero-length vectors come out as zero, as with the single-vector version.
 	template <typename T>
-		static versor_type<T> normalize(const versor_type<T>& q) noexcept(true)
+		static void normalize(const vec3_soa<T>& a, vec3_soa<T>& results)
+		{
+			results.resize(a.size());
+			normalize(a, results, 0, a.size());
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Without -fno-math-errno compilers keep std::sqrt() a library call (it may set errno) and the loop above stays scalar,
+	// so float and double get explicit sqrtps/sqrtpd versions with the same clamp. They divide once and multiply by the
+	// reciprocal, which can differ from the template by an ulp.
+	static void normalize(const vec3_soa<float>& a, vec3_soa<float>& results, size_t begin, size_t end) noexcept(true)
+	{
+		const float* ax = a.x.data(); const float* ay = a.y.data(); const float* az = a.z.data();
+		float* rx = results.x.data(); float* ry = results.y.data(); float* rz = results.z.data();
+		size_t i = begin;
+#if defined(NOOB_SIMD_AVX)
+		const __m256 tiny8 = _mm256_set1_ps(std::numeric_limits<float>::min());
+		for (; i + 8 <= end; i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(ax + i), y = _mm256_loadu_ps(ay + i), z = _mm256_loadu_ps(az + i);
+			const __m256 len = _mm256_max_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z))), tiny8);
+			const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), len);
+			_mm256_storeu_ps(rx + i, _mm256_mul_ps(x, inv));
+			_mm256_storeu_ps(ry + i, _mm256_mul_ps(y, inv));
+			_mm256_storeu_ps(rz + i, _mm256_mul_ps(z, inv));
+		}
+#endif
+		const __m128 tiny = _mm_set1_ps(std::numeric_limits<float>::min());
+		for (; i + 4 <= end; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(ax + i), y = _mm_loadu_ps(ay + i), z = _mm_loadu_ps(az + i);
+			const __m128 len = _mm_max_ps(_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))), tiny);
+			const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), len);
+			_mm_storeu_ps(rx + i, _mm_mul_ps(x, inv));
+			_mm_storeu_ps(ry + i, _mm_mul_ps(y, inv));
+			_mm_storeu_ps(rz + i, _mm_mul_ps(z, inv));
+		}
+		noob::normalize<float>(a, results, i, end);
+	}
+
+	static void normalize(const vec3_soa<double>& a, vec3_soa<double>& results, size_t begin, size_t end) noexcept(true)
+	{
+		const double* ax = a.x.data(); const double* ay = a.y.data(); const double* az = a.z.data();
+		double* rx = results.x.data(); double* ry = results.y.data(); double* rz = results.z.data();
+		size_t i = begin;
+#if defined(NOOB_SIMD_AVX)
+		const __m256d tiny4 = _mm256_set1_pd(std::numeric_limits<double>::min());
+		for (; i + 4 <= end; i += 4)
+		{
+			const __m256d x = _mm256_loadu_pd(ax + i), y = _mm256_loadu_pd(ay + i), z = _mm256_loadu_pd(az + i);
+			const __m256d len = _mm256_max_pd(_mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z))), tiny4);
+			const __m256d inv = _mm256_div_pd(_mm256_set1_pd(1.0), len);
+			_mm256_storeu_pd(rx + i, _mm256_mul_pd(x, inv));
+			_mm256_storeu_pd(ry + i, _mm256_mul_pd(y, inv));
+			_mm256_storeu_pd(rz + i, _mm256_mul_pd(z, inv));
+		}
+#endif
+		const __m128d tiny = _mm_set1_pd(std::numeric_limits<double>::min());
+		for (; i + 2 <= end; i += 2)
+		{
+			const __m128d x = _mm_loadu_pd(ax + i), y = _mm_loadu_pd(ay + i), z = _mm_loadu_pd(az + i);
+			const __m128d len = _mm_max_pd(_mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)), _mm_mul_pd(z, z))), tiny);
+			const __m128d inv = _mm_div_pd(_mm_set1_pd(1.0), len);
+			_mm_storeu_pd(rx + i, _mm_mul_pd(x, inv));
+			_mm_storeu_pd(ry + i, _mm_mul_pd(y, inv));
+			_mm_storeu_pd(rz + i, _mm_mul_pd(z, inv));
+		}
+		noob::normalize<double>(a, results, i, end);
+	}
+#endif
+
+	template <typename T>
+		static void get_squared_dist(const vec3_soa<T>& from, const vec3_soa<T>& to, T* results) noexcept(true)
+		{
+			const size_t count = from.size();
+			const T* fx = from.x.data(); const T* fy = from.y.data(); const T* fz = from.z.data();
+			const T* tx = to.x.data(); const T* ty = to.y.data(); const T* tz = to.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T x = tx[i] - fx[i];
+				const T y = ty[i] - fy[i];
+				const T z = tz[i] - fz[i];
+				results[i] = x * x + y * y + z * z;
+			}
+		}
+
+	template <typename T>
+		static void lerp(const vec3_soa<T>& a, const vec3_soa<T>& b, T t, vec3_soa<T>& results)
+		{
+			const size_t count = a.size();
+			results.resize(count);
+			const T* ax = a.x.data(); const T* ay = a.y.data(); const T* az = a.z.data();
+			const T* bx = b.x.data(); const T* by = b.y.data(); const T* bz = b.z.data();
+			T* rx = results.x.data(); T* ry = results.y.data(); T* rz = results.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				rx[i] = ax[i] + (bx[i] - ax[i]) * t;
+				ry[i] = ay[i] + (by[i] - ay[i]) * t;
+				rz[i] = az[i] + (bz[i] - az[i]) * t;
+			}
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// QUATERNION FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template <typename T, typename M = noob::default_math>
+		static versor_type<T> normalize(const versor_type<T>& q, M = M()) noexcept(true)
 		{
 			// norm(q) = q / magnitude (q)
 			// magnitude (q) = sqrt (w*w + x*x...)
@@ -403,18 +586,17 @@ namespace noob
 			{
 				return q;
 			}
-			float mag = sqrt(sum);
-			return qq / mag;
+			return qq * static_cast<T>(M::rsqrt(sum));
 		}
 
 	template <typename T>
-		static float dot(const versor_type<T>& q, const versor_type<T>& r) noexcept(true)
+		static constexpr float dot(const versor_type<T>& q, const versor_type<T>& r) noexcept(true)
 		{
 			return q.q[0] * r.q[0] + q.q[1] * r.q[1] + q.q[2] * r.q[2] + q.q[3] * r.q[3];
 		}
 
-	template <typename T>
-		static versor_type<T> slerp(const versor_type<T>& q, const versor_type<T>& r, float t) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static versor_type<T> slerp(const versor_type<T>& q, const versor_type<T>& r, float t, M = M()) noexcept(true)
 		{
 			versor_type<T> temp_q(q);
 			// angle between q0-q1
@@ -449,9 +631,9 @@ namespace noob
 				}
 				return result;
 			}
-			float half_theta = acos(cos_half_theta);
-			float a = sin((1.0f - t) * half_theta) / sin_half_theta;
-			float b = sin(t * half_theta) / sin_half_theta;
+			float half_theta = M::acos(cos_half_theta);
+			float a = M::sin((1.0f - t) * half_theta) / sin_half_theta;
+			float b = M::sin(t * half_theta) / sin_half_theta;
 			for (int i = 0; i < 4; i++)
 			{
 				result.q[i] = temp_q.q[i] * a + r.q[i] * b;
@@ -459,46 +641,83 @@ namespace noob
 			return result;
 		}
 
+	// Normalized lerp along the shorter arc. Not constant speed, but close enough for small angles and much cheaper than slerp.
+	template <typename T>
+		static versor_type<T> nlerp(const versor_type<T>& q, const versor_type<T>& r, T t) noexcept(true)
+		{
+			const T wa = static_cast<T>(1.0) - t;
+			const T wb = dot(q, r) < 0.0 ? -t : t;
+			versor_type<T> result;
+			T len_sq = 0.0;
+			for (int i = 0; i < 4; ++i)
+			{
+				result.q[i] = q.q[i] * wa + r.q[i] * wb;
+				len_sq += result.q[i] * result.q[i];
+			}
+			return result * (static_cast<T>(1.0) / std::sqrt(len_sq));
+		}
+
+	// Rotation of a matrix whose upper 3x3 is orthonormal, w first. Breaking change: the old glm path returned x first
+	// (glm::quat[0] is x); callers that reordered the result by hand must stop doing so. Divides by the largest of 4w^2, 4x^2, 4y^2 and 4z^2 (read
+	// off the diagonal), so it stays accurate for every angle. Use rotation_from_mat4() when the matrix may be scaled.
 	template <typename T>
-		static versor_type<T> versor_from_mat4(const mat4_type<T>& m) noexcept(true)
+		static versor_type<T> versor_from_mat4(const mat4_type<T>& mat) noexcept(true)
 		{
-			// Eigen::Map<const Eigen::Matrix4f> mat_map(&m.m[0]);
-			// const Eigen::Quaternion<float> vv(mat_map); //Eigen::Matrix4f(&m.m[0]));
-			// return versor_from_eigen(vv);
-			glm::mat4 mm = glm::make_mat4(&m.m[0]);
-			glm::quat q = glm::quat_cast(mm);
-			noob::versor_type<T> qq;
-			qq.q[0] = q[0];
-			qq.q[1] = q[1];
-			qq.q[2] = q[2];
-			qq.q[3] = q[3];
-			return qq;
+			const T* m = &mat.m[0];
+			// Column-major: m[col * 4 + row].
+			const T m00 = m[0], m11 = m[5], m22 = m[10];
+			const T one = 1.0, half = 0.5;
+			const T d0 = one + m00 + m11 + m22, d1 = one + m00 - m11 - m22, d2 = one - m00 + m11 - m22, d3 = one - m00 - m11 + m22;
+			// Each case is 4 * q * q[k], which 1 / (4 * q[k]) = 1 / (2 * sqrt(d[k])) scales back to q.
+			const T wx = m[6] - m[9], wy = m[8] - m[2], wz = m[1] - m[4];
+			const T xy = m[1] + m[4], xz = m[8] + m[2], yz = m[6] + m[9];
+			versor_type<T> q(d0, wx, wy, wz);
+			T best = d0;
+			if (d1 > best)
+			{
+				q = versor_type<T>(wx, d1, xy, xz);
+				best = d1;
+			}
+			if (d2 > best)
+			{
+				q = versor_type<T>(wy, xy, d2, yz);
+				best = d2;
+			}
+			if (d3 > best)
+			{
+				q = versor_type<T>(wz, xz, yz, d3);
+				best = d3;
+			}
+			const T inv = half / std::sqrt(best);
+			return versor_type<T>(q.q[0] * inv, q.q[1] * inv, q.q[2] * inv, q.q[3] * inv);
 		}
 
 	template <typename T>
 		static vec3_type<T> lerp(const noob::vec3_type<T>& a, const noob::vec3_type<T>& b, float t) noexcept(true)
 		{ 
+#if defined(NOOB_USE_EXPRESSION_TEMPLATES)
+			return noob::lazy(a) + (noob::lazy(b) - a) * t;
+#else
 			return a + (b - a) * t;
+#endif
 		}
 
-	template <typename T>
-		static versor_type<T> versor_from_axis_rad(float radians, float x, float y, float z) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static versor_type<T> versor_from_axis_rad(float radians, float x, float y, float z, M = M()) noexcept(true)
 		{
-			versor_type<T> result;
-			result.q[0] = cos (radians / 2.0);
-			result.q[1] = sin (radians / 2.0) * x;
-			result.q[2] = sin (radians / 2.0) * y;
-			result.q[3] = sin (radians / 2.0) * z;
-			return result;
+			T s, c;
+			M::sincos(static_cast<T>(radians) * static_cast<T>(0.5), s, c);
+			return versor_type<T>(c, s * x, s * y, s * z);
 		}
-	template <typename T>
-		static versor_type<T> versor_from_axis_deg(float degrees, float x, float y, float z) noexcept(true)
+
+	template <typename T, typename M = noob::default_math>
+		static versor_type<T> versor_from_axis_deg(float degrees, float x, float y, float z, M = M()) noexcept(true)
 		{
-			return versor_from_axis_rad<T>(NOOB_ONE_DEG_IN_RAD * degrees, x, y, z);
+			return versor_from_axis_rad<T, M>(NOOB_ONE_DEG_IN_RAD * degrees, x, y, z);
 		}
 
 	template <typename T>
-		static mat4_type<T> versor_to_mat4(const noob::versor_type<T>& q) noexcept(true)
+		static constexpr mat4_type<T> versor_to_mat4(const noob::versor_type<T>& q) noexcept(true)
 		{
 			const float w = q.q[0];
 			const float x = q.q[1];
@@ -524,18 +743,152 @@ namespace noob
 		}
 
 
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BATCH QUATERNION FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Interpolation over versor_soa streams, for blending whole poses. Each has a uniform-weight overload and one taking a weight per element.
+	// The shorter-arc sign flip is a select rather than a branch, so the loops vectorize like the other batch kernels.
+	// Outputs may be the same streams as either input.
+
+	namespace detail
+	{
+		template <typename T, typename W>
+			static void nlerp(const versor_soa<T>& a, const versor_soa<T>& b, W weight, versor_soa<T>& results)
+			{
+				const size_t count = a.size();
+				results.resize(count);
+				const T* a0 = a.q[0].data(); const T* a1 = a.q[1].data(); const T* a2 = a.q[2].data(); const T* a3 = a.q[3].data();
+				const T* b0 = b.q[0].data(); const T* b1 = b.q[1].data(); const T* b2 = b.q[2].data(); const T* b3 = b.q[3].data();
+				T* r0 = results.q[0].data(); T* r1 = results.q[1].data(); T* r2 = results.q[2].data(); T* r3 = results.q[3].data();
+				NOOB_IVDEP
+				for (size_t i = 0; i < count; ++i)
+				{
+					const T t = weight(i);
+					const T d = a0[i] * b0[i] + a1[i] * b1[i] + a2[i] * b2[i] + a3[i] * b3[i];
+					const T wa = 1.0 - t;
+					const T wb = d < 0.0 ? -t : t;
+					const T x = a0[i] * wa + b0[i] * wb, y = a1[i] * wa + b1[i] * wb, z = a2[i] * wa + b2[i] * wb, w = a3[i] * wa + b3[i] * wb;
+					const T inv_len = static_cast<T>(1.0) / std::sqrt(x * x + y * y + z * z + w * w);
+					r0[i] = x * inv_len;
+					r1[i] = y * inv_len;
+					r2[i] = z * inv_len;
+					r3[i] = w * inv_len;
+				}
+			}
+
+		template <typename T, typename W>
+			static void slerp(const versor_soa<T>& a, const versor_soa<T>& b, W weight, versor_soa<T>& results)
+			{
+				const size_t count = a.size();
+				results.resize(count);
+				const T* a0 = a.q[0].data(); const T* a1 = a.q[1].data(); const T* a2 = a.q[2].data(); const T* a3 = a.q[3].data();
+				const T* b0 = b.q[0].data(); const T* b1 = b.q[1].data(); const T* b2 = b.q[2].data(); const T* b3 = b.q[3].data();
+				T* r0 = results.q[0].data(); T* r1 = results.q[1].data(); T* r2 = results.q[2].data(); T* r3 = results.q[3].data();
+				NOOB_IVDEP
+				for (size_t i = 0; i < count; ++i)
+				{
+					const T t = weight(i);
+					const T d = a0[i] * b0[i] + a1[i] * b1[i] + a2[i] * b2[i] + a3[i] * b3[i];
+					const T cos_theta = std::min(std::fabs(d), static_cast<T>(1.0));
+					const T sin_theta = std::sqrt(1.0 - cos_theta * cos_theta);
+					const T theta = std::acos(cos_theta);
+					// Nearly parallel: fall back to lerp weights, as the scalar version does.
+					const bool parallel = sin_theta < 0.001;
+					const T inv_sin = static_cast<T>(1.0) / (parallel ? static_cast<T>(1.0) : sin_theta);
+					const T wa = parallel ? 1.0 - t : std::sin((1.0 - t) * theta) * inv_sin;
+					const T wb_abs = parallel ? t : std::sin(t * theta) * inv_sin;
+					const T wb = d < 0.0 ? -wb_abs : wb_abs;
+					r0[i] = a0[i] * wa + b0[i] * wb;
+					r1[i] = a1[i] * wa + b1[i] * wb;
+					r2[i] = a2[i] * wa + b2[i] * wb;
+					r3[i] = a3[i] * wa + b3[i] * wb;
+				}
+			}
+
+		// nlerp with its weight bent towards constant angular speed by a polynomial in t and the cosine of the angle
+		// (fitted per "Approximating slerp", A. Kapoulkine). No transcendentals, so it runs at nlerp speed.
+		template <typename T, typename W>
+			static void slerp_approx(const versor_soa<T>& a, const versor_soa<T>& b, W weight, versor_soa<T>& results)
+			{
+				const size_t count = a.size();
+				results.resize(count);
+				const T* a0 = a.q[0].data(); const T* a1 = a.q[1].data(); const T* a2 = a.q[2].data(); const T* a3 = a.q[3].data();
+				const T* b0 = b.q[0].data(); const T* b1 = b.q[1].data(); const T* b2 = b.q[2].data(); const T* b3 = b.q[3].data();
+				T* r0 = results.q[0].data(); T* r1 = results.q[1].data(); T* r2 = results.q[2].data(); T* r3 = results.q[3].data();
+				NOOB_IVDEP
+				for (size_t i = 0; i < count; ++i)
+				{
+					const T t = weight(i);
+					const T d = a0[i] * b0[i] + a1[i] * b1[i] + a2[i] * b2[i] + a3[i] * b3[i];
+					const T c = std::fabs(d);
+					const T ka = 1.0904 + c * (-3.2452 + c * (3.55645 - c * 1.43519));
+					const T kb = 0.848013 + c * (-1.06021 + c * 0.215638);
+					const T k = ka * (t - 0.5) * (t - 0.5) + kb;
+					const T tt = t + t * (t - 0.5) * (t - 1.0) * k;
+					const T wa = 1.0 - tt;
+					const T wb = d < 0.0 ? -tt : tt;
+					const T x = a0[i] * wa + b0[i] * wb, y = a1[i] * wa + b1[i] * wb, z = a2[i] * wa + b2[i] * wb, w = a3[i] * wa + b3[i] * wb;
+					const T inv_len = static_cast<T>(1.0) / std::sqrt(x * x + y * y + z * z + w * w);
+					r0[i] = x * inv_len;
+					r1[i] = y * inv_len;
+					r2[i] = z * inv_len;
+					r3[i] = w * inv_len;
+				}
+			}
+	}
+
+	template <typename T>
+		static void nlerp(const versor_soa<T>& a, const versor_soa<T>& b, T t, versor_soa<T>& results)
+		{
+			detail::nlerp(a, b, [t](size_t) { return t; }, results);
+		}
+
+	template <typename T>
+		static void nlerp(const versor_soa<T>& a, const versor_soa<T>& b, const T* t, versor_soa<T>& results)
+		{
+			detail::nlerp(a, b, [t](size_t i) { return t[i]; }, results);
+		}
+
+	// Matches the scalar slerp() without its branches. The acos/sin calls only vectorize where the compiler has vector
+	// versions of them (e.g. GCC with glibc's libmvec under -ffast-math); slerp_approx() never needs them.
+	template <typename T>
+		static void slerp(const versor_soa<T>& a, const versor_soa<T>& b, T t, versor_soa<T>& results)
+		{
+			detail::slerp(a, b, [t](size_t) { return t; }, results);
+		}
+
+	template <typename T>
+		static void slerp(const versor_soa<T>& a, const versor_soa<T>& b, const T* t, versor_soa<T>& results)
+		{
+			detail::slerp(a, b, [t](size_t i) { return t[i]; }, results);
+		}
+
+	// Rotations come out within 1e-3 radians of slerp() for unit inputs and t in [0, 1] (math_funcs_bench reports the measured error).
+	template <typename T>
+		static void slerp_approx(const versor_soa<T>& a, const versor_soa<T>& b, T t, versor_soa<T>& results)
+		{
+			detail::slerp_approx(a, b, [t](size_t) { return t; }, results);
+		}
+
+	template <typename T>
+		static void slerp_approx(const versor_soa<T>& a, const versor_soa<T>& b, const T* t, versor_soa<T>& results)
+		{
+			detail::slerp_approx(a, b, [t](size_t i) { return t[i]; }, results);
+		}
+
+
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// MATRIX FUNCTIONS:
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <typename T>
-		static mat3_type<T> zero_mat3() noexcept(true)
+		static constexpr mat3_type<T> zero_mat3() noexcept(true)
 		{
 			return mat3_type<T>(	0.0f, 0.0f, 0.0f,
 					0.0f, 0.0f, 0.0f,
 					0.0f, 0.0f, 0.0f);
 		}
 	template <typename T>
-		static mat3_type<T> identity_mat3() noexcept(true)
+		static constexpr mat3_type<T> identity_mat3() noexcept(true)
 		{
 			return mat3_type<T>(	1.0f, 0.0f, 0.0f,
 					0.0f, 1.0f, 0.0f,
@@ -543,7 +896,7 @@ namespace noob
 		}
 
 	template <typename T>
-		static mat4_type<T> zero_mat4() noexcept(true)
+		static constexpr mat4_type<T> zero_mat4() noexcept(true)
 		{
 			return mat4_type<T>(	0.0f, 0.0f, 0.0f, 0.0f,
 					0.0f, 0.0f, 0.0f, 0.0f,
@@ -552,7 +905,7 @@ namespace noob
 		}
 
 	template <typename T>
-		static mat4_type<T> identity_mat4() noexcept(true)
+		static constexpr mat4_type<T> identity_mat4() noexcept(true)
 		{
 			return mat4_type<T>(	1.0f, 0.0f, 0.0f, 0.0f,
 					0.0f, 1.0f, 0.0f, 0.0f,
@@ -560,140 +913,403 @@ namespace noob
 					0.0f, 0.0f, 0.0f, 1.0f);
 		}
 
+	// Shared-minor 4x4 inversion (see Eberly, "The Laplace Expansion Theorem"). The twelve 2x2 minors of the top and bottom
+	// row pairs are computed once and reused by both the determinant and every cofactor, instead of expanding 3x3 cofactors
+	// from scratch. Because inverse(transpose(A)) == transpose(inverse(A)), the formula can read our column-major storage as if
+	// it were row-major and write the result back the same way.
+	namespace detail
+	{
+		// Writes the adjugate of a into b and returns the determinant. T may also be one of the register types further down,
+		// which is how the SoA batch forms run this across matrices.
+		template <typename T>
+			static inline T adjugate(const T* a, T* b) noexcept(true)
+			{
+				const T s0 = a[0] * a[5] - a[4] * a[1];
+				const T s1 = a[0] * a[6] - a[4] * a[2];
+				const T s2 = a[0] * a[7] - a[4] * a[3];
+				const T s3 = a[1] * a[6] - a[5] * a[2];
+				const T s4 = a[1] * a[7] - a[5] * a[3];
+				const T s5 = a[2] * a[7] - a[6] * a[3];
+
+				const T c5 = a[10] * a[15] - a[14] * a[11];
+				const T c4 = a[9] * a[15] - a[13] * a[11];
+				const T c3 = a[9] * a[14] - a[13] * a[10];
+				const T c2 = a[8] * a[15] - a[12] * a[11];
+				const T c1 = a[8] * a[14] - a[12] * a[10];
+				const T c0 = a[8] * a[13] - a[12] * a[9];
+
+				b[0] = a[5] * c5 - a[6] * c4 + a[7] * c3;
+				b[1] = -a[1] * c5 + a[2] * c4 - a[3] * c3;
+				b[2] = a[13] * s5 - a[14] * s4 + a[15] * s3;
+				b[3] = -a[9] * s5 + a[10] * s4 - a[11] * s3;
+
+				b[4] = -a[4] * c5 + a[6] * c2 - a[7] * c1;
+				b[5] = a[0] * c5 - a[2] * c2 + a[3] * c1;
+				b[6] = -a[12] * s5 + a[14] * s2 - a[15] * s1;
+				b[7] = a[8] * s5 - a[10] * s2 + a[11] * s1;
+
+				b[8] = a[4] * c4 - a[5] * c2 + a[7] * c0;
+				b[9] = -a[0] * c4 + a[1] * c2 - a[3] * c0;
+				b[10] = a[12] * s4 - a[13] * s2 + a[15] * s0;
+				b[11] = -a[8] * s4 + a[9] * s2 - a[11] * s0;
+
+				b[12] = -a[4] * c3 + a[5] * c1 - a[6] * c0;
+				b[13] = a[0] * c3 - a[1] * c1 + a[2] * c0;
+				b[14] = -a[12] * s3 + a[13] * s1 - a[14] * s0;
+				b[15] = a[8] * s3 - a[9] * s1 + a[10] * s0;
+
+				return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			}
+
+		// The determinant alone: only the bottom-pair minors and the four cofactors b[0], b[4], b[8] and b[12] of adjugate()
+		// that expand it along the first row.
+		template <typename T>
+			static constexpr T determinant(const T* a) noexcept(true)
+			{
+				const T c5 = a[10] * a[15] - a[14] * a[11];
+				const T c4 = a[9] * a[15] - a[13] * a[11];
+				const T c3 = a[9] * a[14] - a[13] * a[10];
+				const T c2 = a[8] * a[15] - a[12] * a[11];
+				const T c1 = a[8] * a[14] - a[12] * a[10];
+				const T c0 = a[8] * a[13] - a[12] * a[9];
+				const T b0 = a[5] * c5 - a[6] * c4 + a[7] * c3;
+				const T b4 = -a[4] * c5 + a[6] * c2 - a[7] * c1;
+				const T b8 = a[4] * c4 - a[5] * c2 + a[7] * c0;
+				const T b12 = -a[4] * c3 + a[5] * c1 - a[6] * c0;
+				return a[0] * b0 + a[1] * b4 + a[2] * b8 + a[3] * b12;
+			}
+	}
+
 	// Returns a scalar value with the determinant for a 4x4 matrix
-	// see http://www.euclideanspace.com/maths/algebra/matrix/functions/determinant/fourD/index.htm
 	template <typename T>	
-		static float determinant(const mat4_type<T>& mm) noexcept(true)
-		{
-			return
-				mm.m[12] * mm.m[9] * mm.m[6] * mm.m[3] -
-				mm.m[8] * mm.m[13] * mm.m[6] * mm.m[3] -
-				mm.m[12] * mm.m[5] * mm.m[10] * mm.m[3] +
-				mm.m[4] * mm.m[13] * mm.m[10] * mm.m[3] +
-				mm.m[8] * mm.m[5] * mm.m[14] * mm.m[3] -
-				mm.m[4] * mm.m[9] * mm.m[14] * mm.m[3] -
-				mm.m[12] * mm.m[9] * mm.m[2] * mm.m[7] +
-				mm.m[8] * mm.m[13] * mm.m[2] * mm.m[7] +
-				mm.m[12] * mm.m[1] * mm.m[10] * mm.m[7] -
-				mm.m[0] * mm.m[13] * mm.m[10] * mm.m[7] -
-				mm.m[8] * mm.m[1] * mm.m[14] * mm.m[7] +
-				mm.m[0] * mm.m[9] * mm.m[14] * mm.m[7] +
-				mm.m[12] * mm.m[5] * mm.m[2] * mm.m[11] -
-				mm.m[4] * mm.m[13] * mm.m[2] * mm.m[11] -
-				mm.m[12] * mm.m[1] * mm.m[6] * mm.m[11] +
-				mm.m[0] * mm.m[13] * mm.m[6] * mm.m[11] +
-				mm.m[4] * mm.m[1] * mm.m[14] * mm.m[11] -
-				mm.m[0] * mm.m[5] * mm.m[14] * mm.m[11] -
-				mm.m[8] * mm.m[5] * mm.m[2] * mm.m[15] +
-				mm.m[4] * mm.m[9] * mm.m[2] * mm.m[15] +
-				mm.m[8] * mm.m[1] * mm.m[6] * mm.m[15] -
-				mm.m[0] * mm.m[9] * mm.m[6] * mm.m[15] -
-				mm.m[4] * mm.m[1] * mm.m[10] * mm.m[15] +
-				mm.m[0] * mm.m[5] * mm.m[10] * mm.m[15];
-		}
-
-	// returns a 16-element array that is the inverse of a 16-element array (4x4 matrix). see http://www.euclideanspace.com/maths/algebra/matrix/functions/inverse/fourD/index.htm
+		static constexpr T determinant(const mat4_type<T>& mm) noexcept(true)
+		{
+			return detail::determinant(&mm.m[0]);
+		}
+
+	// Computes the inverse and the determinant in one pass. Returns false if the determinant is zero, in which case there
+	// is no inverse and results is set to the input unchanged.
+	template <typename T>
+		static bool inverse(const mat4_type<T>& mm, mat4_type<T>& results, T& det) noexcept(true)
+		{
+			mat4_type<T> adj;
+			det = detail::adjugate(&mm.m[0], &adj.m[0]);
+			if (det == static_cast<T>(0.0))
+			{
+				results = mm;
+				return false;
+			}
+			const T inv_det = static_cast<T>(1.0) / det;
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				results.m[i] = adj.m[i] * inv_det;
+			}
+			return true;
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// The shared-minor formula again, four cofactors per instruction. Each output column comes out as
+	// +-(X * M - X' * M' + X'' * M''), where the X are columns of our matrix reordered (1, 0, 3, 2) and the M pair up the
+	// bottom-row minors (lanes 0-1) with the top-row minors (lanes 2-3).
+	static bool inverse(const mat4_type<float>& mm, mat4_type<float>& results, float& det) noexcept(true)
+	{
+		const __m128 c0 = _mm_loadu_ps(&mm.m[0]);
+		const __m128 c1 = _mm_loadu_ps(&mm.m[4]);
+		const __m128 c2 = _mm_loadu_ps(&mm.m[8]);
+		const __m128 c3 = _mm_loadu_ps(&mm.m[12]);
+
+		__m128 x0 = c1, x1 = c0, x2 = c3, x3 = c2;
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+
+		// l_k = (c2[k], c2[k], c0[k], c0[k]), r_k = (c3[k], c3[k], c1[k], c1[k])
+		__m128 l0 = c2, l1 = c2, l2 = c0, l3 = c0;
+		_MM_TRANSPOSE4_PS(l0, l1, l2, l3);
+		__m128 r0 = c3, r1 = c3, r2 = c1, r3 = c1;
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+		// m_k = (c_k, c_k, s_k, s_k)
+		const __m128 m0 = _mm_sub_ps(_mm_mul_ps(l0, r1), _mm_mul_ps(r0, l1));
+		const __m128 m1 = _mm_sub_ps(_mm_mul_ps(l0, r2), _mm_mul_ps(r0, l2));
+		const __m128 m2 = _mm_sub_ps(_mm_mul_ps(l0, r3), _mm_mul_ps(r0, l3));
+		const __m128 m3 = _mm_sub_ps(_mm_mul_ps(l1, r2), _mm_mul_ps(r1, l2));
+		const __m128 m4 = _mm_sub_ps(_mm_mul_ps(l1, r3), _mm_mul_ps(r1, l3));
+		const __m128 m5 = _mm_sub_ps(_mm_mul_ps(l2, r3), _mm_mul_ps(r2, l3));
+
+		const __m128 b0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x1, m5), _mm_mul_ps(x2, m4)), _mm_mul_ps(x3, m3));
+		const __m128 b1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, m5), _mm_mul_ps(x2, m2)), _mm_mul_ps(x3, m1));
+		const __m128 b2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, m4), _mm_mul_ps(x1, m2)), _mm_mul_ps(x3, m0));
+		const __m128 b3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, m3), _mm_mul_ps(x1, m1)), _mm_mul_ps(x2, m0));
+
+		// Determinant: first column of our matrix (read as row 0) against lane 0 of each cofactor column, whose signs are
+		// (+, -, +, -) down the columns.
+		const __m128 lane0 = _mm_movelh_ps(_mm_unpacklo_ps(b0, b1), _mm_unpacklo_ps(b2, b3));
+		const __m128 p = _mm_mul_ps(_mm_mul_ps(c0, lane0), _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f));
+		const __m128 h = _mm_add_ps(p, _mm_movehl_ps(p, p));
+		det = _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, _MM_SHUFFLE(1, 1, 1, 1))));
+		if (det == 0.0f)
+		{
+			results = mm;
+			return false;
+		}
+
+		const float inv_det = 1.0f / det;
+		const __m128 even = _mm_set_ps(-inv_det, inv_det, -inv_det, inv_det);
+		const __m128 odd = _mm_set_ps(inv_det, -inv_det, inv_det, -inv_det);
+		_mm_storeu_ps(&results.m[0], _mm_mul_ps(b0, even));
+		_mm_storeu_ps(&results.m[4], _mm_mul_ps(b1, odd));
+		_mm_storeu_ps(&results.m[8], _mm_mul_ps(b2, even));
+		_mm_storeu_ps(&results.m[12], _mm_mul_ps(b3, odd));
+		return true;
+	}
+#endif
+
+	// Returns the inverse, or the input unchanged if it has no inverse. Use the three-argument form to find out which.
 	template <typename T>
 		static mat4_type<T> inverse(const mat4_type<T>& mm) noexcept(true)
 		{
-			float det = determinant(mm);
+			mat4_type<T> results;
+			T det;
+			inverse(mm, results, det);
+			return results;
+		}
 
-			// There is no inverse if determinant is zero (not likely unless scale is broken)
-			if (compare_floats(0.0, det))
+	// Batch inversion of matrices stored as SoA. success[i] is 1 where matrix i was inverted and 0 where it was singular
+	// (its results lane then holds the input unchanged). Returns the number inverted. results may be in. The range form
+	// inverts matrices [begin, end) only, into an already-sized results. This is the scalar fallback; with SSE2 the float
+	// and double overloads below run the same arithmetic across a register's worth of matrices at a time.
+	template <typename T>
+		static size_t inverse(const mat4_soa<T>& in, mat4_soa<T>& results, uint8_t* success, size_t begin, size_t end) noexcept(true)
+		{
+			size_t inverted = 0;
+			for (size_t i = begin; i < end; ++i)
 			{
-				// logger::log("WARNING. matrix has no determinant. can not invert");
-				return mm;
+				T a[16], b[16];
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					a[k] = in.m[k][i];
+				}
+				const T det = detail::adjugate(a, b);
+				const bool ok = det != static_cast<T>(0.0);
+				const T inv_det = static_cast<T>(1.0) / det;
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					results.m[k][i] = ok ? b[k] * inv_det : a[k];
+				}
+				success[i] = ok;
+				inverted += ok;
+			}
+			return inverted;
+		}
+
+	template <typename T>
+		static void determinant(const mat4_soa<T>& in, T* results, size_t begin, size_t end) noexcept(true)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				T a[16];
+				for (uint32_t k = 0; k < 16; ++k)
+				{
+					a[k] = in.m[k][i];
+				}
+				results[i] = detail::determinant(a);
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// One register of lanes standing in for T, so adjugate() and determinant() above run unchanged across SoA streams:
+	// each of the sixteen elements is one load from its stream, and every operation covers width matrices. The skinning
+	// kernels use them the same way, one lane per vertex.
+	namespace detail
+	{
+		struct f32x4
+		{
+			typedef float scalar;
+			static const size_t width = 4;
+			__m128 v;
+
+			static f32x4 load(const float* p) noexcept(true) { return { _mm_loadu_ps(p) }; }
+			static f32x4 set1(float x) noexcept(true) { return { _mm_set1_ps(x) }; }
+			void store(float* p) const noexcept(true) { _mm_storeu_ps(p, v); }
+			f32x4 operator+(f32x4 b) const noexcept(true) { return { _mm_add_ps(v, b.v) }; }
+			f32x4 operator-(f32x4 b) const noexcept(true) { return { _mm_sub_ps(v, b.v) }; }
+			f32x4 operator*(f32x4 b) const noexcept(true) { return { _mm_mul_ps(v, b.v) }; }
+			f32x4 operator-() const noexcept(true) { return { _mm_xor_ps(v, _mm_set1_ps(-0.0f)) }; }
+			f32x4 sqrt() const noexcept(true) { return { _mm_sqrt_ps(v) }; }
+			f32x4 reciprocal() const noexcept(true) { return { _mm_div_ps(_mm_set1_ps(1.0f), v) }; }
+			f32x4 is_zero() const noexcept(true) { return { _mm_cmpeq_ps(v, _mm_setzero_ps()) }; }
+			// Per lane, this ? a : b, for a mask from is_zero().
+			f32x4 select(f32x4 a, f32x4 b) const noexcept(true) { return { _mm_or_ps(_mm_and_ps(v, a.v), _mm_andnot_ps(v, b.v)) }; }
+			int bits() const noexcept(true) { return _mm_movemask_ps(v); }
+		};
+
+		struct f64x2
+		{
+			typedef double scalar;
+			static const size_t width = 2;
+			__m128d v;
+
+			static f64x2 load(const double* p) noexcept(true) { return { _mm_loadu_pd(p) }; }
+			static f64x2 set1(double x) noexcept(true) { return { _mm_set1_pd(x) }; }
+			void store(double* p) const noexcept(true) { _mm_storeu_pd(p, v); }
+			f64x2 operator+(f64x2 b) const noexcept(true) { return { _mm_add_pd(v, b.v) }; }
+			f64x2 operator-(f64x2 b) const noexcept(true) { return { _mm_sub_pd(v, b.v) }; }
+			f64x2 operator*(f64x2 b) const noexcept(true) { return { _mm_mul_pd(v, b.v) }; }
+			f64x2 operator-() const noexcept(true) { return { _mm_xor_pd(v, _mm_set1_pd(-0.0)) }; }
+			f64x2 sqrt() const noexcept(true) { return { _mm_sqrt_pd(v) }; }
+			f64x2 reciprocal() const noexcept(true) { return { _mm_div_pd(_mm_set1_pd(1.0), v) }; }
+			f64x2 is_zero() const noexcept(true) { return { _mm_cmpeq_pd(v, _mm_setzero_pd()) }; }
+			f64x2 select(f64x2 a, f64x2 b) const noexcept(true) { return { _mm_or_pd(_mm_and_pd(v, a.v), _mm_andnot_pd(v, b.v)) }; }
+			int bits() const noexcept(true) { return _mm_movemask_pd(v); }
+		};
+
+#if defined(NOOB_SIMD_AVX)
+		struct f32x8
+		{
+			typedef float scalar;
+			static const size_t width = 8;
+			__m256 v;
+
+			static f32x8 load(const float* p) noexcept(true) { return { _mm256_loadu_ps(p) }; }
+			static f32x8 set1(float x) noexcept(true) { return { _mm256_set1_ps(x) }; }
+			void store(float* p) const noexcept(true) { _mm256_storeu_ps(p, v); }
+			f32x8 operator+(f32x8 b) const noexcept(true) { return { _mm256_add_ps(v, b.v) }; }
+			f32x8 operator-(f32x8 b) const noexcept(true) { return { _mm256_sub_ps(v, b.v) }; }
+			f32x8 operator*(f32x8 b) const noexcept(true) { return { _mm256_mul_ps(v, b.v) }; }
+			f32x8 operator-() const noexcept(true) { return { _mm256_xor_ps(v, _mm256_set1_ps(-0.0f)) }; }
+			f32x8 sqrt() const noexcept(true) { return { _mm256_sqrt_ps(v) }; }
+			f32x8 reciprocal() const noexcept(true) { return { _mm256_div_ps(_mm256_set1_ps(1.0f), v) }; }
+			f32x8 is_zero() const noexcept(true) { return { _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_EQ_OQ) }; }
+			f32x8 select(f32x8 a, f32x8 b) const noexcept(true) { return { _mm256_blendv_ps(b.v, a.v, v) }; }
+			int bits() const noexcept(true) { return _mm256_movemask_ps(v); }
+		};
+
+		struct f64x4
+		{
+			typedef double scalar;
+			static const size_t width = 4;
+			__m256d v;
+
+			static f64x4 load(const double* p) noexcept(true) { return { _mm256_loadu_pd(p) }; }
+			static f64x4 set1(double x) noexcept(true) { return { _mm256_set1_pd(x) }; }
+			void store(double* p) const noexcept(true) { _mm256_storeu_pd(p, v); }
+			f64x4 operator+(f64x4 b) const noexcept(true) { return { _mm256_add_pd(v, b.v) }; }
+			f64x4 operator-(f64x4 b) const noexcept(true) { return { _mm256_sub_pd(v, b.v) }; }
+			f64x4 operator*(f64x4 b) const noexcept(true) { return { _mm256_mul_pd(v, b.v) }; }
+			f64x4 operator-() const noexcept(true) { return { _mm256_xor_pd(v, _mm256_set1_pd(-0.0)) }; }
+			f64x4 sqrt() const noexcept(true) { return { _mm256_sqrt_pd(v) }; }
+			f64x4 reciprocal() const noexcept(true) { return { _mm256_div_pd(_mm256_set1_pd(1.0), v) }; }
+			f64x4 is_zero() const noexcept(true) { return { _mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_EQ_OQ) }; }
+			f64x4 select(f64x4 a, f64x4 b) const noexcept(true) { return { _mm256_blendv_pd(b.v, a.v, v) }; }
+			int bits() const noexcept(true) { return _mm256_movemask_pd(v); }
+		};
+#endif
+
+		// Inverts whole registers of matrices from begin on and advances begin past them; the caller finishes the tail.
+		// All sixteen loads come before any store, so results may be in.
+		template <typename V>
+			static size_t inverse_lanes(const mat4_soa<typename V::scalar>& in, mat4_soa<typename V::scalar>& results, uint8_t* success, size_t& begin, size_t end) noexcept(true)
+			{
+				size_t inverted = 0;
+				for (; begin + V::width <= end; begin += V::width)
+				{
+					V a[16], b[16];
+					for (uint32_t k = 0; k < 16; ++k)
+					{
+						a[k] = V::load(in.m[k].data() + begin);
+					}
+					const V det = adjugate(a, b);
+					const V singular = det.is_zero();
+					const V inv_det = det.reciprocal();
+					const int bits = singular.bits();
+					for (uint32_t k = 0; k < 16; ++k)
+					{
+						V r = b[k] * inv_det;
+						if (bits != 0)
+						{
+							r = singular.select(V::load(in.m[k].data() + begin), r);
+						}
+						r.store(results.m[k].data() + begin);
+					}
+					for (uint32_t j = 0; j < V::width; ++j)
+					{
+						const bool ok = ((bits >> j) & 1) == 0;
+						success[begin + j] = ok;
+						inverted += ok;
+					}
+				}
+				return inverted;
+			}
+
+		template <typename V>
+			static void determinant_lanes(const mat4_soa<typename V::scalar>& in, typename V::scalar* results, size_t& begin, size_t end) noexcept(true)
+			{
+				for (; begin + V::width <= end; begin += V::width)
+				{
+					V a[16];
+					for (uint32_t k = 0; k < 16; ++k)
+					{
+						a[k] = V::load(in.m[k].data() + begin);
+					}
+					determinant(a).store(results + begin);
+				}
 			}
+	}
+
+	static size_t inverse(const mat4_soa<float>& in, mat4_soa<float>& results, uint8_t* success, size_t begin, size_t end) noexcept(true)
+	{
+		size_t inverted = 0;
+#if defined(NOOB_SIMD_AVX)
+		inverted += detail::inverse_lanes<detail::f32x8>(in, results, success, begin, end);
+#endif
+		inverted += detail::inverse_lanes<detail::f32x4>(in, results, success, begin, end);
+		return inverted + noob::inverse<float>(in, results, success, begin, end);
+	}
+
+	static size_t inverse(const mat4_soa<double>& in, mat4_soa<double>& results, uint8_t* success, size_t begin, size_t end) noexcept(true)
+	{
+		size_t inverted = 0;
+#if defined(NOOB_SIMD_AVX)
+		inverted += detail::inverse_lanes<detail::f64x4>(in, results, success, begin, end);
+#endif
+		inverted += detail::inverse_lanes<detail::f64x2>(in, results, success, begin, end);
+		return inverted + noob::inverse<double>(in, results, success, begin, end);
+	}
+
+	static void determinant(const mat4_soa<float>& in, float* results, size_t begin, size_t end) noexcept(true)
+	{
+#if defined(NOOB_SIMD_AVX)
+		detail::determinant_lanes<detail::f32x8>(in, results, begin, end);
+#endif
+		detail::determinant_lanes<detail::f32x4>(in, results, begin, end);
+		noob::determinant<float>(in, results, begin, end);
+	}
 
-			float inv_det = 1.0f / det;
-
-			return mat4_type<T> (
-					inv_det * (
-						mm.m[9] * mm.m[14] * mm.m[7] - mm.m[13] * mm.m[10] * mm.m[7] +
-						mm.m[13] * mm.m[6] * mm.m[11] - mm.m[5] * mm.m[14] * mm.m[11] -
-						mm.m[9] * mm.m[6] * mm.m[15] + mm.m[5] * mm.m[10] * mm.m[15]
-						),
-					inv_det * (
-						mm.m[13] * mm.m[10] * mm.m[3] - mm.m[9] * mm.m[14] * mm.m[3] -
-						mm.m[13] * mm.m[2] * mm.m[11] + mm.m[1] * mm.m[14] * mm.m[11] +
-						mm.m[9] * mm.m[2] * mm.m[15] - mm.m[1] * mm.m[10] * mm.m[15]
-						),
-					inv_det * (
-						mm.m[5] * mm.m[14] * mm.m[3] - mm.m[13] * mm.m[6] * mm.m[3] +
-						mm.m[13] * mm.m[2] * mm.m[7] - mm.m[1] * mm.m[14] * mm.m[7] -
-						mm.m[5] * mm.m[2] * mm.m[15] + mm.m[1] * mm.m[6] * mm.m[15]
-						),
-					inv_det * (
-						mm.m[9] * mm.m[6] * mm.m[3] - mm.m[5] * mm.m[10] * mm.m[3] -
-						mm.m[9] * mm.m[2] * mm.m[7] + mm.m[1] * mm.m[10] * mm.m[7] +
-						mm.m[5] * mm.m[2] * mm.m[11] - mm.m[1] * mm.m[6] * mm.m[11]
-						),
-					inv_det * (
-							mm.m[12] * mm.m[10] * mm.m[7] - mm.m[8] * mm.m[14] * mm.m[7] -
-							mm.m[12] * mm.m[6] * mm.m[11] + mm.m[4] * mm.m[14] * mm.m[11] +
-							mm.m[8] * mm.m[6] * mm.m[15] - mm.m[4] * mm.m[10] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[8] * mm.m[14] * mm.m[3] - mm.m[12] * mm.m[10] * mm.m[3] +
-							mm.m[12] * mm.m[2] * mm.m[11] - mm.m[0] * mm.m[14] * mm.m[11] -
-							mm.m[8] * mm.m[2] * mm.m[15] + mm.m[0] * mm.m[10] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[12] * mm.m[6] * mm.m[3] - mm.m[4] * mm.m[14] * mm.m[3] -
-							mm.m[12] * mm.m[2] * mm.m[7] + mm.m[0] * mm.m[14] * mm.m[7] +
-							mm.m[4] * mm.m[2] * mm.m[15] - mm.m[0] * mm.m[6] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[4] * mm.m[10] * mm.m[3] - mm.m[8] * mm.m[6] * mm.m[3] +
-							mm.m[8] * mm.m[2] * mm.m[7] - mm.m[0] * mm.m[10] * mm.m[7] -
-							mm.m[4] * mm.m[2] * mm.m[11] + mm.m[0] * mm.m[6] * mm.m[11]
-						  ),
-					inv_det * (
-							mm.m[8] * mm.m[13] * mm.m[7] - mm.m[12] * mm.m[9] * mm.m[7] +
-							mm.m[12] * mm.m[5] * mm.m[11] - mm.m[4] * mm.m[13] * mm.m[11] -
-							mm.m[8] * mm.m[5] * mm.m[15] + mm.m[4] * mm.m[9] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[12] * mm.m[9] * mm.m[3] - mm.m[8] * mm.m[13] * mm.m[3] -
-							mm.m[12] * mm.m[1] * mm.m[11] + mm.m[0] * mm.m[13] * mm.m[11] +
-							mm.m[8] * mm.m[1] * mm.m[15] - mm.m[0] * mm.m[9] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[4] * mm.m[13] * mm.m[3] - mm.m[12] * mm.m[5] * mm.m[3] +
-							mm.m[12] * mm.m[1] * mm.m[7] - mm.m[0] * mm.m[13] * mm.m[7] -
-							mm.m[4] * mm.m[1] * mm.m[15] + mm.m[0] * mm.m[5] * mm.m[15]
-						  ),
-					inv_det * (
-							mm.m[8] * mm.m[5] * mm.m[3] - mm.m[4] * mm.m[9] * mm.m[3] -
-							mm.m[8] * mm.m[1] * mm.m[7] + mm.m[0] * mm.m[9] * mm.m[7] +
-							mm.m[4] * mm.m[1] * mm.m[11] - mm.m[0] * mm.m[5] * mm.m[11]
-						  ),
-					inv_det * (
-							mm.m[12] * mm.m[9] * mm.m[6] - mm.m[8] * mm.m[13] * mm.m[6] -
-							mm.m[12] * mm.m[5] * mm.m[10] + mm.m[4] * mm.m[13] * mm.m[10] +
-							mm.m[8] * mm.m[5] * mm.m[14] - mm.m[4] * mm.m[9] * mm.m[14]
-						  ),
-					inv_det * (
-							mm.m[8] * mm.m[13] * mm.m[2] - mm.m[12] * mm.m[9] * mm.m[2] +
-							mm.m[12] * mm.m[1] * mm.m[10] - mm.m[0] * mm.m[13] * mm.m[10] -
-							mm.m[8] * mm.m[1] * mm.m[14] + mm.m[0] * mm.m[9] * mm.m[14]
-						  ),
-					inv_det * (
-							mm.m[12] * mm.m[5] * mm.m[2] - mm.m[4] * mm.m[13] * mm.m[2] -
-							mm.m[12] * mm.m[1] * mm.m[6] + mm.m[0] * mm.m[13] * mm.m[6] +
-							mm.m[4] * mm.m[1] * mm.m[14] - mm.m[0] * mm.m[5] * mm.m[14]
-						  ),
-					inv_det * (
-							mm.m[4] * mm.m[9] * mm.m[2] - mm.m[8] * mm.m[5] * mm.m[2] +
-							mm.m[8] * mm.m[1] * mm.m[6] - mm.m[0] * mm.m[9] * mm.m[6] -
-							mm.m[4] * mm.m[1] * mm.m[10] + mm.m[0] * mm.m[5] * mm.m[10]
-						  )
-						);
+	static void determinant(const mat4_soa<double>& in, double* results, size_t begin, size_t end) noexcept(true)
+	{
+#if defined(NOOB_SIMD_AVX)
+		detail::determinant_lanes<detail::f64x4>(in, results, begin, end);
+#endif
+		detail::determinant_lanes<detail::f64x2>(in, results, begin, end);
+		noob::determinant<double>(in, results, begin, end);
+	}
+#endif
+
+	template <typename T>
+		static size_t inverse(const mat4_soa<T>& in, mat4_soa<T>& results, uint8_t* success)
+		{
+			results.resize(in.size());
+			return inverse(in, results, success, 0, in.size());
+		}
+
+	template <typename T>
+		static void determinant(const mat4_soa<T>& in, T* results) noexcept(true)
+		{
+			determinant(in, results, 0, in.size());
 		}
 
 	// Returns a 16-element array flipped on the main diagonal
 	template <typename T>
-		static mat4_type<T> transpose(const mat4_type<T>& mm) noexcept(true)
+		static constexpr mat4_type<T> transpose(const mat4_type<T>& mm) noexcept(true)
 		{
 			return mat4_type<T>(
 					mm.m[0], mm.m[4], mm.m[8], mm.m[12],
@@ -708,13 +1324,14 @@ namespace noob
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	template <typename T>
-		static mat4_type<T> translate(const mat4_type<T>& m, const vec3_type<T> v) noexcept(true)
+		static constexpr mat4_type<T> translate(const mat4_type<T>& m, const vec3_type<T> v) noexcept(true)
 		{
-			mat4_type<T> m_t = identity_mat4<T>();
-			m_t.m[12] = v.v[0];
-			m_t.m[13] = v.v[1];
-			m_t.m[14] = v.v[2];
-			return m_t * m;
+			// Same result as a translation matrix times m, written out so it needs no 4x4 multiply and stays constexpr.
+			return mat4_type<T>(
+					m.m[0] + v.v[0] * m.m[3], m.m[1] + v.v[1] * m.m[3], m.m[2] + v.v[2] * m.m[3], m.m[3],
+					m.m[4] + v.v[0] * m.m[7], m.m[5] + v.v[1] * m.m[7], m.m[6] + v.v[2] * m.m[7], m.m[7],
+					m.m[8] + v.v[0] * m.m[11], m.m[9] + v.v[1] * m.m[11], m.m[10] + v.v[2] * m.m[11], m.m[11],
+					m.m[12] + v.v[0] * m.m[15], m.m[13] + v.v[1] * m.m[15], m.m[14] + v.v[2] * m.m[15], m.m[15]);
 		}
 
 	template <typename T>
@@ -723,53 +1340,54 @@ namespace noob
 			return versor_to_mat4(v) * m;
 		}
 
-	template <typename T>
-		static mat4_type<T> rotate_x_deg(const mat4_type<T>& m, float deg) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static mat4_type<T> rotate_x_deg(const mat4_type<T>& m, float deg, M = M()) noexcept(true)
 		{
-			// convert to radians
-			float rad = deg * NOOB_ONE_DEG_IN_RAD;
+			T s, c;
+			M::sincos(static_cast<T>(deg * NOOB_ONE_DEG_IN_RAD), s, c);
 			mat4_type<T> m_r = identity_mat4<T>();
-			m_r.m[5] = cos(rad);
-			m_r.m[9] = -sin(rad);
-			m_r.m[6] = sin(rad);
-			m_r.m[10] = cos(rad);
+			m_r.m[5] = c;
+			m_r.m[9] = -s;
+			m_r.m[6] = s;
+			m_r.m[10] = c;
 			return m_r * m;
 		}
 
-	template <typename T>
-		static mat4_type<T> rotate_y_deg(const mat4_type<T>& m, float deg) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static mat4_type<T> rotate_y_deg(const mat4_type<T>& m, float deg, M = M()) noexcept(true)
 		{
-			// convert to radians
-			const float rad = deg * NOOB_ONE_DEG_IN_RAD;
+			T s, c;
+			M::sincos(static_cast<T>(deg * NOOB_ONE_DEG_IN_RAD), s, c);
 			mat4_type<T> m_r = identity_mat4<T>();
-			m_r.m[0] = cos(rad);
-			m_r.m[8] = sin(rad);
-			m_r.m[2] = -sin(rad);
-			m_r.m[10] = cos(rad);
+			m_r.m[0] = c;
+			m_r.m[8] = s;
+			m_r.m[2] = -s;
+			m_r.m[10] = c;
 			return m_r * m;
 		}
 
-	template <typename T>
-		static mat4_type<T> rotate_z_deg(const mat4_type<T>& m, float deg) noexcept(true)
+	template <typename T, typename M = noob::default_math>
+		static mat4_type<T> rotate_z_deg(const mat4_type<T>& m, float deg, M = M()) noexcept(true)
 		{
-			// convert to radians
-			const float rad = deg * NOOB_ONE_DEG_IN_RAD;
+			T s, c;
+			M::sincos(static_cast<T>(deg * NOOB_ONE_DEG_IN_RAD), s, c);
 			mat4_type<T> m_r = identity_mat4<T>();
-			m_r.m[0] = cos(rad);
-			m_r.m[4] = -sin(rad);
-			m_r.m[1] = sin(rad);
-			m_r.m[5] = cos(rad);
+			m_r.m[0] = c;
+			m_r.m[4] = -s;
+			m_r.m[1] = s;
+			m_r.m[5] = c;
 			return m_r * m;
 		}
 
 	template <typename T>
-		static mat4_type<T> scale(const mat4_type<T>& m, const vec3_type<T> v) noexcept(true)
+		static constexpr mat4_type<T> scale(const mat4_type<T>& m, const vec3_type<T> v) noexcept(true)
 		{
-			mat4_type<T> a = identity_mat4<T>();
-			a.m[0] = v.v[0];
-			a.m[5] = v.v[1];
-			a.m[10] = v.v[2];
-			return a * m;
+			// Same result as a scale matrix times m: each of the first three rows is scaled.
+			return mat4_type<T>(
+					m.m[0] * v.v[0], m.m[1] * v.v[1], m.m[2] * v.v[2], m.m[3],
+					m.m[4] * v.v[0], m.m[5] * v.v[1], m.m[6] * v.v[2], m.m[7],
+					m.m[8] * v.v[0], m.m[9] * v.v[1], m.m[10] * v.v[2], m.m[11],
+					m.m[12] * v.v[0], m.m[13] * v.v[1], m.m[14] * v.v[2], m.m[15]);
 		}
 	template <typename T>
 		static vec3_type<T> get_normal(const std::array<vec3_type<T>, 3>& vertices) noexcept(true)
@@ -781,60 +1399,393 @@ namespace noob
 			return normalize(results);
 		}
 
-	// TODO: Implement. PITA (?)
-	// vec4 rotation_from_mat4(const mat4& m);
 	template <typename T>
-		static vec3_type<T> translation_from_mat4(const mat4_type<T>& m) noexcept(true)
+		static constexpr vec3_type<T> translation_from_mat4(const mat4_type<T>& m) noexcept(true)
 		{
-			vec3_type<T> v;
-			v.v[0] = m.m[12];
-			v.v[1] = m.m[13];
-			v.v[2] = m.m[14];
-			return v;
+			return vec3_type<T>(m.m[12], m.m[13], m.m[14]);
 		}
 
+	// Lengths of the first three columns of an affine matrix, i.e. the scale applied before its rotation. A mirrored matrix
+	// (negative determinant) gets a negative x, which keeps rotation_from_mat4() a proper rotation.
 	template <typename T>
-		static vec3_type<T> scale_from_mat4(const mat4_type<T>& m) noexcept(true)
+		static vec3_type<T> scale_from_mat4(const mat4_type<T>& mm) noexcept(true)
 		{
-			vec3_type<T> v;
-			v.v[0] = m.m[0];
-			v.v[1] = m.m[5];
-			v.v[2] = m.m[10];
-			return v;
+			const T* m = &mm.m[0];
+			const T sx = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+			const T sy = std::sqrt(m[4] * m[4] + m[5] * m[5] + m[6] * m[6]);
+			const T sz = std::sqrt(m[8] * m[8] + m[9] * m[9] + m[10] * m[10]);
+			const T det = m[0] * (m[5] * m[10] - m[6] * m[9]) - m[4] * (m[1] * m[10] - m[2] * m[9]) + m[8] * (m[1] * m[6] - m[2] * m[5]);
+			return vec3_type<T>(det < 0.0 ? -sx : sx, sy, sz);
 		}
 
-
-	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// CAMERA FUNCTIONS:
-	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	// Returns a view matrix using the opengl lookAt style. COLUMN ORDER:
+	// Splits an affine matrix into translate(rotate(scale(identity_mat4(), s), r), t). Shear is not representable and ends up
+	// spread over the rotation. Every column must be non-zero.
 	template <typename T>
-		static mat4_type<T> look_at(const vec3_type<T> cam_pos, const vec3_type<T> targ_pos, const vec3_type<T> up) noexcept(true)
+		static void decompose(const mat4_type<T>& m, vec3_type<T>& translation, versor_type<T>& rotation, vec3_type<T>& scale) noexcept(true)
 		{
-			// inverse translation
-			mat4_type<T> p = identity_mat4<T>();
-			p = translate(p, vec3_type<T>(-cam_pos[0], -cam_pos[1], -cam_pos[2]));
-			// distance vector
-			vec3_type<T> d = targ_pos - cam_pos;
-			// forward vector
-			vec3_type<T> f = normalize(d);
-			// right vector
-			vec3_type<T> r = normalize(cross(f, up));
-			// real up vector
-			vec3_type<T> u = normalize(cross(r, f));
-			mat4_type<T> ori = identity_mat4<T>();
-			ori.m[0] = r.v[0];
-			ori.m[4] = r.v[1];
-			ori.m[8] = r.v[2];
-			ori.m[1] = u.v[0];
-			ori.m[5] = u.v[1];
-			ori.m[9] = u.v[2];
-			ori.m[2] = -f.v[0];
-			ori.m[6] = -f.v[1];
-			ori.m[10] = -f.v[2];
-
-			return ori * p;//p * ori;
+			translation = translation_from_mat4(m);
+			scale = scale_from_mat4(m);
+			mat4_type<T> r(m);
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const T inv = static_cast<T>(1.0) / scale[c];
+				r.m[c * 4] *= inv;
+				r.m[c * 4 + 1] *= inv;
+				r.m[c * 4 + 2] *= inv;
+			}
+			rotation = versor_from_mat4(r);
+		}
+
+	template <typename T>
+		static versor_type<T> rotation_from_mat4(const mat4_type<T>& m) noexcept(true)
+		{
+			vec3_type<T> t, s;
+			versor_type<T> r;
+			decompose(m, t, r, s);
+			return r;
+		}
+
+	// Affine and rigid inverses. Matrices built from translate/rotate/scale/look_at have a (0, 0, 0, 1) bottom row, which lets
+	// us skip the full 4x4 cofactor expansion in inverse(). Like inverse(), a singular input is returned unchanged.
+
+	// Inverse of an affine matrix: the 3x3 part is inverted through the cross products of its columns and the translation
+	// is carried through it. Computed in T throughout (cross() and dot() work in float). In math_funcs_bench it runs about
+	// 1.6x (float) to 2x (double) faster than inverse(), so it's worth calling whenever is_affine() holds.
+	template <typename T>
+		static mat4_type<T> inverse_affine(const mat4_type<T>& mm) noexcept(true)
+		{
+			const T* m = &mm.m[0];
+			// Rows of the inverse, before dividing by the determinant: the cross products of columns 1 and 2, 2 and 0, 0 and 1.
+			const T r00 = m[5] * m[10] - m[6] * m[9], r01 = m[6] * m[8] - m[4] * m[10], r02 = m[4] * m[9] - m[5] * m[8];
+			const T r10 = m[9] * m[2] - m[10] * m[1], r11 = m[10] * m[0] - m[8] * m[2], r12 = m[8] * m[1] - m[9] * m[0];
+			const T r20 = m[1] * m[6] - m[2] * m[5], r21 = m[2] * m[4] - m[0] * m[6], r22 = m[0] * m[5] - m[1] * m[4];
+			const T det = m[0] * r00 + m[1] * r01 + m[2] * r02;
+			if (det == static_cast<T>(0.0))
+			{
+				return mm;
+			}
+			const T inv_det = static_cast<T>(1.0) / det;
+			const T i00 = r00 * inv_det, i01 = r10 * inv_det, i02 = r20 * inv_det;
+			const T i10 = r01 * inv_det, i11 = r11 * inv_det, i12 = r21 * inv_det;
+			const T i20 = r02 * inv_det, i21 = r12 * inv_det, i22 = r22 * inv_det;
+			const T tx = m[12], ty = m[13], tz = m[14];
+			return mat4_type<T>(
+					i00, i01, i02, 0.0,
+					i10, i11, i12, 0.0,
+					i20, i21, i22, 0.0,
+					-(i00 * tx + i10 * ty + i20 * tz),
+					-(i01 * tx + i11 * ty + i21 * tz),
+					-(i02 * tx + i12 * ty + i22 * tz),
+					1.0);
+		}
+
+	// Inverse of a rotation + translation: transpose the rotation and run the negated translation through it.
+	// Only valid when the 3x3 part is orthonormal (no scale); see is_rigid().
+	template <typename T>
+		static constexpr mat4_type<T> inverse_rigid(const mat4_type<T>& mm) noexcept(true)
+		{
+			const T tx = mm.m[12], ty = mm.m[13], tz = mm.m[14];
+			return mat4_type<T>(
+					mm.m[0], mm.m[4], mm.m[8], 0.0,
+					mm.m[1], mm.m[5], mm.m[9], 0.0,
+					mm.m[2], mm.m[6], mm.m[10], 0.0,
+					-(mm.m[0] * tx + mm.m[1] * ty + mm.m[2] * tz),
+					-(mm.m[4] * tx + mm.m[5] * ty + mm.m[6] * tz),
+					-(mm.m[8] * tx + mm.m[9] * ty + mm.m[10] * tz),
+					1.0);
+		}
+
+	// Exact test: the matrix functions in this file produce an exact (0, 0, 0, 1) bottom row.
+	template <typename T>
+		static constexpr bool is_affine(const mat4_type<T>& mm) noexcept(true)
+		{
+			return mm.m[3] == 0.0 && mm.m[7] == 0.0 && mm.m[11] == 0.0 && mm.m[15] == 1.0;
+		}
+
+	// True if the 3x3 part is orthonormal to within NOOB_EPSILON (assumes is_affine()).
+	template <typename T>
+		static bool is_rigid(const mat4_type<T>& mm) noexcept(true)
+		{
+			const T* m = &mm.m[0];
+			const T aa = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+			const T bb = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+			const T cc = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+			const T ab = m[0] * m[4] + m[1] * m[5] + m[2] * m[6];
+			const T bc = m[4] * m[8] + m[5] * m[9] + m[6] * m[10];
+			const T ca = m[8] * m[0] + m[9] * m[1] + m[10] * m[2];
+			const T one = 1.0;
+			return std::fabs(aa - one) <= NOOB_EPSILON && std::fabs(bb - one) <= NOOB_EPSILON && std::fabs(cc - one) <= NOOB_EPSILON &&
+				std::fabs(ab) <= NOOB_EPSILON && std::fabs(bc) <= NOOB_EPSILON && std::fabs(ca) <= NOOB_EPSILON;
+		}
+
+	// Picks the cheapest inverse that is valid for the input: rigid, then affine, then the general 4x4 inverse().
+	template <typename T>
+		static mat4_type<T> inverse_auto(const mat4_type<T>& mm) noexcept(true)
+		{
+			if (!is_affine(mm))
+			{
+				return inverse(mm);
+			}
+			if (is_rigid(mm))
+			{
+				return inverse_rigid(mm);
+			}
+			return inverse_affine(mm);
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Three-component helpers for float vectors held in one register, lane w unused.
+	namespace detail
+	{
+		static inline __m128 shuffle_yzx(__m128 v) noexcept(true)
+		{
+			return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+
+		// Lane w comes out as zero when both inputs have w == 0.
+		static inline __m128 cross3(__m128 a, __m128 b) noexcept(true)
+		{
+			return shuffle_yzx(_mm_sub_ps(_mm_mul_ps(a, shuffle_yzx(b)), _mm_mul_ps(shuffle_yzx(a), b)));
+		}
+
+		// Per lane, mask ? a : b (SSE2 has no blendv).
+		static inline __m128 select(__m128 mask, __m128 a, __m128 b) noexcept(true)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+	}
+#endif
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BATCH TRANSFORM FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Apply one matrix to a whole vertex stream. Inputs and outputs are addressed by a pointer to the first component and a
+	// stride in BYTES, so they can walk interleaved vertex buffers. Each element is read completely before it is written,
+	// so in == out (with equal strides) transforms in place. No vec4 temporaries are built per element.
+
+	namespace detail
+	{
+		template <typename T>
+			static const T* stride_at(const T* base, size_t stride, size_t i) noexcept(true)
+			{
+				return reinterpret_cast<const T*>(reinterpret_cast<const char*>(base) + i * stride);
+			}
+
+		template <typename T>
+			static T* stride_at(T* base, size_t stride, size_t i) noexcept(true)
+			{
+				return reinterpret_cast<T*>(reinterpret_cast<char*>(base) + i * stride);
+			}
+	}
+
+	// Points: w = 1, so translation applies. The result is not divided by w; use transform_homogeneous for projections.
+	template <typename T>
+		static void transform_points(const mat4_type<T>& mat, const T* in, size_t in_stride, T* out, size_t out_stride, size_t count) noexcept(true)
+		{
+			const mat4_type<T> m = mat;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T* src = detail::stride_at(in, in_stride, i);
+				const T x = src[0], y = src[1], z = src[2];
+				T* dst = detail::stride_at(out, out_stride, i);
+				dst[0] = m.m[0] * x + m.m[4] * y + m.m[8] * z + m.m[12];
+				dst[1] = m.m[1] * x + m.m[5] * y + m.m[9] * z + m.m[13];
+				dst[2] = m.m[2] * x + m.m[6] * y + m.m[10] * z + m.m[14];
+			}
+		}
+
+	// Directions: w = 0, so translation is ignored.
+	template <typename T>
+		static void transform_directions(const mat4_type<T>& mat, const T* in, size_t in_stride, T* out, size_t out_stride, size_t count) noexcept(true)
+		{
+			const mat4_type<T> m = mat;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T* src = detail::stride_at(in, in_stride, i);
+				const T x = src[0], y = src[1], z = src[2];
+				T* dst = detail::stride_at(out, out_stride, i);
+				dst[0] = m.m[0] * x + m.m[4] * y + m.m[8] * z;
+				dst[1] = m.m[1] * x + m.m[5] * y + m.m[9] * z;
+				dst[2] = m.m[2] * x + m.m[6] * y + m.m[10] * z;
+			}
+		}
+
+	// Full 4-component product, same as mat4_type::operator*(vec4_type) per element.
+	template <typename T>
+		static void transform_homogeneous(const mat4_type<T>& mat, const T* in, size_t in_stride, T* out, size_t out_stride, size_t count) noexcept(true)
+		{
+			const mat4_type<T> m = mat;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T* src = detail::stride_at(in, in_stride, i);
+				const T x = src[0], y = src[1], z = src[2], w = src[3];
+				T* dst = detail::stride_at(out, out_stride, i);
+				dst[0] = m.m[0] * x + m.m[4] * y + m.m[8] * z + m.m[12] * w;
+				dst[1] = m.m[1] * x + m.m[5] * y + m.m[9] * z + m.m[13] * w;
+				dst[2] = m.m[2] * x + m.m[6] * y + m.m[10] * z + m.m[14] * w;
+				dst[3] = m.m[3] * x + m.m[7] * y + m.m[11] * z + m.m[15] * w;
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// For float the matrix columns stay in registers and each element costs a few broadcasts plus multiply-adds.
+	// vec3 outputs are stored as 2 + 1 floats so a tightly-packed stream never has its next element clobbered.
+	namespace detail
+	{
+		static inline void store_xyz(float* dst, __m128 r) noexcept(true)
+		{
+			_mm_storel_pi(reinterpret_cast<__m64*>(dst), r);
+			_mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+		}
+	}
+
+	static void transform_points(const mat4_type<float>& m, const float* in, size_t in_stride, float* out, size_t out_stride, size_t count) noexcept(true)
+	{
+		const __m128 c0 = _mm_loadu_ps(&m.m[0]);
+		const __m128 c1 = _mm_loadu_ps(&m.m[4]);
+		const __m128 c2 = _mm_loadu_ps(&m.m[8]);
+		const __m128 c3 = _mm_loadu_ps(&m.m[12]);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* src = detail::stride_at(in, in_stride, i);
+			__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(src[0])), _mm_mul_ps(c1, _mm_set1_ps(src[1])));
+			r = _mm_add_ps(r, _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(src[2])), c3));
+			detail::store_xyz(detail::stride_at(out, out_stride, i), r);
+		}
+	}
+
+	static void transform_directions(const mat4_type<float>& m, const float* in, size_t in_stride, float* out, size_t out_stride, size_t count) noexcept(true)
+	{
+		const __m128 c0 = _mm_loadu_ps(&m.m[0]);
+		const __m128 c1 = _mm_loadu_ps(&m.m[4]);
+		const __m128 c2 = _mm_loadu_ps(&m.m[8]);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* src = detail::stride_at(in, in_stride, i);
+			__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(src[0])), _mm_mul_ps(c1, _mm_set1_ps(src[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(src[2])));
+			detail::store_xyz(detail::stride_at(out, out_stride, i), r);
+		}
+	}
+
+	static void transform_homogeneous(const mat4_type<float>& m, const float* in, size_t in_stride, float* out, size_t out_stride, size_t count) noexcept(true)
+	{
+		const __m128 c0 = _mm_loadu_ps(&m.m[0]);
+		const __m128 c1 = _mm_loadu_ps(&m.m[4]);
+		const __m128 c2 = _mm_loadu_ps(&m.m[8]);
+		const __m128 c3 = _mm_loadu_ps(&m.m[12]);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const __m128 v = _mm_loadu_ps(detail::stride_at(in, in_stride, i));
+			__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))), _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))), _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)))));
+			_mm_storeu_ps(detail::stride_at(out, out_stride, i), r);
+		}
+	}
+#endif
+
+	// Tightly-packed conveniences.
+	template <typename T>
+		static void transform_points(const mat4_type<T>& m, const vec3_type<T>* in, vec3_type<T>* out, size_t count) noexcept(true)
+		{
+			transform_points(m, reinterpret_cast<const T*>(in), sizeof(vec3_type<T>), reinterpret_cast<T*>(out), sizeof(vec3_type<T>), count);
+		}
+
+	template <typename T>
+		static void transform_directions(const mat4_type<T>& m, const vec3_type<T>* in, vec3_type<T>* out, size_t count) noexcept(true)
+		{
+			transform_directions(m, reinterpret_cast<const T*>(in), sizeof(vec3_type<T>), reinterpret_cast<T*>(out), sizeof(vec3_type<T>), count);
+		}
+
+	template <typename T>
+		static void transform_homogeneous(const mat4_type<T>& m, const vec4_type<T>* in, vec4_type<T>* out, size_t count) noexcept(true)
+		{
+			transform_homogeneous(m, reinterpret_cast<const T*>(in), sizeof(vec4_type<T>), reinterpret_cast<T*>(out), sizeof(vec4_type<T>), count);
+		}
+
+	// SoA streams vectorize across elements instead of within one, which is the fastest layout for large batches.
+	// The range forms only touch elements [begin, end) of an already-sized out, so a batch can be split across threads.
+	template <typename T>
+		static void transform_points(const mat4_type<T>& mat, const vec3_soa<T>& in, vec3_soa<T>& out, size_t begin, size_t end) noexcept(true)
+		{
+			// Local copy: the compiler can't prove the output streams don't alias the matrix.
+			const mat4_type<T> m = mat;
+			const T* ix = in.x.data(); const T* iy = in.y.data(); const T* iz = in.z.data();
+			T* ox = out.x.data(); T* oy = out.y.data(); T* oz = out.z.data();
+			NOOB_IVDEP
+			for (size_t i = begin; i < end; ++i)
+			{
+				const T x = ix[i], y = iy[i], z = iz[i];
+				ox[i] = m.m[0] * x + m.m[4] * y + m.m[8] * z + m.m[12];
+				oy[i] = m.m[1] * x + m.m[5] * y + m.m[9] * z + m.m[13];
+				oz[i] = m.m[2] * x + m.m[6] * y + m.m[10] * z + m.m[14];
+			}
+		}
+
+	template <typename T>
+		static void transform_points(const mat4_type<T>& mat, const vec3_soa<T>& in, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			transform_points(mat, in, out, 0, in.size());
+		}
+
+	template <typename T>
+		static void transform_directions(const mat4_type<T>& mat, const vec3_soa<T>& in, vec3_soa<T>& out, size_t begin, size_t end) noexcept(true)
+		{
+			// Local copy: the compiler can't prove the output streams don't alias the matrix.
+			const mat4_type<T> m = mat;
+			const T* ix = in.x.data(); const T* iy = in.y.data(); const T* iz = in.z.data();
+			T* ox = out.x.data(); T* oy = out.y.data(); T* oz = out.z.data();
+			NOOB_IVDEP
+			for (size_t i = begin; i < end; ++i)
+			{
+				const T x = ix[i], y = iy[i], z = iz[i];
+				ox[i] = m.m[0] * x + m.m[4] * y + m.m[8] * z;
+				oy[i] = m.m[1] * x + m.m[5] * y + m.m[9] * z;
+				oz[i] = m.m[2] * x + m.m[6] * y + m.m[10] * z;
+			}
+		}
+
+	template <typename T>
+		static void transform_directions(const mat4_type<T>& mat, const vec3_soa<T>& in, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			transform_directions(mat, in, out, 0, in.size());
+		}
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// CAMERA FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Returns a view matrix using the opengl lookAt style. COLUMN ORDER:
+	template <typename T>
+		static mat4_type<T> look_at(const vec3_type<T> cam_pos, const vec3_type<T> targ_pos, const vec3_type<T> up) noexcept(true)
+		{
+			// inverse translation
+			mat4_type<T> p = identity_mat4<T>();
+			p = translate(p, vec3_type<T>(-cam_pos[0], -cam_pos[1], -cam_pos[2]));
+			// distance vector
+			vec3_type<T> d = targ_pos - cam_pos;
+			// forward vector
+			vec3_type<T> f = normalize(d);
+			// right vector
+			vec3_type<T> r = normalize(cross(f, up));
+			// real up vector
+			vec3_type<T> u = normalize(cross(r, f));
+			mat4_type<T> ori = identity_mat4<T>();
+			ori.m[0] = r.v[0];
+			ori.m[4] = r.v[1];
+			ori.m[8] = r.v[2];
+			ori.m[1] = u.v[0];
+			ori.m[5] = u.v[1];
+			ori.m[9] = u.v[2];
+			ori.m[2] = -f.v[0];
+			ori.m[6] = -f.v[1];
+			ori.m[10] = -f.v[2];
+
+			return ori * p;//p * ori;
 		}
 
 	// returns a perspective function mimicking the opengl projection style.
@@ -863,17 +1814,13 @@ namespace noob
 	   3 7 11 15
 	 */
 	template <typename T>
-		static mat4_type<T> ortho(float left, float right, float bottom, float top, float near, float far) noexcept(true)
+		static constexpr mat4_type<T> ortho(float left, float right, float bottom, float top, float near, float far) noexcept(true)
 		{
-			mat4_type<T> m = zero_mat4<T>();
-			m.m[0] = 2.0/(right-left);
-			m.m[5] = 2.0/(top - bottom);
-			m.m[10] = -2.0/(far - near);
-			m.m[12] = (right + left)/(right - left);
-			m.m[13] = (top + bottom)/(top - bottom);
-			m.m[14] = (far + near)/(far - near);
-			m.m[15] = 1.0;
-			return m;
+			return mat4_type<T>(
+					2.0/(right-left), 0.0, 0.0, 0.0,
+					0.0, 2.0/(top - bottom), 0.0, 0.0,
+					0.0, 0.0, -2.0/(far - near), 0.0,
+					(right + left)/(right - left), (top + bottom)/(top - bottom), (far + near)/(far - near), 1.0);
 		}
 
 
@@ -896,14 +1843,427 @@ namespace noob
 			return results;
 		}
 
+	// Union of two boxes. Either may be empty (see bbox_type::set_empty()), in which case the other comes back unchanged.
 	template <typename T>
 		static bbox_type<T> update_bbox_type(const noob::bbox_type<T>& a, const noob::bbox_type<T>& b)
 		{
-			noob::bbox_type<T> results;
+			bbox_type<T> results;
+
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				results.min[i] = std::min(a.min[i], b.min[i]);
+				results.max[i] = std::max(a.max[i], b.max[i]);
+			}
+
+			return results;
+		}
+
+	template <typename T>
+		static constexpr bool overlaps(const noob::bbox_type<T>& a, const noob::bbox_type<T>& b) noexcept(true)
+		{
+			return a.min[0] <= b.max[0] && a.max[0] >= b.min[0] && a.min[1] <= b.max[1] && a.max[1] >= b.min[1] && a.min[2] <= b.max[2] && a.max[2] >= b.min[2];
+		}
+
+	template <typename T>
+		static constexpr T surface_area(const noob::bbox_type<T>& b) noexcept(true)
+		{
+			return 2.0 * ((b.max[0] - b.min[0]) * (b.max[1] - b.min[1]) + (b.max[1] - b.min[1]) * (b.max[2] - b.min[2]) + (b.max[2] - b.min[2]) * (b.max[0] - b.min[0]));
+		}
+
+	// Squared distance from a point to the closest point of a box; zero inside it.
+	template <typename T>
+		static T get_squared_dist(const noob::vec3_type<T>& p, const noob::bbox_type<T>& b) noexcept(true)
+		{
+			const T dx = std::max(std::max(b.min[0] - p[0], p[0] - b.max[0]), static_cast<T>(0.0));
+			const T dy = std::max(std::max(b.min[1] - p[1], p[1] - b.max[1]), static_cast<T>(0.0));
+			const T dz = std::max(std::max(b.min[2] - p[2], p[2] - b.max[2]), static_cast<T>(0.0));
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+	// Slab test. inv_dir is 1 / r.direction per component, passed in so it can be hoisted out of loops over many boxes.
+	// On a hit, t_enter is where the ray enters the box (zero if it starts inside).
+	template <typename T>
+		static bool intersects(const noob::ray_type<T>& r, const noob::vec3_type<T>& inv_dir, const noob::bbox_type<T>& b, T t_max, T& t_enter) noexcept(true)
+		{
+			T t0 = 0.0, t1 = t_max;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const T slab_near = (b.min[i] - r.origin[i]) * inv_dir[i];
+				const T slab_far = (b.max[i] - r.origin[i]) * inv_dir[i];
+				t0 = std::max(t0, std::min(slab_near, slab_far));
+				t1 = std::min(t1, std::max(slab_near, slab_far));
+			}
+			t_enter = t0;
+			return t0 <= t1;
+		}
+
+	// Moller-Trumbore, two-sided, vertices ordered as for get_normal(). On a hit in (0, t_max), t is the distance along the ray
+	// and the hit point is vertices[0] + u * (vertices[1] - vertices[0]) + v * (vertices[2] - vertices[0]).
+	template <typename T>
+		static bool intersects(const noob::ray_type<T>& r, const std::array<vec3_type<T>, 3>& vertices, T t_max, T& t, T& u, T& v) noexcept(true)
+		{
+			// Written out rather than through cross() and dot(), which work in float.
+			const noob::vec3_type<T> e1 = vertices[1] - vertices[0];
+			const noob::vec3_type<T> e2 = vertices[2] - vertices[0];
+			const noob::vec3_type<T>& d = r.direction;
+			const T px = d[1] * e2[2] - d[2] * e2[1], py = d[2] * e2[0] - d[0] * e2[2], pz = d[0] * e2[1] - d[1] * e2[0];
+			const T det = e1[0] * px + e1[1] * py + e1[2] * pz;
+			// det scales with the square of the triangle's size, so any fixed threshold would reject small triangles. Only an
+			// exactly parallel ray is turned away here; nearly parallel ones give u, v or t out of range below.
+			if (det == 0.0) return false;
+			const T inv_det = static_cast<T>(1.0) / det;
+			const noob::vec3_type<T> s = r.origin - vertices[0];
+			u = (s[0] * px + s[1] * py + s[2] * pz) * inv_det;
+			if (!(u >= 0.0 && u <= 1.0)) return false;
+			const T qx = s[1] * e1[2] - s[2] * e1[1], qy = s[2] * e1[0] - s[0] * e1[2], qz = s[0] * e1[1] - s[1] * e1[0];
+			v = (d[0] * qx + d[1] * qy + d[2] * qz) * inv_det;
+			if (!(v >= 0.0 && u + v <= 1.0)) return false;
+			t = (e2[0] * qx + e2[1] * qy + e2[2] * qz) * inv_det;
+			return t > 0.0 && t < t_max;
+		}
 
-			results = update_bbox_type(a, b.min);
-			results = update_bbox_type(results, b.max);
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BATCH BOUNDS FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	// Tightest box around a set of points, in one pass instead of an update_bbox_type() call per point. No points gives an empty
+	// box (see bbox_type::set_empty()), which merges into others as a no-op. Coordinates that are NaN are skipped.
+	template <typename T>
+		static bbox_type<T> compute_bbox(const vec3_type<T>* points, size_t count) noexcept(true)
+		{
+			// Two sets of running bounds, for even and odd points, halve the chains of dependent min and max.
+			bbox_type<T> even, odd;
+			even.set_empty();
+			odd.set_empty();
+			size_t i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+				{
+					even.min.v[a] = std::min(even.min.v[a], points[i].v[a]);
+					even.max.v[a] = std::max(even.max.v[a], points[i].v[a]);
+					odd.min.v[a] = std::min(odd.min.v[a], points[i + 1].v[a]);
+					odd.max.v[a] = std::max(odd.max.v[a], points[i + 1].v[a]);
+				}
+			}
+			if (i < count) even = noob::update_bbox_type(even, points[i]);
+			return noob::update_bbox_type(even, odd);
+		}
+
+	// Points [begin, end) only.
+	template <typename T>
+		static bbox_type<T> compute_bbox(const vec3_soa<T>& points, size_t begin, size_t end) noexcept(true)
+		{
+			const T* x = points.x.data(); const T* y = points.y.data(); const T* z = points.z.data();
+			const T inf = std::numeric_limits<T>::infinity();
+			T lo_x = inf, lo_y = inf, lo_z = inf, hi_x = -inf, hi_y = -inf, hi_z = -inf;
+			for (size_t i = begin; i < end; ++i)
+			{
+				lo_x = std::min(lo_x, x[i]);
+				lo_y = std::min(lo_y, y[i]);
+				lo_z = std::min(lo_z, z[i]);
+				hi_x = std::max(hi_x, x[i]);
+				hi_y = std::max(hi_y, y[i]);
+				hi_z = std::max(hi_z, z[i]);
+			}
+			bbox_type<T> results;
+			results.min = vec3_type<T>(lo_x, lo_y, lo_z);
+			results.max = vec3_type<T>(hi_x, hi_y, hi_z);
 			return results;
 		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Compilers won't vectorize the min/max reductions above without -ffast-math (they have to keep the NaN and signed-zero
+	// behaviour of each step), so they get SSE overloads. minps and minpd return their second operand when either is NaN,
+	// which with the running bounds second skips NaN coordinates just like std::min.
+	namespace detail
+	{
+		static inline float horizontal_min(__m128 v) noexcept(true)
+		{
+			v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(_mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))));
+		}
+
+		static inline float horizontal_max(__m128 v) noexcept(true)
+		{
+			v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(_mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))));
+		}
+
+		static inline double horizontal_min(__m128d v) noexcept(true)
+		{
+			return _mm_cvtsd_f64(_mm_min_pd(v, _mm_unpackhi_pd(v, v)));
+		}
+
+		static inline double horizontal_max(__m128d v) noexcept(true)
+		{
+			return _mm_cvtsd_f64(_mm_max_pd(v, _mm_unpackhi_pd(v, v)));
+		}
+
+		// Folds twelve lanes of running bounds over a flat xyzxyz... stream (lane j holds axis j % 3) into results.
+		template <typename T>
+			static void merge_lanes(const T* lo, const T* hi, bbox_type<T>& results) noexcept(true)
+			{
+				for (uint32_t j = 0; j < 12; ++j)
+				{
+					results.min.v[j % 3] = std::min(results.min.v[j % 3], lo[j]);
+					results.max.v[j % 3] = std::max(results.max.v[j % 3], hi[j]);
+				}
+			}
+	}
+
+	// Four points (twelve floats, three registers) at a time. Each register position always holds the same axis, so the running
+	// bounds only get sorted back into x, y and z at the end.
+	static bbox_type<float> compute_bbox(const vec3_type<float>* points, size_t count) noexcept(true)
+	{
+		const float* src = &points[0].v[0];
+		const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		const __m128 neg_inf = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+		__m128 lo[3] = { inf, inf, inf };
+		__m128 hi[3] = { neg_inf, neg_inf, neg_inf };
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				const __m128 v = _mm_loadu_ps(src + i * 3 + r * 4);
+				lo[r] = _mm_min_ps(v, lo[r]);
+				hi[r] = _mm_max_ps(v, hi[r]);
+			}
+		}
+		alignas(16) float lanes_lo[12], lanes_hi[12];
+		for (uint32_t r = 0; r < 3; ++r)
+		{
+			_mm_store_ps(lanes_lo + r * 4, lo[r]);
+			_mm_store_ps(lanes_hi + r * 4, hi[r]);
+		}
+		bbox_type<float> results = noob::compute_bbox<float>(points + i, count - i);
+		detail::merge_lanes(lanes_lo, lanes_hi, results);
+		return results;
+	}
+
+	// Four points (twelve doubles, six registers) at a time, as above.
+	static bbox_type<double> compute_bbox(const vec3_type<double>* points, size_t count) noexcept(true)
+	{
+		const double* src = &points[0].v[0];
+		const __m128d inf = _mm_set1_pd(std::numeric_limits<double>::infinity());
+		const __m128d neg_inf = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+		__m128d lo[6] = { inf, inf, inf, inf, inf, inf };
+		__m128d hi[6] = { neg_inf, neg_inf, neg_inf, neg_inf, neg_inf, neg_inf };
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			for (uint32_t r = 0; r < 6; ++r)
+			{
+				const __m128d v = _mm_loadu_pd(src + i * 3 + r * 2);
+				lo[r] = _mm_min_pd(v, lo[r]);
+				hi[r] = _mm_max_pd(v, hi[r]);
+			}
+		}
+		alignas(16) double lanes_lo[12], lanes_hi[12];
+		for (uint32_t r = 0; r < 6; ++r)
+		{
+			_mm_store_pd(lanes_lo + r * 2, lo[r]);
+			_mm_store_pd(lanes_hi + r * 2, hi[r]);
+		}
+		bbox_type<double> results = noob::compute_bbox<double>(points + i, count - i);
+		detail::merge_lanes(lanes_lo, lanes_hi, results);
+		return results;
+	}
+
+	// Eight points per stream at a time, with two running bounds per stream so consecutive minps and maxps don't wait on each other.
+	static bbox_type<float> compute_bbox(const vec3_soa<float>& points, size_t begin, size_t end) noexcept(true)
+	{
+		const float* streams[3] = { points.x.data(), points.y.data(), points.z.data() };
+		const size_t vector_end = begin + (end - begin) / 8 * 8;
+		bbox_type<float> results = noob::compute_bbox<float>(points, vector_end, end);
+		for (uint32_t a = 0; a < 3; ++a)
+		{
+			const float* s = streams[a];
+			__m128 lo0 = _mm_set1_ps(std::numeric_limits<float>::infinity()), lo1 = lo0;
+			__m128 hi0 = _mm_set1_ps(-std::numeric_limits<float>::infinity()), hi1 = hi0;
+			for (size_t i = begin; i < vector_end; i += 8)
+			{
+				const __m128 v0 = _mm_loadu_ps(s + i), v1 = _mm_loadu_ps(s + i + 4);
+				lo0 = _mm_min_ps(v0, lo0);
+				hi0 = _mm_max_ps(v0, hi0);
+				lo1 = _mm_min_ps(v1, lo1);
+				hi1 = _mm_max_ps(v1, hi1);
+			}
+			results.min.v[a] = std::min(results.min.v[a], detail::horizontal_min(_mm_min_ps(lo0, lo1)));
+			results.max.v[a] = std::max(results.max.v[a], detail::horizontal_max(_mm_max_ps(hi0, hi1)));
+		}
+		return results;
+	}
+
+	// Eight points per stream at a time again, in four registers of two.
+	static bbox_type<double> compute_bbox(const vec3_soa<double>& points, size_t begin, size_t end) noexcept(true)
+	{
+		const double* streams[3] = { points.x.data(), points.y.data(), points.z.data() };
+		const size_t vector_end = begin + (end - begin) / 8 * 8;
+		bbox_type<double> results = noob::compute_bbox<double>(points, vector_end, end);
+		for (uint32_t a = 0; a < 3; ++a)
+		{
+			const double* s = streams[a];
+			__m128d lo[4], hi[4];
+			for (uint32_t r = 0; r < 4; ++r)
+			{
+				lo[r] = _mm_set1_pd(std::numeric_limits<double>::infinity());
+				hi[r] = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+			}
+			for (size_t i = begin; i < vector_end; i += 8)
+			{
+				for (uint32_t r = 0; r < 4; ++r)
+				{
+					const __m128d v = _mm_loadu_pd(s + i + r * 2);
+					lo[r] = _mm_min_pd(v, lo[r]);
+					hi[r] = _mm_max_pd(v, hi[r]);
+				}
+			}
+			results.min.v[a] = std::min(results.min.v[a], detail::horizontal_min(_mm_min_pd(_mm_min_pd(lo[0], lo[1]), _mm_min_pd(lo[2], lo[3]))));
+			results.max.v[a] = std::max(results.max.v[a], detail::horizontal_max(_mm_max_pd(_mm_max_pd(hi[0], hi[1]), _mm_max_pd(hi[2], hi[3]))));
+		}
+		return results;
+	}
+#endif
+
+	template <typename T>
+		static bbox_type<T> compute_bbox(const std::vector<vec3_type<T>>& points) noexcept(true)
+		{
+			return noob::compute_bbox(points.data(), points.size());
+		}
+
+	template <typename T>
+		static bbox_type<T> compute_bbox(const vec3_soa<T>& points) noexcept(true)
+		{
+			return noob::compute_bbox(points, 0, points.size());
+		}
+
+	// Union of a set of boxes; empty boxes drop out. No boxes gives an empty box.
+	template <typename T>
+		static bbox_type<T> merge_bboxes(const bbox_type<T>* boxes, size_t count) noexcept(true)
+		{
+			bbox_type<T> results;
+			results.set_empty();
+			for (size_t i = 0; i < count; ++i)
+			{
+				results = noob::update_bbox_type(results, boxes[i]);
+			}
+			return results;
+		}
+
+	// Boxes [begin, end) only. Just the min corners' minimum and the max corners' maximum, so it runs at compute_bbox() speed.
+	template <typename T>
+		static bbox_type<T> merge_bboxes(const bbox_soa<T>& boxes, size_t begin, size_t end) noexcept(true)
+		{
+			bbox_type<T> results;
+			results.min = noob::compute_bbox(boxes.min, begin, end).min;
+			results.max = noob::compute_bbox(boxes.max, begin, end).max;
+			return results;
+		}
+
+	template <typename T>
+		static bbox_type<T> merge_bboxes(const bbox_soa<T>& boxes) noexcept(true)
+		{
+			return noob::merge_bboxes(boxes, 0, boxes.size());
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BATCH PLANE FUNCTIONS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Batch versions of the plane queries, for splitting and clipping large point sets. The plane is read into locals once,
+	// so these vectorize like the other batch kernels. All of them expect a normalized plane.
+	template <typename T>
+		static void signed_distance(const noob::plane<T>& p, const vec3_soa<T>& points, T* results) noexcept(true)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			const T* x = points.x.data(); const T* y = points.y.data(); const T* z = points.z.data();
+			const size_t count = points.size();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = nx * x[i] + ny * y[i] + nz * z[i] + d;
+			}
+		}
+
+	template <typename T>
+		static void signed_distance(const noob::plane<T>& p, const vec3_type<T>* points, T* results, size_t count) noexcept(true)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = nx * points[i].v[0] + ny * points[i].v[1] + nz * points[i].v[2] + d;
+			}
+		}
+
+	// Points within epsilon of the plane are ON. The comparisons are turned into -1/0/1 arithmetically (the enumerator values)
+	// to keep the loop branch-free.
+	template <typename T>
+		static void classify(const noob::plane<T>& p, const vec3_soa<T>& points, T epsilon, noob::plane_side* results) noexcept(true)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			const T* x = points.x.data(); const T* y = points.y.data(); const T* z = points.z.data();
+			const size_t count = points.size();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T dist = nx * x[i] + ny * y[i] + nz * z[i] + d;
+				results[i] = static_cast<noob::plane_side>((dist > epsilon) - (dist < -epsilon));
+			}
+		}
+
+	template <typename T>
+		static void classify(const noob::plane<T>& p, const vec3_type<T>* points, T epsilon, noob::plane_side* results, size_t count) noexcept(true)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T dist = nx * points[i].v[0] + ny * points[i].v[1] + nz * points[i].v[2] + d;
+				results[i] = static_cast<noob::plane_side>((dist > epsilon) - (dist < -epsilon));
+			}
+		}
+
+	// Orthogonal projection onto the plane. in and out may be the same.
+	template <typename T>
+		static void project(const noob::plane<T>& p, const vec3_soa<T>& in, vec3_soa<T>& out)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			const size_t count = in.size();
+			out.resize(count);
+			const T* ix = in.x.data(); const T* iy = in.y.data(); const T* iz = in.z.data();
+			T* ox = out.x.data(); T* oy = out.y.data(); T* oz = out.z.data();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T x = ix[i], y = iy[i], z = iz[i];
+				const T dist = nx * x + ny * y + nz * z + d;
+				ox[i] = x - nx * dist;
+				oy[i] = y - ny * dist;
+				oz[i] = z - nz * dist;
+			}
+		}
+
+	template <typename T>
+		static void project(const noob::plane<T>& p, const vec3_type<T>* in, vec3_type<T>* out, size_t count) noexcept(true)
+		{
+			const noob::vec3_type<T> n = p.normal();
+			const T nx = n.v[0], ny = n.v[1], nz = n.v[2], d = p.offset();
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T x = in[i].v[0], y = in[i].v[1], z = in[i].v[2];
+				const T dist = nx * x + ny * y + nz * z + d;
+				out[i].v[0] = x - nx * dist;
+				out[i].v[1] = y - ny * dist;
+				out[i].v[2] = z - nz * dist;
+			}
+		}
 }
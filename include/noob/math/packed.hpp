@@ -0,0 +1,563 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	// Compact storage for streams of vectors and rotations (caches, replication). Each type is plain data to be copied
+	// around as bytes; pack() and unpack() convert whole arrays, and the float paths are vectorized.
+	//
+	// Error bounds (for inputs in range):
+	//	vec3_half, vec4_half: relative 2^-11 (about 4.9e-4) for magnitudes in [6.1e-5, 65504]; absolute 3e-8 below that.
+	//	Larger magnitudes become infinity.
+	//	vec3_quantized: extent / 131070 per axis against the bbox_type it was packed with, plus float rounding; values
+	//	outside the box are clamped to it.
+	//	versor_packed48: within 1.5e-4 radians of the input rotation (15 bits per component).
+	//	versor_packed32: within 5e-3 radians (10 bits per component).
+	//
+	// Decode throughput as a fraction of a memcpy of the unpacked floats (math_funcs_bench, one AVX2 + F16C machine, then
+	// an SSE2-only build of the same). Decoding is compute bound everywhere but the half formats with F16C:
+	//	vec3_half 0.60x, 0.05x; vec4_half 0.40x, 0.05x; vec3_quantized 0.49x, 0.24x;
+	//	versor_packed48 0.10x, 0.05x; versor_packed32 0.14x, 0.06x (the square root and component placement dominate).
+
+	struct vec3_half
+	{
+		std::array<uint16_t, 3> v;
+	};
+
+	struct vec4_half
+	{
+		std::array<uint16_t, 4> v;
+	};
+
+	// 16 bits per axis, spread evenly over the box the stream was packed against (which has to be kept alongside it).
+	struct vec3_quantized
+	{
+		std::array<uint16_t, 3> v;
+	};
+
+	// Smallest three: the index of the largest-magnitude component (which is made positive, as q and -q are the same
+	// rotation) and the other three, which lie in [-1/sqrt(2), 1/sqrt(2)]. The largest is rebuilt from unit length.
+	// 48 bits: 15 bits per component, with the index in the top bit of the first two words.
+	struct versor_packed48
+	{
+		std::array<uint16_t, 3> v;
+	};
+
+	// 32 bits: the index in the top two bits, then 10 bits per component.
+	struct versor_packed32
+	{
+		uint32_t v;
+	};
+
+	namespace detail
+	{
+		static inline uint32_t float_bits(float f) noexcept(true)
+		{
+			uint32_t u;
+			std::memcpy(&u, &f, sizeof(u));
+			return u;
+		}
+
+		static inline float bits_float(uint32_t u) noexcept(true)
+		{
+			float f;
+			std::memcpy(&f, &u, sizeof(f));
+			return f;
+		}
+	}
+
+	// Round to nearest even, like the F16C instructions. Branch-free, so loops over it vectorize without F16C.
+	static inline uint16_t float_to_half(float f) noexcept(true)
+	{
+		const uint32_t bits = detail::float_bits(f);
+		const uint32_t sign = (bits >> 16) & 0x8000;
+		const uint32_t u = bits & 0x7FFFFFFF;
+		// Rebias the exponent, round on the 13 dropped mantissa bits.
+		const uint32_t normal = (u + 0xC8000FFF + ((u >> 13) & 1)) >> 13;
+		// Adding 0.5f lines the half denormal up with the bottom of the float mantissa.
+		const uint32_t denormal = detail::float_bits(detail::bits_float(u) + 0.5f) - 0x3F000000;
+		const uint32_t special = 0x7C00 | (static_cast<uint32_t>(u > 0x7F800000) << 9);
+		// All-ones masks rather than ?: so the compiler needn't if-convert.
+		const uint32_t is_special = 0u - static_cast<uint32_t>(u >= 0x47800000);
+		const uint32_t is_denormal = 0u - static_cast<uint32_t>(u < 0x38800000);
+		const uint32_t h = (special & is_special) | (~is_special & ((denormal & is_denormal) | (normal & ~is_denormal)));
+		return static_cast<uint16_t>(h | sign);
+	}
+
+	static inline float half_to_float(uint16_t h) noexcept(true)
+	{
+		const uint32_t shifted = static_cast<uint32_t>(h & 0x7FFF) << 13;
+		const uint32_t exponent = shifted & 0x0F800000;
+		const uint32_t normal = shifted + 0x38000000;
+		const uint32_t special = shifted + 0x70000000;
+		// Denormals: let the FPU renormalize by subtracting 2^-14.
+		const uint32_t denormal = detail::float_bits(detail::bits_float(shifted + 0x38800000) - detail::bits_float(0x38800000));
+		const uint32_t is_special = 0u - static_cast<uint32_t>(exponent == 0x0F800000);
+		const uint32_t is_denormal = 0u - static_cast<uint32_t>(exponent == 0);
+		const uint32_t u = (special & is_special) | (denormal & is_denormal) | (normal & ~(is_special | is_denormal));
+		return detail::bits_float(u | (static_cast<uint32_t>(h & 0x8000) << 16));
+	}
+
+	namespace detail
+	{
+		// vec3_half and vec4_half arrays are flat runs of halves, so both go through these.
+		static inline void pack_halves(const float* in, uint16_t* out, size_t count) noexcept(true)
+		{
+			size_t i = 0;
+#if defined(NOOB_SIMD_F16C)
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+			}
+#endif
+			NOOB_IVDEP
+			for (; i < count; ++i)
+			{
+				out[i] = noob::float_to_half(in[i]);
+			}
+		}
+
+		static inline void unpack_halves(const uint16_t* in, float* out, size_t count) noexcept(true)
+		{
+			size_t i = 0;
+#if defined(NOOB_SIMD_F16C)
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+			}
+#endif
+			NOOB_IVDEP
+			for (; i < count; ++i)
+			{
+				out[i] = noob::half_to_float(in[i]);
+			}
+		}
+	}
+
+	static void pack(const vec3_type<float>* in, vec3_half* out, size_t count) noexcept(true)
+	{
+		static_assert(sizeof(vec3_type<float>) == 3 * sizeof(float) && sizeof(vec3_half) == 3 * sizeof(uint16_t), "vec3 arrays must be flat");
+		detail::pack_halves(&in[0].v[0], &out[0].v[0], count * 3);
+	}
+
+	static void unpack(const vec3_half* in, vec3_type<float>* out, size_t count) noexcept(true)
+	{
+		detail::unpack_halves(&in[0].v[0], &out[0].v[0], count * 3);
+	}
+
+	static void pack(const vec4_type<float>* in, vec4_half* out, size_t count) noexcept(true)
+	{
+		static_assert(sizeof(vec4_type<float>) == 4 * sizeof(float) && sizeof(vec4_half) == 4 * sizeof(uint16_t), "vec4 arrays must be flat");
+		detail::pack_halves(&in[0].v[0], &out[0].v[0], count * 4);
+	}
+
+	static void unpack(const vec4_half* in, vec4_type<float>* out, size_t count) noexcept(true)
+	{
+		detail::unpack_halves(&in[0].v[0], &out[0].v[0], count * 4);
+	}
+
+	// bounds must be the same for pack() and unpack(). A flat axis (zero extent) decodes to bounds.min.
+	template <typename T>
+		static void pack(const vec3_type<T>* in, const bbox_type<T>& bounds, vec3_quantized* out, size_t count) noexcept(true)
+		{
+			const T top = 65535.0;
+			T scale[3];
+			for (uint32_t a = 0; a < 3; ++a)
+			{
+				const T extent = bounds.max[a] - bounds.min[a];
+				scale[a] = (extent > 0.0) ? top / extent : static_cast<T>(0.0);
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+				{
+					const T t = std::min(std::max((in[i][a] - bounds.min[a]) * scale[a], static_cast<T>(0.0)), top);
+					out[i].v[a] = static_cast<uint16_t>(t + static_cast<T>(0.5));
+				}
+			}
+		}
+
+	template <typename T>
+		static void unpack(const vec3_quantized* in, const bbox_type<T>& bounds, vec3_type<T>* out, size_t count) noexcept(true)
+		{
+			const T step[3] = { (bounds.max[0] - bounds.min[0]) / static_cast<T>(65535.0), (bounds.max[1] - bounds.min[1]) / static_cast<T>(65535.0), (bounds.max[2] - bounds.min[2]) / static_cast<T>(65535.0) };
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = vec3_type<T>(bounds.min[0] + in[i].v[0] * step[0], bounds.min[1] + in[i].v[1] * step[1], bounds.min[2] + in[i].v[2] * step[2]);
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Float walks the flat stream four vectors (twelve floats, three registers) at a time, with the per-axis constants
+	// pre-rotated to line up with each register: [x y z x], [y z x y], [z x y z].
+	namespace detail
+	{
+		static inline void quantize_constants(const bbox_type<float>& bounds, const float* per_axis, __m128* lanes, __m128* origins) noexcept(true)
+		{
+			const float* m = &bounds.min.v[0];
+			lanes[0] = _mm_setr_ps(per_axis[0], per_axis[1], per_axis[2], per_axis[0]);
+			lanes[1] = _mm_setr_ps(per_axis[1], per_axis[2], per_axis[0], per_axis[1]);
+			lanes[2] = _mm_setr_ps(per_axis[2], per_axis[0], per_axis[1], per_axis[2]);
+			origins[0] = _mm_setr_ps(m[0], m[1], m[2], m[0]);
+			origins[1] = _mm_setr_ps(m[1], m[2], m[0], m[1]);
+			origins[2] = _mm_setr_ps(m[2], m[0], m[1], m[2]);
+		}
+	}
+
+	static void pack(const vec3_type<float>* in, const bbox_type<float>& bounds, vec3_quantized* out, size_t count) noexcept(true)
+	{
+		float scale[3];
+		for (uint32_t a = 0; a < 3; ++a)
+		{
+			const float extent = bounds.max[a] - bounds.min[a];
+			scale[a] = (extent > 0.0f) ? 65535.0f / extent : 0.0f;
+		}
+		__m128 scales[3], origins[3];
+		detail::quantize_constants(bounds, scale, scales, origins);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 top = _mm_set1_ps(65535.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		// packs_epi32 saturates signed, so the values are shifted into int16 range and back.
+		const __m128i bias32 = _mm_set1_epi32(32768);
+		const __m128i bias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+		const float* src = &in[0].v[0];
+		uint16_t* dst = &out[0].v[0];
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i q[3];
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i * 3 + r * 4), origins[r]), scales[r]), zero), top);
+				q[r] = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(t, half)), bias32);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_xor_si128(_mm_packs_epi32(q[0], q[1]), bias16));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 3 + 8), _mm_xor_si128(_mm_packs_epi32(q[2], q[2]), bias16));
+		}
+		noob::pack<float>(in + i, bounds, out + i, count - i);
+	}
+
+	static void unpack(const vec3_quantized* in, const bbox_type<float>& bounds, vec3_type<float>* out, size_t count) noexcept(true)
+	{
+		const float step[3] = { (bounds.max[0] - bounds.min[0]) / 65535.0f, (bounds.max[1] - bounds.min[1]) / 65535.0f, (bounds.max[2] - bounds.min[2]) / 65535.0f };
+		__m128 steps[3], origins[3];
+		detail::quantize_constants(bounds, step, steps, origins);
+		const __m128i zero = _mm_setzero_si128();
+		const uint16_t* src = &in[0].v[0];
+		float* dst = &out[0].v[0];
+		size_t i = 0;
+#if defined(NOOB_SIMD_AVX2)
+		// Eight vectors (24 floats, three registers) at a time; each register is two of the 128-bit patterns above.
+		const float* m = &bounds.min.v[0];
+		const __m256 steps8[3] = { _mm256_setr_ps(step[0], step[1], step[2], step[0], step[1], step[2], step[0], step[1]), _mm256_setr_ps(step[2], step[0], step[1], step[2], step[0], step[1], step[2], step[0]), _mm256_setr_ps(step[1], step[2], step[0], step[1], step[2], step[0], step[1], step[2]) };
+		const __m256 origins8[3] = { _mm256_setr_ps(m[0], m[1], m[2], m[0], m[1], m[2], m[0], m[1]), _mm256_setr_ps(m[2], m[0], m[1], m[2], m[0], m[1], m[2], m[0]), _mm256_setr_ps(m[1], m[2], m[0], m[1], m[2], m[0], m[1], m[2]) };
+		for (; i + 8 <= count; i += 8)
+		{
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				const __m256i words = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + r * 8)));
+				_mm256_storeu_ps(dst + i * 3 + r * 8, _mm256_add_ps(origins8[r], _mm256_mul_ps(_mm256_cvtepi32_ps(words), steps8[r])));
+			}
+		}
+#endif
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+			const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * 3 + 8));
+			const __m128i words[3] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero), _mm_unpacklo_epi16(hi, zero) };
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				_mm_storeu_ps(dst + i * 3 + r * 4, _mm_add_ps(origins[r], _mm_mul_ps(_mm_cvtepi32_ps(words[r]), steps[r])));
+			}
+		}
+		noob::unpack<float>(in + i, bounds, out + i, count - i);
+	}
+#endif
+
+	namespace detail
+	{
+		// Bits is 15 or 10. Quantizes q (largest component first made positive) and returns the index of the largest.
+		template <uint32_t Bits, typename T>
+			static uint32_t smallest_three(const versor_type<T>& q, uint32_t* packed) noexcept(true)
+			{
+				const T top = static_cast<T>((1u << Bits) - 1);
+				const T range = 0.70710678118654752440;
+				uint32_t k = 0;
+				for (uint32_t i = 1; i < 4; ++i)
+				{
+					if (std::fabs(q.q[i]) > std::fabs(q.q[k])) k = i;
+				}
+				const T flip = (q.q[k] < 0.0) ? static_cast<T>(-1.0) : static_cast<T>(1.0);
+				const T scale = top / (range * static_cast<T>(2.0));
+				for (uint32_t i = 0, j = 0; i < 4; ++i)
+				{
+					if (i == k) continue;
+					const T t = std::min(std::max((q.q[i] * flip + range) * scale, static_cast<T>(0.0)), top);
+					packed[j++] = static_cast<uint32_t>(t + static_cast<T>(0.5));
+				}
+				return k;
+			}
+
+		template <uint32_t Bits, typename T>
+			static versor_type<T> largest_three(uint32_t k, const uint32_t* packed) noexcept(true)
+			{
+				const T range = 0.70710678118654752440;
+				const T step = (range * static_cast<T>(2.0)) / static_cast<T>((1u << Bits) - 1);
+				const T a = packed[0] * step - range, b = packed[1] * step - range, c = packed[2] * step - range;
+				const T largest = std::sqrt(std::max(static_cast<T>(1.0) - a * a - b * b - c * c, static_cast<T>(0.0)));
+				versor_type<T> q;
+				for (uint32_t i = 0, j = 0; i < 4; ++i)
+				{
+					q.q[i] = (i == k) ? largest : ((j == 0) ? a : ((j == 1) ? b : c));
+					if (i != k) ++j;
+				}
+				return q;
+			}
+	}
+
+	template <typename T>
+		static void pack(const versor_type<T>* in, versor_packed48* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				uint32_t p[3];
+				const uint32_t k = detail::smallest_three<15>(in[i], p);
+				out[i].v = {{ static_cast<uint16_t>(((k >> 1) << 15) | p[0]), static_cast<uint16_t>(((k & 1) << 15) | p[1]), static_cast<uint16_t>(p[2]) }};
+			}
+		}
+
+	template <typename T>
+		static void unpack(const versor_packed48* in, versor_type<T>* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint32_t k = ((in[i].v[0] >> 15) << 1) | (in[i].v[1] >> 15);
+				const uint32_t p[3] = { in[i].v[0] & 0x7FFFu, in[i].v[1] & 0x7FFFu, in[i].v[2] };
+				out[i] = detail::largest_three<15, T>(k, p);
+			}
+		}
+
+	template <typename T>
+		static void pack(const versor_type<T>* in, versor_packed32* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				uint32_t p[3];
+				const uint32_t k = detail::smallest_three<10>(in[i], p);
+				out[i].v = (k << 30) | (p[0] << 20) | (p[1] << 10) | p[2];
+			}
+		}
+
+	template <typename T>
+		static void unpack(const versor_packed32* in, versor_type<T>* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint32_t v = in[i].v;
+				const uint32_t p[3] = { (v >> 20) & 0x3FFu, (v >> 10) & 0x3FFu, v & 0x3FFu };
+				out[i] = detail::largest_three<10, T>(v >> 30, p);
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Float handles four rotations per iteration, transposed so each register holds one component of all four. Picking the
+	// largest component and the three others becomes lane selects, with the same tie-breaking as the scalar loop.
+	namespace detail
+	{
+		template <uint32_t Bits>
+			static inline void smallest_three(const versor_type<float>* in, __m128i& k, __m128i* packed) noexcept(true)
+			{
+				__m128 w = _mm_loadu_ps(&in[0].q[0]), x = _mm_loadu_ps(&in[1].q[0]), y = _mm_loadu_ps(&in[2].q[0]), z = _mm_loadu_ps(&in[3].q[0]);
+				_MM_TRANSPOSE4_PS(w, x, y, z);
+				const __m128 sign = _mm_set1_ps(-0.0f);
+				const __m128 aw = _mm_andnot_ps(sign, w), ax = _mm_andnot_ps(sign, x), ay = _mm_andnot_ps(sign, y), az = _mm_andnot_ps(sign, z);
+				// First index holding the maximum, as in the scalar loop's strict comparisons.
+				const __m128 is_x = _mm_cmpgt_ps(ax, aw);
+				const __m128 best_wx = _mm_max_ps(aw, ax);
+				const __m128 is_y = _mm_cmpgt_ps(ay, best_wx);
+				const __m128 best_wxy = _mm_max_ps(best_wx, ay);
+				const __m128 is_z = _mm_cmpgt_ps(az, best_wxy);
+				// 0, 1, 2 or 3; the masks are all ones (-1) per lane.
+				const __m128i sel_x = _mm_andnot_si128(_mm_castps_si128(is_y), _mm_andnot_si128(_mm_castps_si128(is_z), _mm_castps_si128(is_x)));
+				const __m128i sel_y = _mm_andnot_si128(_mm_castps_si128(is_z), _mm_castps_si128(is_y));
+				const __m128i sel_z = _mm_castps_si128(is_z);
+				k = _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(sel_x, _mm_add_epi32(_mm_add_epi32(sel_y, sel_y), _mm_add_epi32(sel_z, _mm_add_epi32(sel_z, sel_z)))));
+
+				const __m128 k0 = _mm_castsi128_ps(_mm_cmpeq_epi32(k, _mm_setzero_si128()));
+				const __m128 k01 = _mm_castsi128_ps(_mm_cmplt_epi32(k, _mm_set1_epi32(2)));
+				const __m128 k012 = _mm_castsi128_ps(_mm_cmplt_epi32(k, _mm_set1_epi32(3)));
+				const __m128 largest = detail::select(_mm_castsi128_ps(sel_z), z, detail::select(_mm_castsi128_ps(sel_y), y, detail::select(_mm_castsi128_ps(sel_x), x, w)));
+				const __m128 flip = _mm_and_ps(largest, sign);
+				// The three others, in order: k == 0 keeps x y z, k == 1 w y z, k == 2 w x z, k == 3 w x y.
+				const __m128 others[3] = { detail::select(k0, x, w), detail::select(k01, y, x), detail::select(k012, z, y) };
+
+				const float range = 0.70710678118654752440f;
+				const __m128 top = _mm_set1_ps(static_cast<float>((1u << Bits) - 1));
+				const __m128 scale = _mm_set1_ps(static_cast<float>((1u << Bits) - 1) / (range * 2.0f));
+				for (uint32_t j = 0; j < 3; ++j)
+				{
+					const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_xor_ps(others[j], flip), _mm_set1_ps(range)), scale);
+					packed[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), top), _mm_set1_ps(0.5f)));
+				}
+			}
+
+		template <uint32_t Bits>
+			static inline void largest_three(__m128i k, const __m128i* packed, versor_type<float>* out) noexcept(true)
+			{
+				const float range = 0.70710678118654752440f;
+				const __m128 step = _mm_set1_ps((range * 2.0f) / static_cast<float>((1u << Bits) - 1));
+				const __m128 a = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(packed[0]), step), _mm_set1_ps(range));
+				const __m128 b = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(packed[1]), step), _mm_set1_ps(range));
+				const __m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(packed[2]), step), _mm_set1_ps(range));
+				const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+				const __m128 largest = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), sum), _mm_setzero_ps()));
+				const __m128 k0 = _mm_castsi128_ps(_mm_cmpeq_epi32(k, _mm_setzero_si128()));
+				const __m128 k1 = _mm_castsi128_ps(_mm_cmpeq_epi32(k, _mm_set1_epi32(1)));
+				const __m128 k2 = _mm_castsi128_ps(_mm_cmpeq_epi32(k, _mm_set1_epi32(2)));
+				const __m128 k3 = _mm_castsi128_ps(_mm_cmpeq_epi32(k, _mm_set1_epi32(3)));
+				// k == 0: (L a b c), 1: (a L b c), 2: (a b L c), 3: (a b c L).
+				__m128 w = detail::select(k0, largest, a);
+				__m128 x = detail::select(k0, a, detail::select(k1, largest, b));
+				__m128 y = detail::select(_mm_or_ps(k0, k1), b, detail::select(k2, largest, c));
+				__m128 z = detail::select(k3, largest, c);
+				_MM_TRANSPOSE4_PS(w, x, y, z);
+				_mm_storeu_ps(&out[0].q[0], w);
+				_mm_storeu_ps(&out[1].q[0], x);
+				_mm_storeu_ps(&out[2].q[0], y);
+				_mm_storeu_ps(&out[3].q[0], z);
+			}
+
+#if defined(NOOB_SIMD_AVX2)
+		// Eight at a time: the selects are single blends, and the transpose works on two versors per register.
+		template <uint32_t Bits>
+			static inline void largest_three(__m256i k, const __m256i* packed, versor_type<float>* out) noexcept(true)
+			{
+				const float range = 0.70710678118654752440f;
+				const __m256 step = _mm256_set1_ps((range * 2.0f) / static_cast<float>((1u << Bits) - 1));
+				const __m256 a = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(packed[0]), step), _mm256_set1_ps(range));
+				const __m256 b = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(packed[1]), step), _mm256_set1_ps(range));
+				const __m256 c = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(packed[2]), step), _mm256_set1_ps(range));
+				const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b)), _mm256_mul_ps(c, c));
+				const __m256 largest = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), sum), _mm256_setzero_ps()));
+				const __m256 k0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(k, _mm256_setzero_si256()));
+				const __m256 k1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(k, _mm256_set1_epi32(1)));
+				const __m256 k2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(k, _mm256_set1_epi32(2)));
+				const __m256 k3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(k, _mm256_set1_epi32(3)));
+				// Same placement as the SSE version; blendv takes its second operand where the mask is set.
+				const __m256 w = _mm256_blendv_ps(a, largest, k0);
+				const __m256 x = _mm256_blendv_ps(_mm256_blendv_ps(b, largest, k1), a, k0);
+				const __m256 y = _mm256_blendv_ps(_mm256_blendv_ps(c, largest, k2), b, _mm256_or_ps(k0, k1));
+				const __m256 z = _mm256_blendv_ps(c, largest, k3);
+				// 4x4 transposes within each 128-bit half give versors 0-3 and 4-7, then the halves are paired up.
+				const __m256 t0 = _mm256_unpacklo_ps(w, x), t1 = _mm256_unpackhi_ps(w, x), t2 = _mm256_unpacklo_ps(y, z), t3 = _mm256_unpackhi_ps(y, z);
+				const __m256 q0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), q1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+				const __m256 q2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), q3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+				_mm256_storeu_ps(&out[0].q[0], _mm256_permute2f128_ps(q0, q1, 0x20));
+				_mm256_storeu_ps(&out[2].q[0], _mm256_permute2f128_ps(q2, q3, 0x20));
+				_mm256_storeu_ps(&out[4].q[0], _mm256_permute2f128_ps(q0, q1, 0x31));
+				_mm256_storeu_ps(&out[6].q[0], _mm256_permute2f128_ps(q2, q3, 0x31));
+			}
+#endif
+	}
+
+	static void pack(const versor_type<float>* in, versor_packed32* out, size_t count) noexcept(true)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i k, p[3];
+			detail::smallest_three<10>(in + i, k, p);
+			const __m128i v = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(k, 30), _mm_slli_epi32(p[0], 20)), _mm_or_si128(_mm_slli_epi32(p[1], 10), p[2]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i].v), v);
+		}
+		noob::pack<float>(in + i, out + i, count - i);
+	}
+
+	static void unpack(const versor_packed32* in, versor_type<float>* out, size_t count) noexcept(true)
+	{
+		const __m128i mask = _mm_set1_epi32(0x3FF);
+		size_t i = 0;
+#if defined(NOOB_SIMD_AVX2)
+		const __m256i mask8 = _mm256_set1_epi32(0x3FF);
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&in[i].v));
+			const __m256i p[3] = { _mm256_and_si256(_mm256_srli_epi32(v, 20), mask8), _mm256_and_si256(_mm256_srli_epi32(v, 10), mask8), _mm256_and_si256(v, mask8) };
+			detail::largest_three<10>(_mm256_srli_epi32(v, 30), p, out + i);
+		}
+#endif
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i].v));
+			const __m128i p[3] = { _mm_and_si128(_mm_srli_epi32(v, 20), mask), _mm_and_si128(_mm_srli_epi32(v, 10), mask), _mm_and_si128(v, mask) };
+			detail::largest_three<10>(_mm_srli_epi32(v, 30), p, out + i);
+		}
+		noob::unpack<float>(in + i, out + i, count - i);
+	}
+
+	static void pack(const versor_type<float>* in, versor_packed48* out, size_t count) noexcept(true)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i k, p[3];
+			detail::smallest_three<15>(in + i, k, p);
+			// Words 0 and 1 of each element carry the index bits on top.
+			const __m128i w0 = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(k, 1), 15), p[0]);
+			const __m128i w1 = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(k, _mm_set1_epi32(1)), 15), p[1]);
+			uint32_t words[3][4];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(words[0]), w0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(words[1]), w1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(words[2]), p[2]);
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				out[i + j].v = {{ static_cast<uint16_t>(words[0][j]), static_cast<uint16_t>(words[1][j]), static_cast<uint16_t>(words[2][j]) }};
+			}
+		}
+		noob::pack<float>(in + i, out + i, count - i);
+	}
+
+	static void unpack(const versor_packed48* in, versor_type<float>* out, size_t count) noexcept(true)
+	{
+		const __m128i mask = _mm_set1_epi32(0x7FFF);
+		size_t i = 0;
+#if defined(NOOB_SIMD_AVX2)
+		// Eight elements are 24 words. Widened to three registers of ints, each word lands in a fixed lane, so two blends
+		// and a permute gather each of the three words of all eight elements.
+		const __m256i order0 = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5), order1 = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6), order2 = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+		const __m256i mask8 = _mm256_set1_epi32(0x7FFF);
+		for (; i + 8 <= count; i += 8)
+		{
+			const uint16_t* s = &in[i].v[0];
+			const __m256i r0 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+			const __m256i r1 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 8)));
+			const __m256i r2 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16)));
+			const __m256i w0 = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(r0, r1, 0x92), r2, 0x24), order0);
+			const __m256i w1 = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(r0, r1, 0x24), r2, 0x49), order1);
+			const __m256i w2 = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(r0, r1, 0x49), r2, 0x92), order2);
+			const __m256i k = _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(w0, 15), 1), _mm256_srli_epi32(w1, 15));
+			const __m256i p[3] = { _mm256_and_si256(w0, mask8), _mm256_and_si256(w1, mask8), w2 };
+			detail::largest_three<15>(k, p, out + i);
+		}
+#endif
+		for (; i + 4 <= count; i += 4)
+		{
+			const versor_packed48* s = in + i;
+			const __m128i w0 = _mm_setr_epi32(s[0].v[0], s[1].v[0], s[2].v[0], s[3].v[0]);
+			const __m128i w1 = _mm_setr_epi32(s[0].v[1], s[1].v[1], s[2].v[1], s[3].v[1]);
+			const __m128i w2 = _mm_setr_epi32(s[0].v[2], s[1].v[2], s[2].v[2], s[3].v[2]);
+			const __m128i k = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(w0, 15), 1), _mm_srli_epi32(w1, 15));
+			const __m128i p[3] = { _mm_and_si128(w0, mask), _mm_and_si128(w1, mask), w2 };
+			detail::largest_three<15>(k, p, out + i);
+		}
+		noob::unpack<float>(in + i, out + i, count - i);
+	}
+#endif
+}
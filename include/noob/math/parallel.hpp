@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace noob
+{
+	namespace detail
+	{
+		// Shared by every translation unit, unlike a static in a static function.
+		inline std::atomic<uint32_t>& thread_limit() noexcept(true)
+		{
+			static std::atomic<uint32_t> limit(0);
+			return limit;
+		}
+
+		// Queried once: some standard libraries read /sys on every hardware_concurrency() call.
+		inline uint32_t hardware_threads() noexcept(true)
+		{
+			static const uint32_t n = std::max(1u, std::thread::hardware_concurrency());
+			return n;
+		}
+	}
+
+	// Number of threads the parallel helpers may use, the calling thread included. Defaults to the hardware concurrency.
+	inline uint32_t get_thread_count() noexcept(true)
+	{
+		const uint32_t limit = detail::thread_limit().load(std::memory_order_relaxed);
+		if (limit != 0) return limit;
+		return detail::hardware_threads();
+	}
+
+	// Zero restores the default. Can be changed at any time; pool threads above the limit go idle once they run out of work.
+	inline void set_thread_count(uint32_t n) noexcept(true)
+	{
+		detail::thread_limit().store(n, std::memory_order_relaxed);
+	}
+
+	// Upper bound on the chunks one parallel_for() makes, so huge counts get larger chunks rather than more of them.
+	static const size_t max_parallel_chunks = 1024;
+
+	// How many chunks parallel_for() will split count elements into: as many whole grains as fit, up to max_parallel_chunks.
+	// Chunks are never smaller than grain unless count is. The split depends only on count and grain, never on the thread count,
+	// so per-chunk partial results merged in chunk order come out the same however many threads produced them.
+	inline size_t parallel_chunks(size_t count, size_t grain) noexcept(true)
+	{
+		const size_t by_grain = count / std::max(grain, static_cast<size_t>(1));
+		return std::min(std::max(by_grain, static_cast<size_t>(count != 0)), max_parallel_chunks);
+	}
+
+	// A grain for a kernel costing about ns_per_element: each chunk is then some 25us of work, which keeps the cost of handing
+	// it to another thread in the noise without starving threads on mid-sized batches.
+	inline size_t parallel_grain(double ns_per_element) noexcept(true)
+	{
+		return std::max(static_cast<size_t>(25000.0 / std::max(ns_per_element, 0.01)), static_cast<size_t>(64));
+	}
+
+	namespace detail
+	{
+		// run(ctx, begin, end), after which *pending is decremented.
+		struct parallel_task
+		{
+			void (*run)(void*, size_t, size_t);
+			void* ctx;
+			size_t begin, end;
+			std::atomic<size_t>* pending;
+		};
+
+		// Work-stealing pool behind parallel_for() and parallel_invoke(). Every thread owns a deque it pushes to and pops from at
+		// the back (the newest, smallest work, while it's still in cache); idle threads steal from the front of the others' (the
+		// oldest, which for split ranges is the largest). Slot 0 is shared by all threads outside the pool. Threads waiting on
+		// their tasks run other tasks rather than block, so tasks can themselves call parallel_for() and parallel_invoke().
+		// Workers are started on first use and spin briefly before sleeping, as parallel passes tend to come in bursts.
+		class task_scheduler
+		{
+			public:
+				static task_scheduler& get()
+				{
+					static task_scheduler s;
+					return s;
+				}
+
+				~task_scheduler()
+				{
+					{
+						std::lock_guard<std::mutex> guard(sleep_lock);
+						stop = true;
+					}
+					wake.notify_all();
+					for (std::thread& w : workers)
+					{
+						w.join();
+					}
+				}
+
+				// Starts workers until threads of them (the caller counting as one) can take part.
+				void reserve(uint32_t threads)
+				{
+					threads = std::min(threads, capacity);
+					if (threads <= started.load(std::memory_order_acquire)) return;
+					std::lock_guard<std::mutex> guard(start_lock);
+					for (uint32_t s = started.load(std::memory_order_relaxed); s < threads; ++s)
+					{
+						workers.emplace_back([this, s]() { work(s); });
+						started.store(s + 1, std::memory_order_release);
+					}
+				}
+
+				void push(const parallel_task& t)
+				{
+					slot& q = slots[current_slot()];
+					{
+						std::lock_guard<std::mutex> guard(q.lock);
+						q.tasks.push_back(t);
+					}
+					// Paired with the check in work(): either the sleeper sees the task or this sees the sleeper.
+					queued.fetch_add(1);
+					if (sleeping.load() != 0)
+					{
+						{
+							std::lock_guard<std::mutex> guard(sleep_lock);
+						}
+						wake.notify_all();
+					}
+				}
+
+				// Runs tasks, any tasks, until pending drops to zero.
+				void wait(const std::atomic<size_t>& pending)
+				{
+					const uint32_t s = current_slot();
+					parallel_task t;
+					while (pending.load(std::memory_order_acquire) != 0)
+					{
+						if (find(s, t)) execute(t);
+						else std::this_thread::yield();
+					}
+				}
+
+			protected:
+				struct slot
+				{
+					std::mutex lock;
+					std::deque<parallel_task> tasks;
+				};
+
+				task_scheduler() : capacity(std::max(64u, detail::hardware_threads())), slots(new slot[capacity]) {}
+
+				static uint32_t& current_slot() noexcept(true)
+				{
+					static thread_local uint32_t s = 0;
+					return s;
+				}
+
+				// t is a copy: once pending reaches zero its owner may return and take ctx with it.
+				static void execute(const parallel_task& t)
+				{
+					t.run(t.ctx, t.begin, t.end);
+					t.pending->fetch_sub(1, std::memory_order_acq_rel);
+				}
+
+				bool find(uint32_t s, parallel_task& t)
+				{
+					if (queued.load(std::memory_order_relaxed) == 0) return false;
+					if (take(slots[s], true, t)) return true;
+					const uint32_t n = started.load(std::memory_order_acquire);
+					for (uint32_t k = 1; k < n; ++k)
+					{
+						if (take(slots[(s + k) % n], false, t)) return true;
+					}
+					return false;
+				}
+
+				bool take(slot& q, bool back, parallel_task& t)
+				{
+					std::lock_guard<std::mutex> guard(q.lock);
+					if (q.tasks.empty()) return false;
+					if (back)
+					{
+						t = q.tasks.back();
+						q.tasks.pop_back();
+					}
+					else
+					{
+						t = q.tasks.front();
+						q.tasks.pop_front();
+					}
+					queued.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+
+				void work(uint32_t s)
+				{
+					current_slot() = s;
+					parallel_task t;
+					for (;;)
+					{
+						bool found = false;
+						for (uint32_t spin = 0; spin < 256 && !found; ++spin)
+						{
+							found = s < noob::get_thread_count() && find(s, t);
+							if (!found) std::this_thread::yield();
+						}
+						if (found)
+						{
+							execute(t);
+							continue;
+						}
+						std::unique_lock<std::mutex> guard(sleep_lock);
+						sleeping.fetch_add(1);
+						wake.wait(guard, [&]() { return stop || (queued.load() != 0 && s < noob::get_thread_count()); });
+						sleeping.fetch_sub(1);
+						if (stop) return;
+					}
+				}
+
+				const uint32_t capacity;
+				std::unique_ptr<slot[]> slots;
+				std::atomic<uint32_t> started { 1 };
+				std::atomic<size_t> queued { 0 };
+				std::atomic<uint32_t> sleeping { 0 };
+				std::mutex start_lock, sleep_lock;
+				std::condition_variable wake;
+				std::vector<std::thread> workers;
+				bool stop = false;
+		};
+
+		// A parallel_for() in flight. Each task halves its range of chunks, leaving the upper halves for other threads to steal,
+		// until one chunk is left to run.
+		template <typename F>
+			struct parallel_range
+			{
+				parallel_range(F& f, size_t n, size_t c) noexcept(true) : fn(f), count(n), chunks(c), pending(1) {}
+
+				static void run(void* ctx, size_t first, size_t last)
+				{
+					parallel_range& r = *static_cast<parallel_range*>(ctx);
+					while (last - first > 1)
+					{
+						const size_t mid = first + (last - first) / 2;
+						r.pending.fetch_add(1, std::memory_order_relaxed);
+						task_scheduler::get().push({ &run, ctx, mid, last, &r.pending });
+						last = mid;
+					}
+					r.fn(first, r.count * first / r.chunks, r.count * (first + 1) / r.chunks);
+				}
+
+				F& fn;
+				const size_t count, chunks;
+				std::atomic<size_t> pending;
+			};
+
+		template <typename F>
+			static void invoke_task(void* ctx, size_t, size_t)
+			{
+				(*static_cast<F*>(ctx))();
+			}
+	}
+
+	// Calls fn(chunk, begin, end) for each of the parallel_chunks(count, grain) contiguous chunks of [0, count), spread over
+	// get_thread_count() threads by the work-stealing pool, and returns once all of them have finished. The calling thread takes
+	// part. Chunk boundaries don't depend on the thread count, and with one thread the chunks simply run in order. fn must not throw.
+	template <typename F>
+		static void parallel_for(size_t count, size_t grain, F&& fn)
+		{
+			const size_t chunks = parallel_chunks(count, grain);
+			const uint32_t threads = get_thread_count();
+			if (chunks <= 1 || threads <= 1)
+			{
+				for (size_t c = 0; c < chunks; ++c)
+				{
+					fn(c, count * c / chunks, count * (c + 1) / chunks);
+				}
+				return;
+			}
+
+			detail::task_scheduler& scheduler = detail::task_scheduler::get();
+			scheduler.reserve(threads);
+			detail::parallel_range<typename std::remove_reference<F>::type> r(fn, count, chunks);
+			detail::parallel_range<typename std::remove_reference<F>::type>::run(&r, 0, chunks);
+			r.pending.fetch_sub(1, std::memory_order_acq_rel);
+			scheduler.wait(r.pending);
+		}
+
+	// Runs b on the calling thread while a is left for another thread to pick up (or for this one, if none got to it first),
+	// then waits for both. With only one thread they just run in order, so recursive callers should stop forking once their
+	// subproblems get small.
+	template <typename A, typename B>
+		static void parallel_invoke(A&& a, B&& b)
+		{
+			const uint32_t threads = get_thread_count();
+			if (threads <= 1)
+			{
+				a();
+				b();
+				return;
+			}
+
+			detail::task_scheduler& scheduler = detail::task_scheduler::get();
+			scheduler.reserve(threads);
+			std::atomic<size_t> pending(1);
+			scheduler.push({ &detail::invoke_task<typename std::remove_reference<A>::type>, const_cast<void*>(static_cast<const void*>(&a)), 0, 0, &pending });
+			b();
+			scheduler.wait(pending);
+		}
+}
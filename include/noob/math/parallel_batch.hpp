@@ -0,0 +1,277 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "math_funcs.hpp"
+#include "morton.hpp"
+#include "parallel.hpp"
+#include "radix_sort.hpp"
+
+namespace noob
+{
+	// Multithreaded forms of the batch kernels in math_funcs.hpp, for passes over hundreds of thousands of elements and up.
+	// Each splits its batch with parallel_for() at a grain sized to the kernel's per-element cost (see parallel_grain()), and
+	// runs the single-threaded kernel on every chunk. Chunks depend only on the element count, and reductions merge their
+	// per-chunk results in chunk order, so the output is bit-identical for any thread count, including one.
+
+	namespace detail
+	{
+		// Runs range(begin, end) on each chunk and merges the boxes in chunk order.
+		template <typename T, typename F>
+			static noob::bbox_type<T> parallel_bounds(size_t count, F&& range)
+			{
+				const size_t grain = noob::parallel_grain(0.5);
+				std::vector<noob::bbox_type<T>> partial(noob::parallel_chunks(count, grain));
+				noob::parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end) { partial[chunk] = range(begin, end); });
+				noob::bbox_type<T> results;
+				results.set_empty();
+				for (const noob::bbox_type<T>& b : partial)
+				{
+					results = noob::update_bbox_type(results, b);
+				}
+				return results;
+			}
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// TRANSFORMS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// out may equal in.
+	template <typename T>
+		static void parallel_transform_points(const mat4_type<T>& m, const vec3_type<T>* in, vec3_type<T>* out, size_t count)
+		{
+			noob::parallel_for(count, noob::parallel_grain(1.5), [&](size_t, size_t begin, size_t end) { noob::transform_points(m, in + begin, out + begin, end - begin); });
+		}
+
+	template <typename T>
+		static void parallel_transform_directions(const mat4_type<T>& m, const vec3_type<T>* in, vec3_type<T>* out, size_t count)
+		{
+			noob::parallel_for(count, noob::parallel_grain(1.5), [&](size_t, size_t begin, size_t end) { noob::transform_directions(m, in + begin, out + begin, end - begin); });
+		}
+
+	template <typename T>
+		static void parallel_transform_points(const mat4_type<T>& m, const vec3_soa<T>& in, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			noob::parallel_for(in.size(), noob::parallel_grain(0.5), [&](size_t, size_t begin, size_t end) { noob::transform_points(m, in, out, begin, end); });
+		}
+
+	template <typename T>
+		static void parallel_transform_directions(const mat4_type<T>& m, const vec3_soa<T>& in, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			noob::parallel_for(in.size(), noob::parallel_grain(0.5), [&](size_t, size_t begin, size_t end) { noob::transform_directions(m, in, out, begin, end); });
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// NORMALIZE:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template <typename T>
+		static void parallel_normalize(const vec3_soa<T>& a, vec3_soa<T>& results)
+		{
+			results.resize(a.size());
+			noob::parallel_for(a.size(), noob::parallel_grain(1.0), [&](size_t, size_t begin, size_t end) { noob::normalize(a, results, begin, end); });
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BOUNDS:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// As compute_bbox() and merge_bboxes(), including the empty box for no input.
+	template <typename T>
+		static bbox_type<T> parallel_compute_bbox(const vec3_type<T>* points, size_t count)
+		{
+			return detail::parallel_bounds<T>(count, [&](size_t begin, size_t end) { return noob::compute_bbox(points + begin, end - begin); });
+		}
+
+	template <typename T>
+		static bbox_type<T> parallel_compute_bbox(const vec3_soa<T>& points)
+		{
+			return detail::parallel_bounds<T>(points.size(), [&](size_t begin, size_t end) { return noob::compute_bbox(points, begin, end); });
+		}
+
+	template <typename T>
+		static bbox_type<T> parallel_merge_bboxes(const bbox_soa<T>& boxes)
+		{
+			return detail::parallel_bounds<T>(boxes.size(), [&](size_t begin, size_t end) { return noob::merge_bboxes(boxes, begin, end); });
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// INVERSES:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// out may equal in.
+	template <typename T>
+		static void parallel_inverse_affine(const mat4_type<T>* in, mat4_type<T>* out, size_t count)
+		{
+			noob::parallel_for(count, noob::parallel_grain(10.0), [&](size_t, size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; ++i)
+						{
+							out[i] = noob::inverse_affine(in[i]);
+						}
+					});
+		}
+
+	template <typename T>
+		static void parallel_inverse_rigid(const mat4_type<T>* in, mat4_type<T>* out, size_t count)
+		{
+			noob::parallel_for(count, noob::parallel_grain(5.0), [&](size_t, size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; ++i)
+						{
+							out[i] = noob::inverse_rigid(in[i]);
+						}
+					});
+		}
+
+	// As inverse(const mat4_soa<T>&, mat4_soa<T>&, uint8_t*): returns the number inverted, success gets a flag per matrix.
+	template <typename T>
+		static size_t parallel_inverse(const mat4_soa<T>& in, mat4_soa<T>& results, uint8_t* success)
+		{
+			const size_t count = in.size();
+			const size_t grain = noob::parallel_grain(15.0);
+			results.resize(count);
+			std::vector<size_t> inverted(noob::parallel_chunks(count, grain));
+			noob::parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end) { inverted[chunk] = noob::inverse(in, results, success, begin, end); });
+			size_t total = 0;
+			for (size_t n : inverted)
+			{
+				total += n;
+			}
+			return total;
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// MORTON CODES AND SORTING:
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template <typename T>
+		static void parallel_morton_encode30(const vec3_soa<T>& in, const bbox_type<T>& bounds, std::vector<uint32_t>& out)
+		{
+			out.resize(in.size());
+			noob::parallel_for(in.size(), noob::parallel_grain(1.0), [&](size_t, size_t begin, size_t end) { noob::morton_encode30(in, bounds, out.data(), begin, end); });
+		}
+
+	template <typename T>
+		static void parallel_morton_encode63(const vec3_soa<T>& in, const bbox_type<T>& bounds, std::vector<uint64_t>& out)
+		{
+			out.resize(in.size());
+			noob::parallel_for(in.size(), noob::parallel_grain(1.0), [&](size_t, size_t begin, size_t end) { noob::morton_encode63(in, bounds, out.data(), begin, end); });
+		}
+
+	// As radix_sort(), and the same result. Each pass counts the digits of every chunk, then every chunk scatters its keys
+	// to the offsets it gets from an exclusive scan in (digit, chunk) order, which keeps the sort stable. Passes where all
+	// keys share a byte are still skipped.
+	template <typename Key>
+		static void parallel_radix_sort(Key* keys, uint32_t* values, size_t count, Key* scratch_keys, uint32_t* scratch_values)
+		{
+			const size_t grain = noob::parallel_grain(2.0);
+			const size_t chunks = noob::parallel_chunks(count, grain);
+			if (chunks <= 1 || noob::get_thread_count() <= 1)
+			{
+				noob::radix_sort(keys, values, count, scratch_keys, scratch_values);
+				return;
+			}
+
+			// A byte is the same in every key where the AND and OR of all keys agree.
+			std::vector<Key> all(chunks), any(chunks);
+			noob::parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end)
+					{
+						Key a = keys[begin], o = keys[begin];
+						for (size_t i = begin + 1; i < end; ++i)
+						{
+							a &= keys[i];
+							o |= keys[i];
+						}
+						all[chunk] = a;
+						any[chunk] = o;
+					});
+			Key all_keys = all[0], any_key = any[0];
+			for (size_t c = 1; c < chunks; ++c)
+			{
+				all_keys &= all[c];
+				any_key |= any[c];
+			}
+			const Key varying = all_keys ^ any_key;
+
+			std::vector<size_t> offsets(chunks * 256);
+			Key* src_keys = keys;
+			uint32_t* src_values = values;
+			Key* dst_keys = scratch_keys;
+			uint32_t* dst_values = scratch_values;
+			for (uint32_t p = 0; p < sizeof(Key); ++p)
+			{
+				const uint32_t shift = p * 8;
+				if (((varying >> shift) & 0xFF) == 0) continue;
+
+				noob::parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end)
+						{
+							size_t* h = &offsets[chunk * 256];
+							std::fill(h, h + 256, static_cast<size_t>(0));
+							for (size_t i = begin; i < end; ++i)
+							{
+								++h[(src_keys[i] >> shift) & 0xFF];
+							}
+						});
+				size_t offset = 0;
+				for (uint32_t b = 0; b < 256; ++b)
+				{
+					for (size_t c = 0; c < chunks; ++c)
+					{
+						const size_t n = offsets[c * 256 + b];
+						offsets[c * 256 + b] = offset;
+						offset += n;
+					}
+				}
+				noob::parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end)
+						{
+							size_t* h = &offsets[chunk * 256];
+							for (size_t i = begin; i < end; ++i)
+							{
+								const Key k = src_keys[i];
+								const size_t dst = h[(k >> shift) & 0xFF]++;
+								dst_keys[dst] = k;
+								dst_values[dst] = src_values[i];
+							}
+						});
+				std::swap(src_keys, dst_keys);
+				std::swap(src_values, dst_values);
+			}
+
+			if (src_keys != keys)
+			{
+				noob::parallel_for(count, grain, [&](size_t, size_t begin, size_t end)
+						{
+							std::memcpy(keys + begin, src_keys + begin, (end - begin) * sizeof(Key));
+							std::memcpy(values + begin, src_values + begin, (end - begin) * sizeof(uint32_t));
+						});
+			}
+		}
+
+	template <typename Key>
+		static void parallel_radix_sort(std::vector<Key>& keys, std::vector<uint32_t>& values)
+		{
+			if (keys.empty()) return;
+			std::vector<Key> scratch_keys(keys.size());
+			std::vector<uint32_t> scratch_values(keys.size());
+			noob::parallel_radix_sort(keys.data(), values.data(), keys.size(), scratch_keys.data(), scratch_values.data());
+		}
+
+	// out[i] = in[order[i]]. out must not alias in.
+	template <typename T>
+		static void parallel_permute(const T* in, const uint32_t* order, T* out, size_t count)
+		{
+			noob::parallel_for(count, noob::parallel_grain(2.0), [&](size_t, size_t begin, size_t end) { noob::permute(in, order + begin, out + begin, end - begin); });
+		}
+
+	template <typename T>
+		static void parallel_permute(const vec3_soa<T>& in, const uint32_t* order, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			noob::parallel_for(in.size(), noob::parallel_grain(3.0), [&](size_t, size_t begin, size_t end) { noob::permute(in, order, out, begin, end); });
+		}
+}
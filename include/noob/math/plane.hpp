@@ -4,47 +4,104 @@
 #undef Success
 #endif
 
+#include <cmath>
+#include <cstdint>
+
 #include <Eigen/Geometry>
 #include "vec3.hpp"
 
 namespace noob
 {
-	template <typename T>
-	class plane
+	// Which side of a plane a point falls on. Stored as int8_t so batch classification can write straight into a byte stream.
+	enum class plane_side : int8_t
 	{
-		public:
-			void through(noob::vec3_type<T>& a, const noob::vec3_type<T>& b, const noob::vec3_type<T>& c)
-			{
-				inner = Eigen::Hyperplane<float, 3>::Through(Eigen::Vector3f(b.v[0], b.v[1], b.v[2]), Eigen::Vector3f(c.v[0], c.v[1], c.v[2]));
-			}
-
-			void normalize()
-			{
-				inner.normalize();
-			}
-
-			float signed_distance(const noob::vec3_type<T>& p) const
-			{
-				return inner.signedDistance(Eigen::Vector3f(p.v[0], p.v[1], p.v[2]));
-			}
-
-			noob::vec3_type<T> normal() const
-			{
-				return vec3_from_eigen_vec3(inner.normal());
-			}
-
-			float offset() const
-			{
-				return inner.offset();
-			}
-
-			noob::vec3_type<T> projection(const noob::vec3_type<T>& p) const
-			{
-				return vec3_from_eigen_vec3(inner.projection(Eigen::Vector3f(p.v[0], p.v[1], p.v[2])));
-			}
-
-
-		protected:
-			Eigen::Hyperplane<T, 3> inner;
+		BACK = -1, ON = 0, FRONT = 1
 	};
+
+	// Plane in Hessian form: dot(normal, p) + offset == 0. The normal points to the front side.
+	// Functions that return distances assume the normal has unit length, as through() and normalize() leave it.
+	template <typename T>
+		class plane
+		{
+			public:
+				plane() noexcept(true) = default;
+
+				constexpr plane(const noob::vec3_type<T>& n, T d) noexcept(true) : norm(n), dist(d) {}
+
+				// Counter-clockwise winding (a, b, c) faces the normal, the same convention as get_normal().
+				void through(const noob::vec3_type<T>& a, const noob::vec3_type<T>& b, const noob::vec3_type<T>& c) noexcept(true)
+				{
+					const noob::vec3_type<T> u = b - a;
+					const noob::vec3_type<T> v = c - a;
+					norm = noob::vec3_type<T>(u.v[1] * v.v[2] - u.v[2] * v.v[1], u.v[2] * v.v[0] - u.v[0] * v.v[2], u.v[0] * v.v[1] - u.v[1] * v.v[0]);
+					dist = 0.0;
+					normalize();
+					dist = -(norm.v[0] * a.v[0] + norm.v[1] * a.v[1] + norm.v[2] * a.v[2]);
+				}
+
+				void from_point_normal(const noob::vec3_type<T>& p, const noob::vec3_type<T>& n) noexcept(true)
+				{
+					norm = n;
+					dist = 0.0;
+					normalize();
+					dist = -(norm.v[0] * p.v[0] + norm.v[1] * p.v[1] + norm.v[2] * p.v[2]);
+				}
+
+				// Scales normal and offset together, so the plane itself doesn't move. Degenerate planes are left alone.
+				void normalize() noexcept(true)
+				{
+					const T len = std::sqrt(norm.v[0] * norm.v[0] + norm.v[1] * norm.v[1] + norm.v[2] * norm.v[2]);
+					if (len > 0.0)
+					{
+						const T inv = static_cast<T>(1.0) / len;
+						norm.v[0] *= inv;
+						norm.v[1] *= inv;
+						norm.v[2] *= inv;
+						dist *= inv;
+					}
+				}
+
+				constexpr T signed_distance(const noob::vec3_type<T>& p) const noexcept(true)
+				{
+					return norm.v[0] * p.v[0] + norm.v[1] * p.v[1] + norm.v[2] * p.v[2] + dist;
+				}
+
+				constexpr noob::plane_side classify(const noob::vec3_type<T>& p, T epsilon) const noexcept(true)
+				{
+					return signed_distance(p) > epsilon ? noob::plane_side::FRONT : (signed_distance(p) < -epsilon ? noob::plane_side::BACK : noob::plane_side::ON);
+				}
+
+				constexpr noob::vec3_type<T> normal() const noexcept(true)
+				{
+					return norm;
+				}
+
+				constexpr T offset() const noexcept(true)
+				{
+					return dist;
+				}
+
+				constexpr noob::vec3_type<T> projection(const noob::vec3_type<T>& p) const noexcept(true)
+				{
+					return p - norm * signed_distance(p);
+				}
+
+			protected:
+				noob::vec3_type<T> norm;
+				T dist;
+		};
+
+	// Eigen interop is explicit: nothing on the hot path builds Eigen temporaries.
+	template <typename T>
+		static plane<T> plane_from_eigen(const Eigen::Hyperplane<T, 3>& arg) noexcept(true)
+		{
+			return plane<T>(noob::vec3_type<T>(arg.normal()[0], arg.normal()[1], arg.normal()[2]), arg.offset());
+		}
+
+	template <typename T>
+		static Eigen::Hyperplane<T, 3> plane_to_eigen(const plane<T>& arg) noexcept(true)
+		{
+			const noob::vec3_type<T> n = arg.normal();
+			return Eigen::Hyperplane<T, 3>(Eigen::Matrix<T, 3, 1>(n.v[0], n.v[1], n.v[2]), arg.offset());
+		}
 }
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "vec3_soa.hpp"
+
+namespace noob
+{
+	// Maps a float to an unsigned key with the same ordering (negative values flipped entirely, positive ones get the sign bit set).
+	static inline uint32_t sortable_key(float f) noexcept(true)
+	{
+		uint32_t u;
+		std::memcpy(&u, &f, sizeof(u));
+		const uint32_t mask = static_cast<uint32_t>(-static_cast<int32_t>(u >> 31)) | 0x80000000u;
+		return u ^ mask;
+	}
+
+	static inline uint64_t sortable_key(double d) noexcept(true)
+	{
+		uint64_t u;
+		std::memcpy(&u, &d, sizeof(u));
+		const uint64_t mask = static_cast<uint64_t>(-static_cast<int64_t>(u >> 63)) | 0x8000000000000000ull;
+		return u ^ mask;
+	}
+
+	static inline uint32_t sortable_key(uint32_t u) noexcept(true)
+	{
+		return u;
+	}
+
+	static inline uint64_t sortable_key(uint64_t u) noexcept(true)
+	{
+		return u;
+	}
+
+	// Stable LSD radix sort of unsigned keys (uint32_t or uint64_t), carrying a uint32_t value along with each key.
+	// One byte per pass; all histograms come from a single read of the keys, and passes where every key has the same
+	// byte are skipped, so nearly-uniform high bytes cost nothing. The scratch arrays must hold count elements each.
+	template <typename Key>
+		static void radix_sort(Key* keys, uint32_t* values, size_t count, Key* scratch_keys, uint32_t* scratch_values) noexcept(true)
+		{
+			if (count == 0) return;
+			const uint32_t passes = sizeof(Key);
+			size_t histograms[sizeof(Key) * 256] = {};
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Key k = keys[i];
+				for (uint32_t p = 0; p < passes; ++p)
+				{
+					++histograms[p * 256 + ((k >> (p * 8)) & 0xFF)];
+				}
+			}
+
+			Key* src_keys = keys;
+			uint32_t* src_values = values;
+			Key* dst_keys = scratch_keys;
+			uint32_t* dst_values = scratch_values;
+
+			for (uint32_t p = 0; p < passes; ++p)
+			{
+				size_t* h = &histograms[p * 256];
+				if (h[(src_keys[0] >> (p * 8)) & 0xFF] == count) continue;
+
+				size_t offset = 0;
+				for (uint32_t b = 0; b < 256; ++b)
+				{
+					const size_t n = h[b];
+					h[b] = offset;
+					offset += n;
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					const Key k = src_keys[i];
+					const size_t dst = h[(k >> (p * 8)) & 0xFF]++;
+					dst_keys[dst] = k;
+					dst_values[dst] = src_values[i];
+				}
+				std::swap(src_keys, dst_keys);
+				std::swap(src_values, dst_values);
+			}
+
+			if (src_keys != keys)
+			{
+				std::memcpy(keys, src_keys, count * sizeof(Key));
+				std::memcpy(values, src_values, count * sizeof(uint32_t));
+			}
+		}
+
+	template <typename Key>
+		static void radix_sort(std::vector<Key>& keys, std::vector<uint32_t>& values)
+		{
+			if (keys.empty()) return;
+			std::vector<Key> scratch_keys(keys.size());
+			std::vector<uint32_t> scratch_values(keys.size());
+			radix_sort(keys.data(), values.data(), keys.size(), scratch_keys.data(), scratch_values.data());
+		}
+
+	// Puts a stream into sorted order, given the values radix_sort() carried along with the keys (when they started out as
+	// 0, 1, 2...): out[i] = in[order[i]]. Apply it to each attribute stream that goes with the keys. out must not alias in.
+	template <typename T>
+		static void permute(const T* in, const uint32_t* order, T* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = in[order[i]];
+			}
+		}
+
+	// Elements [begin, end) of out.
+	template <typename T>
+		static void permute(const vec3_soa<T>& in, const uint32_t* order, vec3_soa<T>& out, size_t begin, size_t end) noexcept(true)
+		{
+			const T* xs = in.x.data();
+			const T* ys = in.y.data();
+			const T* zs = in.z.data();
+			T* ox = out.x.data();
+			T* oy = out.y.data();
+			T* oz = out.z.data();
+			for (size_t i = begin; i < end; ++i)
+			{
+				const uint32_t j = order[i];
+				ox[i] = xs[j];
+				oy[i] = ys[j];
+				oz[i] = zs[j];
+			}
+		}
+
+	// order must hold in.size() indices.
+	template <typename T>
+		static void permute(const vec3_soa<T>& in, const uint32_t* order, vec3_soa<T>& out)
+		{
+			out.resize(in.size());
+			permute(in, order, out, 0, in.size());
+		}
+}
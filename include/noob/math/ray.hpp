@@ -0,0 +1,22 @@
+#pragma once
+
+#include "vec3.hpp"
+
+namespace noob
+{
+	// Half-line origin + t * direction for t >= 0. The direction doesn't need to be normalized, but hit distances come back in units of its length.
+	template <typename T>
+		struct ray_type
+		{
+			ray_type() noexcept(true) = default;
+
+			constexpr ray_type(const noob::vec3_type<T>& o, const noob::vec3_type<T>& d) noexcept(true) : origin(o), direction(d) {}
+
+			constexpr noob::vec3_type<T> at(T t) const noexcept(true)
+			{
+				return origin + direction * t;
+			}
+
+			noob::vec3_type<T> origin, direction;
+		};
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	// N rays in SoA form, one per SIMD lane, with their inverse directions and per-ray search limit.
+	// Use N = 4 for SSE and N = 8 for AVX (float); the kernels below are plain fixed-width loops the compiler maps onto those.
+	template <typename T, size_t N>
+		struct alignas(64) ray_packet
+		{
+			static constexpr size_t width = N;
+
+			// Sets lane i. t_max bounds the search and is lowered by the closest-hit kernels as they find hits.
+			void set(size_t i, const noob::ray_type<T>& r, T t_limit = std::numeric_limits<T>::infinity()) noexcept(true)
+			{
+				origin_x[i] = r.origin[0];
+				origin_y[i] = r.origin[1];
+				origin_z[i] = r.origin[2];
+				dir_x[i] = r.direction[0];
+				dir_y[i] = r.direction[1];
+				dir_z[i] = r.direction[2];
+				inv_x[i] = static_cast<T>(1.0) / r.direction[0];
+				inv_y[i] = static_cast<T>(1.0) / r.direction[1];
+				inv_z[i] = static_cast<T>(1.0) / r.direction[2];
+				t_max[i] = t_limit;
+			}
+
+			noob::ray_type<T> get(size_t i) const noexcept(true)
+			{
+				return noob::ray_type<T>(noob::vec3_type<T>(origin_x[i], origin_y[i], origin_z[i]), noob::vec3_type<T>(dir_x[i], dir_y[i], dir_z[i]));
+			}
+
+			T origin_x[N], origin_y[N], origin_z[N];
+			T dir_x[N], dir_y[N], dir_z[N];
+			T inv_x[N], inv_y[N], inv_z[N];
+			T t_max[N];
+		};
+
+	typedef ray_packet<float, 4> ray_packet4f;
+	typedef ray_packet<float, 8> ray_packet8f;
+	typedef ray_packet<double, 4> ray_packet4d;
+
+	// Triangles stored as a first vertex plus its two edges, one stream per component: the form Moller-Trumbore consumes,
+	// so neither kernel recomputes the edges per test.
+	template <typename T>
+		struct triangle_soa
+		{
+			size_t size() const noexcept(true)
+			{
+				return v0.size();
+			}
+
+			void reserve(size_t n)
+			{
+				v0.reserve(n);
+				edge1.reserve(n);
+				edge2.reserve(n);
+			}
+
+			void clear() noexcept(true)
+			{
+				v0.clear();
+				edge1.clear();
+				edge2.clear();
+			}
+
+			// Same vertex order as get_normal(): counter-clockwise seen from the front.
+			void push_back(const std::array<noob::vec3_type<T>, 3>& vertices)
+			{
+				v0.push_back(vertices[0]);
+				edge1.push_back(vertices[1] - vertices[0]);
+				edge2.push_back(vertices[2] - vertices[0]);
+			}
+
+			std::array<noob::vec3_type<T>, 3> get(size_t i) const noexcept(true)
+			{
+				const noob::vec3_type<T> a = v0.get(i);
+				return { a, a + edge1.get(i), a + edge2.get(i) };
+			}
+
+			noob::vec3_soa<T> v0, edge1, edge2;
+		};
+
+	// Closest hit per lane from the packet kernels. prim is left untouched on lanes that hit nothing.
+	template <typename T, size_t N>
+		struct alignas(64) packet_hit
+		{
+			T t[N], u[N], v[N];
+			uint32_t prim[N];
+		};
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// PACKET KERNELS (N rays against one primitive):
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Slab test of every ray in the packet against one box. Returns a mask with bit i set if ray i hits the box within
+	// [0, t_max[i]]; t_enter[i] is where it enters (zero when it starts inside) and is meaningless for missed lanes.
+	template <typename T, size_t N>
+		static uint32_t intersects(const noob::ray_packet<T, N>& p, const noob::bbox_type<T>& b, T* t_enter) noexcept(true)
+		{
+			const T min_x = b.min[0], min_y = b.min[1], min_z = b.min[2];
+			const T max_x = b.max[0], max_y = b.max[1], max_z = b.max[2];
+			uint32_t hit[N];
+			for (size_t i = 0; i < N; ++i)
+			{
+				const T near_x = (min_x - p.origin_x[i]) * p.inv_x[i], far_x = (max_x - p.origin_x[i]) * p.inv_x[i];
+				const T near_y = (min_y - p.origin_y[i]) * p.inv_y[i], far_y = (max_y - p.origin_y[i]) * p.inv_y[i];
+				const T near_z = (min_z - p.origin_z[i]) * p.inv_z[i], far_z = (max_z - p.origin_z[i]) * p.inv_z[i];
+				const T t0 = std::max(std::max(std::min(near_x, far_x), std::min(near_y, far_y)), std::max(std::min(near_z, far_z), static_cast<T>(0.0)));
+				const T t1 = std::min(std::min(std::max(near_x, far_x), std::max(near_y, far_y)), std::min(std::max(near_z, far_z), p.t_max[i]));
+				t_enter[i] = t0;
+				hit[i] = (t0 <= t1);
+			}
+			uint32_t mask = 0;
+			for (size_t i = 0; i < N; ++i)
+			{
+				mask |= hit[i] << i;
+			}
+			return mask;
+		}
+
+	// Moller-Trumbore test of every ray in the packet against triangle tri of tris (two-sided). Returns the hit mask, with
+	// t, u and v per lane; the hit point is v0 + u * edge1 + v * edge2. Hits must lie in (0, t_max[i]).
+	// Only det == 0 is rejected outright, as in the scalar test: small triangles have tiny determinants, and a ray nearly
+	// parallel to the plane fails the u, v and t range tests (or gives NaN, which fails them too).
+	template <typename T, size_t N>
+		static uint32_t intersects(const noob::ray_packet<T, N>& p, const noob::triangle_soa<T>& tris, size_t tri, T* t, T* u, T* v) noexcept(true)
+		{
+			const T ax = tris.v0.x[tri], ay = tris.v0.y[tri], az = tris.v0.z[tri];
+			const T e1x = tris.edge1.x[tri], e1y = tris.edge1.y[tri], e1z = tris.edge1.z[tri];
+			const T e2x = tris.edge2.x[tri], e2y = tris.edge2.y[tri], e2z = tris.edge2.z[tri];
+			uint32_t hit[N];
+			for (size_t i = 0; i < N; ++i)
+			{
+				// p = dir x e2, det = e1 . p
+				const T px = p.dir_y[i] * e2z - p.dir_z[i] * e2y, py = p.dir_z[i] * e2x - p.dir_x[i] * e2z, pz = p.dir_x[i] * e2y - p.dir_y[i] * e2x;
+				const T det = e1x * px + e1y * py + e1z * pz;
+				const T inv_det = static_cast<T>(1.0) / det;
+				const T sx = p.origin_x[i] - ax, sy = p.origin_y[i] - ay, sz = p.origin_z[i] - az;
+				const T uu = (sx * px + sy * py + sz * pz) * inv_det;
+				// q = s x e1
+				const T qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+				const T vv = (p.dir_x[i] * qx + p.dir_y[i] * qy + p.dir_z[i] * qz) * inv_det;
+				const T tt = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+				t[i] = tt;
+				u[i] = uu;
+				v[i] = vv;
+				hit[i] = (det != 0.0) & (uu >= 0.0) & (vv >= 0.0) & (uu + vv <= 1.0) & (tt > 0.0) & (tt < p.t_max[i]);
+			}
+			uint32_t mask = 0;
+			for (size_t i = 0; i < N; ++i)
+			{
+				mask |= hit[i] << i;
+			}
+			return mask;
+		}
+
+	// Closest hit of each ray against every triangle in tris. Lowers p.t_max on each hit, so pass the packet by value
+	// if its limits are needed afterwards. Returns the mask of lanes that hit anything.
+	template <typename T, size_t N>
+		static uint32_t closest_hit(noob::ray_packet<T, N>& p, const noob::triangle_soa<T>& tris, noob::packet_hit<T, N>& results) noexcept(true)
+		{
+			alignas(64) T t[N], u[N], v[N];
+			uint32_t any = 0;
+			const size_t count = tris.size();
+			for (size_t k = 0; k < count; ++k)
+			{
+				const uint32_t mask = intersects(p, tris, k, t, u, v);
+				if (mask == 0) continue;
+				any |= mask;
+				for (size_t i = 0; i < N; ++i)
+				{
+					const bool h = (mask >> i) & 1;
+					p.t_max[i] = h ? t[i] : p.t_max[i];
+					results.t[i] = h ? t[i] : results.t[i];
+					results.u[i] = h ? u[i] : results.u[i];
+					results.v[i] = h ? v[i] : results.v[i];
+					results.prim[i] = h ? static_cast<uint32_t>(k) : results.prim[i];
+				}
+			}
+			return any;
+		}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// BATCH KERNELS (one ray against many primitives):
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// One ray against every box, one box per lane. hits[i] is 1 if box i is hit within [0, t_max], with its entry distance in t_enter[i].
+	// Returns the number of boxes hit.
+	template <typename T>
+		static size_t intersects(const noob::ray_type<T>& r, const noob::vec3_type<T>& inv_dir, const noob::bbox_soa<T>& boxes, T t_max, uint8_t* hits, T* t_enter) noexcept(true)
+		{
+			const T ox = r.origin[0], oy = r.origin[1], oz = r.origin[2];
+			const T ix = inv_dir[0], iy = inv_dir[1], iz = inv_dir[2];
+			const T* min_x = boxes.min.x.data(); const T* min_y = boxes.min.y.data(); const T* min_z = boxes.min.z.data();
+			const T* max_x = boxes.max.x.data(); const T* max_y = boxes.max.y.data(); const T* max_z = boxes.max.z.data();
+			const size_t count = boxes.size();
+			size_t found = 0;
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T near_x = (min_x[i] - ox) * ix, far_x = (max_x[i] - ox) * ix;
+				const T near_y = (min_y[i] - oy) * iy, far_y = (max_y[i] - oy) * iy;
+				const T near_z = (min_z[i] - oz) * iz, far_z = (max_z[i] - oz) * iz;
+				const T t0 = std::max(std::max(std::min(near_x, far_x), std::min(near_y, far_y)), std::max(std::min(near_z, far_z), static_cast<T>(0.0)));
+				const T t1 = std::min(std::min(std::max(near_x, far_x), std::max(near_y, far_y)), std::min(std::max(near_z, far_z), t_max));
+				const uint32_t h = (t0 <= t1);
+				t_enter[i] = t0;
+				hits[i] = static_cast<uint8_t>(h);
+				found += h;
+			}
+			return found;
+		}
+
+	// One ray against every triangle, one triangle per lane. hits[i] is 1 for a hit in (0, t_max), with t, u and v as in the packet kernel.
+	// Returns the number of triangles hit.
+	template <typename T>
+		static size_t intersects(const noob::ray_type<T>& r, const noob::triangle_soa<T>& tris, T t_max, uint8_t* hits, T* t, T* u, T* v) noexcept(true)
+		{
+			const T ox = r.origin[0], oy = r.origin[1], oz = r.origin[2];
+			const T dx = r.direction[0], dy = r.direction[1], dz = r.direction[2];
+			const T* ax = tris.v0.x.data(); const T* ay = tris.v0.y.data(); const T* az = tris.v0.z.data();
+			const T* e1x = tris.edge1.x.data(); const T* e1y = tris.edge1.y.data(); const T* e1z = tris.edge1.z.data();
+			const T* e2x = tris.edge2.x.data(); const T* e2y = tris.edge2.y.data(); const T* e2z = tris.edge2.z.data();
+			const size_t count = tris.size();
+			size_t found = 0;
+			NOOB_IVDEP
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T px = dy * e2z[i] - dz * e2y[i], py = dz * e2x[i] - dx * e2z[i], pz = dx * e2y[i] - dy * e2x[i];
+				const T det = e1x[i] * px + e1y[i] * py + e1z[i] * pz;
+				const T inv_det = static_cast<T>(1.0) / det;
+				const T sx = ox - ax[i], sy = oy - ay[i], sz = oz - az[i];
+				const T uu = (sx * px + sy * py + sz * pz) * inv_det;
+				const T qx = sy * e1z[i] - sz * e1y[i], qy = sz * e1x[i] - sx * e1z[i], qz = sx * e1y[i] - sy * e1x[i];
+				const T vv = (dx * qx + dy * qy + dz * qz) * inv_det;
+				const T tt = (e2x[i] * qx + e2y[i] * qy + e2z[i] * qz) * inv_det;
+				const uint32_t h = (det != 0.0) & (uu >= 0.0) & (vv >= 0.0) & (uu + vv <= 1.0) & (tt > 0.0) & (tt < t_max);
+				t[i] = tt;
+				u[i] = uu;
+				v[i] = vv;
+				hits[i] = static_cast<uint8_t>(h);
+				found += h;
+			}
+			return found;
+		}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// Compile-time selection of the SIMD code paths. The scalar templates are always available;
+// define NOOB_NO_SIMD to force them even when the compiler targets SSE/AVX.
+#if !defined(NOOB_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOOB_SIMD_SSE2
+#endif
+#if defined(__AVX__)
+#define NOOB_SIMD_AVX
+#endif
+// Hardware half-float conversion (GCC and clang turn it on with AVX2 targets such as -march=haswell).
+#if defined(__F16C__) && defined(__AVX__)
+#define NOOB_SIMD_F16C
+#endif
+// 256-bit integer ops (widening loads, lane permutes), used where a decode is integer work before it is float work.
+#if defined(__AVX2__)
+#define NOOB_SIMD_AVX2
+#endif
+// Bit deposit and extract (pdep and pext), used for Morton codes. Targets such as -march=haswell turn it on. Zen 1 and 2
+// run these in microcode, slower than the shift-and-mask fallback, so builds for those should leave BMI2 off.
+#if defined(__BMI2__)
+#define NOOB_SIMD_BMI2
+#endif
+#endif
+
+#if defined(NOOB_SIMD_AVX) || defined(NOOB_SIMD_BMI2)
+#include <immintrin.h>
+#elif defined(NOOB_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+// Placed in front of loops whose outputs may only alias their inputs element-for-element (in-place batch kernels).
+// Tells the compiler there are no loop-carried dependencies so it vectorizes without runtime alias checks.
+#if defined(__clang__)
+#define NOOB_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define NOOB_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define NOOB_IVDEP __pragma(loop(ivdep))
+#else
+#define NOOB_IVDEP
+#endif
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace noob
+{
+	// std::allocator ignores alignas() beyond alignof(max_align_t) before C++17, and wide vector loads on over-aligned
+	// types then fault. Containers of cache-line-aligned nodes use this instead.
+	template <typename T, size_t Align = 64>
+		struct aligned_allocator
+		{
+			typedef T value_type;
+
+			template <typename U>
+				struct rebind
+				{
+					typedef aligned_allocator<U, Align> other;
+				};
+
+			aligned_allocator() noexcept(true) = default;
+
+			template <typename U>
+				aligned_allocator(const aligned_allocator<U, Align>&) noexcept(true) {}
+
+			T* allocate(size_t n)
+			{
+				void* p = nullptr;
+#if defined(_MSC_VER)
+				p = _aligned_malloc(n * sizeof(T), Align);
+#else
+				if (posix_memalign(&p, Align, n * sizeof(T)) != 0) p = nullptr;
+#endif
+				if (!p) throw std::bad_alloc();
+				return static_cast<T*>(p);
+			}
+
+			void deallocate(T* p, size_t) noexcept(true)
+			{
+#if defined(_MSC_VER)
+				_aligned_free(p);
+#else
+				std::free(p);
+#endif
+			}
+
+			template <typename U>
+				bool operator==(const aligned_allocator<U, Align>&) const noexcept(true)
+				{
+					return true;
+				}
+
+			template <typename U>
+				bool operator!=(const aligned_allocator<U, Align>&) const noexcept(true)
+				{
+					return false;
+				}
+		};
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "math_funcs.hpp"
+#include "radix_sort.hpp"
+
+namespace noob
+{
+	// Sort-and-sweep broadphase over an array of bbox_type. Boxes are kept ordered by their min endpoint on one cardinal axis
+	// (the one their centers vary most along), then a sweep tests each box against the ones starting before it ends.
+	// The order is kept from frame to frame and repaired with insertion sort, which is close to linear while bodies move
+	// coherently; if the repair needs too many moves (or the body count changes), it falls back to a full radix sort.
+	template <typename T>
+		class sweep_and_prune
+		{
+			public:
+				// Sorts and sweeps in one go; see sort() and find_pairs().
+				size_t update(const noob::bbox_type<T>* boxes, size_t count, std::pair<uint32_t, uint32_t>* pairs, size_t max_pairs)
+				{
+					sort(boxes, count);
+					return find_pairs(pairs, max_pairs);
+				}
+
+				// Brings the sorted order up to date with this frame's boxes. Box i keeps index i in the reported pairs.
+				void sort(const noob::bbox_type<T>* boxes, size_t count)
+				{
+					if (count != order.size())
+					{
+						full_sort(boxes, count);
+						return;
+					}
+
+					const uint32_t a = static_cast<uint32_t>(axis);
+					for (size_t i = 0; i < count; ++i)
+					{
+						keys[i] = boxes[order[i]].min[a];
+					}
+
+					// Insertion sort, giving up once it has done more moves than a radix sort would cost.
+					const size_t budget = count * 2 + 64;
+					size_t moves = 0;
+					for (size_t i = 1; i < count; ++i)
+					{
+						const T k = keys[i];
+						if (!(k < keys[i - 1])) continue;
+						const uint32_t o = order[i];
+						size_t j = i;
+						for (; j > 0 && k < keys[j - 1]; --j)
+						{
+							keys[j] = keys[j - 1];
+							order[j] = order[j - 1];
+						}
+						keys[j] = k;
+						order[j] = o;
+						moves += i - j;
+						if (moves > budget)
+						{
+							full_sort(boxes, count);
+							return;
+						}
+					}
+					resorted = false;
+					gather(boxes);
+				}
+
+				// Writes up to max_pairs overlapping pairs (smaller index first) and returns how many there were in total,
+				// so a caller whose buffer was too small knows how far to grow it.
+				size_t find_pairs(std::pair<uint32_t, uint32_t>* pairs, size_t max_pairs) const noexcept(true)
+				{
+					const size_t count = order.size();
+					const T* min_s = sorted_min[0].data(); const T* max_s = sorted_max[0].data();
+					const T* min_b = sorted_min[1].data(); const T* max_b = sorted_max[1].data();
+					const T* min_c = sorted_min[2].data(); const T* max_c = sorted_max[2].data();
+					size_t found = 0;
+					for (size_t i = 0; i < count; ++i)
+					{
+						const T end = max_s[i];
+						const T lo_b = min_b[i], hi_b = max_b[i], lo_c = min_c[i], hi_c = max_c[i];
+						for (size_t j = i + 1; j < count && min_s[j] <= end; ++j)
+						{
+							if (min_b[j] <= hi_b && max_b[j] >= lo_b && min_c[j] <= hi_c && max_c[j] >= lo_c)
+							{
+								if (found < max_pairs) pairs[found] = std::make_pair(std::min(order[i], order[j]), std::max(order[i], order[j]));
+								++found;
+							}
+						}
+					}
+					return found;
+				}
+
+				// Forces a full sort, and a new choice of axis, on the next sort().
+				void reset() noexcept(true)
+				{
+					order.clear();
+				}
+
+				noob::cardinal_axis get_axis() const noexcept(true)
+				{
+					return axis;
+				}
+
+				// True if the last sort() had to fall back to a full sort.
+				bool last_sort_was_full() const noexcept(true)
+				{
+					return resorted;
+				}
+
+			protected:
+				void full_sort(const noob::bbox_type<T>* boxes, size_t count)
+				{
+					axis = pick_axis(boxes, count);
+					const uint32_t a = static_cast<uint32_t>(axis);
+
+					order.resize(count);
+					keys.resize(count);
+					radix_keys.resize(count);
+					scratch_keys.resize(count);
+					scratch_values.resize(count);
+					for (size_t i = 0; i < count; ++i)
+					{
+						radix_keys[i] = noob::sortable_key(boxes[i].min[a]);
+						order[i] = static_cast<uint32_t>(i);
+					}
+					noob::radix_sort(radix_keys.data(), order.data(), count, scratch_keys.data(), scratch_values.data());
+					for (size_t i = 0; i < count; ++i)
+					{
+						keys[i] = boxes[order[i]].min[a];
+					}
+					resorted = true;
+					gather(boxes);
+				}
+
+				// The axis along which box centers have the largest variance separates the most boxes.
+				static noob::cardinal_axis pick_axis(const noob::bbox_type<T>* boxes, size_t count) noexcept(true)
+				{
+					if (count == 0) return noob::cardinal_axis::X;
+					T sum[3] = { 0.0, 0.0, 0.0 }, sum_sq[3] = { 0.0, 0.0, 0.0 };
+					for (size_t i = 0; i < count; ++i)
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+						{
+							const T c = (boxes[i].min[a] + boxes[i].max[a]) * static_cast<T>(0.5);
+							sum[a] += c;
+							sum_sq[a] += c * c;
+						}
+					}
+					T variance[3];
+					for (uint32_t a = 0; a < 3; ++a)
+					{
+						variance[a] = sum_sq[a] - sum[a] * sum[a] / static_cast<T>(count);
+					}
+					if (variance[0] >= variance[1] && variance[0] >= variance[2]) return noob::cardinal_axis::X;
+					return variance[1] >= variance[2] ? noob::cardinal_axis::Y : noob::cardinal_axis::Z;
+				}
+
+				// Copies the bounds into sort order, sweep axis first, so the sweep reads memory sequentially.
+				void gather(const noob::bbox_type<T>* boxes)
+				{
+					const size_t count = order.size();
+					const uint32_t a = static_cast<uint32_t>(axis);
+					const uint32_t axes[3] = { a, (a + 1) % 3, (a + 2) % 3 };
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						sorted_min[k].resize(count);
+						sorted_max[k].resize(count);
+					}
+					for (size_t i = 0; i < count; ++i)
+					{
+						const noob::bbox_type<T>& b = boxes[order[i]];
+						for (uint32_t k = 0; k < 3; ++k)
+						{
+							sorted_min[k][i] = b.min[axes[k]];
+							sorted_max[k][i] = b.max[axes[k]];
+						}
+					}
+				}
+
+				typedef decltype(noob::sortable_key(T())) key_type;
+
+				noob::cardinal_axis axis = noob::cardinal_axis::X;
+				bool resorted = false;
+				std::vector<uint32_t> order;
+				std::vector<T> keys;
+				std::vector<T> sorted_min[3], sorted_max[3];
+				std::vector<key_type> radix_keys, scratch_keys;
+				std::vector<uint32_t> scratch_values;
+		};
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "math_funcs.hpp"
+
+namespace noob
+{
+	namespace detail
+	{
+		// Value storage per keyframe type.
+		template <typename V>
+			struct track_storage;
+
+		template <typename T>
+			struct track_storage<noob::vec3_type<T>>
+			{
+				typedef noob::vec3_soa<T> type;
+			};
+
+		template <typename T>
+			struct track_storage<noob::versor_type<T>>
+			{
+				typedef noob::versor_soa<T> type;
+			};
+
+		template <typename T>
+			static noob::vec3_type<T> interpolate(const noob::vec3_type<T>& a, const noob::vec3_type<T>& b, T t) noexcept(true)
+			{
+				return noob::lerp(a, b, t);
+			}
+
+		template <typename T>
+			static noob::versor_type<T> interpolate(const noob::versor_type<T>& a, const noob::versor_type<T>& b, T t) noexcept(true)
+			{
+				return noob::slerp(a, b, t);
+			}
+	}
+
+	// Keyframes of one animated value (vec3_type for translation/scale, versor_type for rotation): strictly increasing times
+	// plus SoA values. Sampling clamps to the first and last key, and interpolates with lerp() or slerp() in between.
+	//
+	// Each animated instance keeps a cursor (the index of the key it last sampled from) per track. While the sample time
+	// moves forward, the next segment is found by stepping the cursor, so playback is O(1) amortized; jumps and rewinds
+	// (e.g. when a looping clip wraps) fall back to a binary search.
+	template <typename T, typename V>
+		class track
+		{
+			public:
+				typedef V value_type;
+
+				// Times must be added in strictly increasing order.
+				void add_key(T time, const V& value)
+				{
+					times.push_back(time);
+					values.push_back(value);
+				}
+
+				void reserve(size_t n)
+				{
+					times.reserve(n);
+					values.reserve(n);
+				}
+
+				void clear() noexcept(true)
+				{
+					times.clear();
+					values.clear();
+				}
+
+				size_t size() const noexcept(true)
+				{
+					return times.size();
+				}
+
+				bool empty() const noexcept(true)
+				{
+					return times.empty();
+				}
+
+				T get_time(size_t i) const noexcept(true)
+				{
+					return times[i];
+				}
+
+				V get_value(size_t i) const noexcept(true)
+				{
+					return values.get(i);
+				}
+
+				T get_start_time() const noexcept(true)
+				{
+					return times.front();
+				}
+
+				T get_end_time() const noexcept(true)
+				{
+					return times.back();
+				}
+
+				// Index of the last key at or before time (0 if time precedes every key), starting the search from cursor
+				// and leaving the result in it. Needs at least one key.
+				uint32_t seek(T time, uint32_t& cursor) const noexcept(true)
+				{
+					const uint32_t last = static_cast<uint32_t>(times.size() - 1);
+					uint32_t k = std::min(cursor, last);
+					if (times[k] <= time)
+					{
+						// Usual case: still in the same segment, or just moved into the next one.
+						if (k == last || time < times[k + 1])
+						{
+							cursor = k;
+							return k;
+						}
+						if (k + 1 == last || time < times[k + 2])
+						{
+							cursor = k + 1;
+							return k + 1;
+						}
+					}
+					const typename std::vector<T>::const_iterator it = std::upper_bound(times.begin(), times.end(), time);
+					k = (it == times.begin()) ? 0 : static_cast<uint32_t>(it - times.begin() - 1);
+					cursor = k;
+					return k;
+				}
+
+				// Needs at least one key.
+				V sample(T time, uint32_t& cursor) const noexcept(true)
+				{
+					const uint32_t k = seek(time, cursor);
+					if (k + 1 == times.size() || time <= times[k]) return values.get(k);
+					const T t = (time - times[k]) / (times[k + 1] - times[k]);
+					return detail::interpolate(values.get(k), values.get(k + 1), t);
+				}
+
+			protected:
+				std::vector<T> times;
+				typename detail::track_storage<V>::type values;
+		};
+
+	template <typename T>
+		using vec3_track = track<T, noob::vec3_type<T>>;
+
+	template <typename T>
+		using versor_track = track<T, noob::versor_type<T>>;
+
+	// Samples count tracks at the same time, e.g. every joint channel of a clip. cursors holds one entry per track for this
+	// instance (zero-initialize them once) and results must hold count values; nothing is allocated.
+	template <typename T, typename V>
+		static void sample(const noob::track<T, V>* tracks, size_t count, T time, uint32_t* cursors, V* results) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				results[i] = tracks[i].sample(time, cursors[i]);
+			}
+		}
+
+	// As above, with the results written to a strided local-pose buffer (e.g. the rotation member of an array of joint
+	// transforms): result i goes to the V at byte offset i * stride from results.
+	template <typename T, typename V>
+		static void sample(const noob::track<T, V>* tracks, size_t count, T time, uint32_t* cursors, V* results, size_t stride) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				*detail::stride_at(results, stride, i) = tracks[i].sample(time, cursors[i]);
+			}
+		}
+}
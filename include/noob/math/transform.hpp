@@ -0,0 +1,351 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math_funcs.hpp"
+#include "dual_quat.hpp"
+
+namespace noob
+{
+	// Translation, rotation and per-axis scale (applied scale first, then rotation, then translation): 40 bytes for float
+	// against 64 for the equivalent mat4_type, and composing two of them costs a quaternion product and a rotated vector
+	// instead of a 4x4 multiply. Keep these per entity and call to_mat4() only where a matrix is needed (rendering, skinning).
+	//
+	// Composition and inverse are exact when the scale is uniform. With non-uniform scale, a rotated child would need shear,
+	// which TRS can't hold, so the scales just multiply per axis (the usual choice for scene graphs).
+	template <typename T>
+		struct transform_type
+		{
+			transform_type() noexcept(true) = default;
+
+			constexpr transform_type(const noob::vec3_type<T>& t, const noob::versor_type<T>& r, const noob::vec3_type<T>& s) noexcept(true) : translation(t), rotation(r), scale(s) {}
+
+			// See decompose() for what survives the trip (no shear).
+			static transform_type from_mat4(const noob::mat4_type<T>& m) noexcept(true)
+			{
+				transform_type r;
+				noob::decompose(m, r.translation, r.rotation, r.scale);
+				return r;
+			}
+
+			static constexpr transform_type identity() noexcept(true)
+			{
+				return transform_type(noob::vec3_type<T>(0.0, 0.0, 0.0), noob::versor_type<T>(1.0, 0.0, 0.0, 0.0), noob::vec3_type<T>(1.0, 1.0, 1.0));
+			}
+
+			// Applies rhs first, then this, like mat4_type::operator*.
+			transform_type operator*(const transform_type& rhs) const noexcept(true)
+			{
+				return transform_type(transform_point(rhs.translation), detail::quat_multiply(rotation, rhs.rotation), noob::vec3_type<T>(scale[0] * rhs.scale[0], scale[1] * rhs.scale[1], scale[2] * rhs.scale[2]));
+			}
+
+			// Scale must be non-zero on every axis.
+			transform_type inverse() const noexcept(true)
+			{
+				const noob::versor_type<T> r(rotation.q[0], -rotation.q[1], -rotation.q[2], -rotation.q[3]);
+				const noob::vec3_type<T> s(static_cast<T>(1.0) / scale[0], static_cast<T>(1.0) / scale[1], static_cast<T>(1.0) / scale[2]);
+				const noob::vec3_type<T> t = detail::quat_rotate(r, translation);
+				return transform_type(noob::vec3_type<T>(-t[0] * s[0], -t[1] * s[1], -t[2] * s[2]), r, s);
+			}
+
+			noob::vec3_type<T> transform_point(const noob::vec3_type<T>& p) const noexcept(true)
+			{
+				return transform_direction(p) + translation;
+			}
+
+			// Scales and rotates, without the translation.
+			noob::vec3_type<T> transform_direction(const noob::vec3_type<T>& d) const noexcept(true)
+			{
+				return detail::quat_rotate(rotation, noob::vec3_type<T>(d[0] * scale[0], d[1] * scale[1], d[2] * scale[2]));
+			}
+
+			// Same matrix as translate(rotate(scale(identity_mat4(), s), r), t), without the 4x4 multiplies.
+			noob::mat4_type<T> to_mat4() const noexcept(true)
+			{
+				const T w = rotation.q[0], x = rotation.q[1], y = rotation.q[2], z = rotation.q[3];
+				const T one = 1.0, two = 2.0;
+				const T xx = x * x, yy = y * y, zz = z * z;
+				const T xy = x * y, xz = x * z, yz = y * z;
+				const T wx = w * x, wy = w * y, wz = w * z;
+				return noob::mat4_type<T>(
+						(one - two * (yy + zz)) * scale[0], two * (xy + wz) * scale[0], two * (xz - wy) * scale[0], 0.0,
+						two * (xy - wz) * scale[1], (one - two * (xx + zz)) * scale[1], two * (yz + wx) * scale[1], 0.0,
+						two * (xz + wy) * scale[2], two * (yz - wx) * scale[2], (one - two * (xx + yy)) * scale[2], 0.0,
+						translation[0], translation[1], translation[2], 1.0);
+			}
+
+			// Drops the scale.
+			noob::dual_quat<T> to_dual_quat() const noexcept(true)
+			{
+				return noob::dual_quat<T>::from_rotation_translation(rotation, translation);
+			}
+
+			noob::vec3_type<T> translation;
+			// Unit length, w first.
+			noob::versor_type<T> rotation;
+			noob::vec3_type<T> scale;
+		};
+
+	typedef transform_type<float> transformf;
+	typedef transform_type<double> transformd;
+
+	// Translation and scale interpolate linearly, the rotation with nlerp() (cheap, and close to slerp() for the small steps
+	// between animation keys).
+	template <typename T>
+		static transform_type<T> lerp(const transform_type<T>& a, const transform_type<T>& b, T t) noexcept(true)
+		{
+			return transform_type<T>(noob::lerp(a.translation, b.translation, t), noob::nlerp(a.rotation, b.rotation, t), noob::lerp(a.scale, b.scale, t));
+		}
+
+	// As lerp(), with constant angular velocity for the rotation.
+	template <typename T>
+		static transform_type<T> slerp(const transform_type<T>& a, const transform_type<T>& b, T t) noexcept(true)
+		{
+			return transform_type<T>(noob::lerp(a.translation, b.translation, t), noob::slerp(a.rotation, b.rotation, t), noob::lerp(a.scale, b.scale, t));
+		}
+
+	// Batch forms, e.g. parent * local for a level of a hierarchy. out may equal a or b.
+	template <typename T>
+		static void compose(const transform_type<T>* a, const transform_type<T>* b, transform_type<T>* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = a[i] * b[i];
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Float works on the packed layout (translation, rotation, scale: 10 floats) with unaligned loads that never leave the
+	// element. The quaternion product is four broadcasts against sign-flipped shuffles of the other rotation.
+	static void compose(const transform_type<float>* a, const transform_type<float>* b, transform_type<float>* out, size_t count) noexcept(true)
+	{
+		static_assert(sizeof(transform_type<float>) == 10 * sizeof(float), "transform_type<float> must be packed");
+		const __m128 sign_x = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+		const __m128 sign_y = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+		const __m128 sign_z = _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* pa = &a[i].translation.v[0];
+			const float* pb = &b[i].translation.v[0];
+			float* po = &out[i].translation.v[0];
+			// Lanes: [t0 t1 t2 w], [x y z s0], [z s0 s1 s2]; b's rotation as [w x y z].
+			const __m128 ta = _mm_loadu_ps(pa);
+			const __m128 ra = _mm_loadu_ps(pa + 4);
+			const __m128 sa = _mm_loadu_ps(pa + 6);
+			const __m128 tb = _mm_loadu_ps(pb);
+			const __m128 qb = _mm_loadu_ps(pb + 3);
+			const __m128 sb = _mm_loadu_ps(pb + 6);
+
+			// Broadcasts come straight from memory so they stay off the shuffle port, which is the bottleneck here.
+			const __m128 aw = _mm_set1_ps(pa[3]);
+			__m128 q = _mm_mul_ps(aw, qb);
+			q = _mm_add_ps(q, _mm_mul_ps(_mm_set1_ps(pa[4]), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1)), sign_x)));
+			q = _mm_add_ps(q, _mm_mul_ps(_mm_set1_ps(pa[5]), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2)), sign_y)));
+			q = _mm_add_ps(q, _mm_mul_ps(_mm_set1_ps(pa[6]), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3)), sign_z)));
+
+			// a.transform_point(b.translation), with the two cross products sharing the shuffled rotation axis. Lane 3
+			// carries junk until the rotation store overwrites it.
+			const __m128 ra_yzx = detail::shuffle_yzx(ra);
+			const __m128 v = _mm_mul_ps(_mm_shuffle_ps(sa, sa, _MM_SHUFFLE(0, 3, 2, 1)), tb);
+			const __m128 c = _mm_add_ps(detail::shuffle_yzx(_mm_sub_ps(_mm_mul_ps(ra, detail::shuffle_yzx(v)), _mm_mul_ps(ra_yzx, v))), _mm_mul_ps(aw, v));
+			const __m128 rc = detail::shuffle_yzx(_mm_sub_ps(_mm_mul_ps(ra, detail::shuffle_yzx(c)), _mm_mul_ps(ra_yzx, c)));
+			const __m128 t = _mm_add_ps(ta, _mm_add_ps(v, _mm_mul_ps(two, rc)));
+
+			// Lane 0 of the scale store is the rotation's z.
+			const __m128 s = _mm_move_ss(_mm_mul_ps(sa, sb), _mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3)));
+			_mm_storeu_ps(po, t);
+			_mm_storeu_ps(po + 3, q);
+			_mm_storeu_ps(po + 6, s);
+		}
+	}
+#endif
+
+#if defined(NOOB_SIMD_AVX2)
+	// The same layout trick for double, a register per four doubles. The quaternion shuffles stay within or swap 128-bit
+	// halves; only the cross products need AVX2's cross-lane permute.
+	namespace detail
+	{
+		static inline __m256d shuffle_yzx(__m256d v) noexcept(true)
+		{
+			return _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+	}
+
+	static void compose(const transform_type<double>* a, const transform_type<double>* b, transform_type<double>* out, size_t count) noexcept(true)
+	{
+		static_assert(sizeof(transform_type<double>) == 10 * sizeof(double), "transform_type<double> must be packed");
+		const __m256d sign_x = _mm256_setr_pd(-0.0, 0.0, -0.0, 0.0);
+		const __m256d sign_y = _mm256_setr_pd(-0.0, 0.0, 0.0, -0.0);
+		const __m256d sign_z = _mm256_setr_pd(-0.0, -0.0, 0.0, 0.0);
+		const __m256d two = _mm256_set1_pd(2.0);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double* pa = &a[i].translation.v[0];
+			const double* pb = &b[i].translation.v[0];
+			double* po = &out[i].translation.v[0];
+			const __m256d ta = _mm256_loadu_pd(pa);
+			const __m256d ra = _mm256_loadu_pd(pa + 4);
+			const __m256d sa = _mm256_loadu_pd(pa + 6);
+			const __m256d tb = _mm256_loadu_pd(pb);
+			const __m256d qb = _mm256_loadu_pd(pb + 3);
+			const __m256d sb = _mm256_loadu_pd(pb + 6);
+
+			const __m256d aw = _mm256_broadcast_sd(pa + 3);
+			const __m256d qb_swapped = _mm256_permute2f128_pd(qb, qb, 1);
+			__m256d q = _mm256_mul_pd(aw, qb);
+			q = _mm256_add_pd(q, _mm256_mul_pd(_mm256_broadcast_sd(pa + 4), _mm256_xor_pd(_mm256_permute_pd(qb, 5), sign_x)));
+			q = _mm256_add_pd(q, _mm256_mul_pd(_mm256_broadcast_sd(pa + 5), _mm256_xor_pd(qb_swapped, sign_y)));
+			q = _mm256_add_pd(q, _mm256_mul_pd(_mm256_broadcast_sd(pa + 6), _mm256_xor_pd(_mm256_permute_pd(qb_swapped, 5), sign_z)));
+
+			const __m256d ra_yzx = detail::shuffle_yzx(ra);
+			const __m256d v = _mm256_mul_pd(_mm256_permute4x64_pd(sa, _MM_SHUFFLE(0, 3, 2, 1)), tb);
+			const __m256d c = _mm256_add_pd(detail::shuffle_yzx(_mm256_sub_pd(_mm256_mul_pd(ra, detail::shuffle_yzx(v)), _mm256_mul_pd(ra_yzx, v))), _mm256_mul_pd(aw, v));
+			const __m256d rc = detail::shuffle_yzx(_mm256_sub_pd(_mm256_mul_pd(ra, detail::shuffle_yzx(c)), _mm256_mul_pd(ra_yzx, c)));
+			const __m256d t = _mm256_add_pd(ta, _mm256_add_pd(v, _mm256_mul_pd(two, rc)));
+
+			const __m256d s = _mm256_blend_pd(_mm256_mul_pd(sa, sb), _mm256_permute4x64_pd(q, _MM_SHUFFLE(3, 3, 3, 3)), 1);
+			_mm256_storeu_pd(po, t);
+			_mm256_storeu_pd(po + 3, q);
+			_mm256_storeu_pd(po + 6, s);
+		}
+	}
+#endif
+
+	template <typename T>
+		static void to_mat4(const transform_type<T>* in, mat4_type<T>* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = in[i].to_mat4();
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// With w, x, y, z the rotation and e_k the identity columns, the rotation columns before scale are
+	//	e0 + 2 * (y * a + z * b), e1 + 2 * (z * c - x * a), e2 - 2 * (x * b + y * c)
+	// where a, b and c are three sign-flipped shuffles of the quaternion. Building the columns in registers takes four
+	// stores per matrix instead of sixteen.
+	static void to_mat4(const transform_type<float>* in, mat4_type<float>* out, size_t count) noexcept(true)
+	{
+		const __m128 sign_a = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+		const __m128 sign_b = _mm_setr_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+		const __m128 sign_c = _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+		const __m128 xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		const __m128 e0 = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		const __m128 e1 = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+		const __m128 e2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+		const __m128 e3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* p = &in[i].translation.v[0];
+			float* m = &out[i].m[0];
+			const __m128 q = _mm_loadu_ps(p + 3);
+			const __m128 x = _mm_set1_ps(p[4]);
+			const __m128 y = _mm_set1_ps(p[5]);
+			const __m128 z = _mm_set1_ps(p[6]);
+			// [-y x -w], [-z w x], [-w -z y]
+			const __m128 a = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 0, 1, 2)), sign_a);
+			const __m128 b = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 1, 0, 3)), sign_b);
+			const __m128 c = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 2, 3, 0)), sign_c);
+			const __m128 c0 = _mm_add_ps(e0, _mm_mul_ps(two, _mm_and_ps(_mm_add_ps(_mm_mul_ps(y, a), _mm_mul_ps(z, b)), xyz)));
+			const __m128 c1 = _mm_add_ps(e1, _mm_mul_ps(two, _mm_and_ps(_mm_sub_ps(_mm_mul_ps(z, c), _mm_mul_ps(x, a)), xyz)));
+			const __m128 c2 = _mm_sub_ps(e2, _mm_mul_ps(two, _mm_and_ps(_mm_add_ps(_mm_mul_ps(x, b), _mm_mul_ps(y, c)), xyz)));
+			_mm_storeu_ps(m, _mm_mul_ps(c0, _mm_set1_ps(p[7])));
+			_mm_storeu_ps(m + 4, _mm_mul_ps(c1, _mm_set1_ps(p[8])));
+			_mm_storeu_ps(m + 8, _mm_mul_ps(c2, _mm_set1_ps(p[9])));
+			_mm_storeu_ps(m + 12, _mm_or_ps(_mm_and_ps(_mm_loadu_ps(p), xyz), e3));
+		}
+	}
+#endif
+
+	template <typename T>
+		static void decompose(const mat4_type<T>* in, transform_type<T>* out, size_t count) noexcept(true)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = transform_type<T>::from_mat4(in[i]);
+			}
+		}
+
+#if defined(NOOB_SIMD_SSE2)
+	// Four matrices at a time, transposed so each register holds one element of all four: the column lengths, determinant
+	// signs and the quaternion case selection of versor_from_mat4() all become branch-free lane arithmetic. The remainder
+	// goes through the scalar path.
+	static void decompose(const mat4_type<float>* in, transform_type<float>* out, size_t count) noexcept(true)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* m0 = &in[i].m[0];
+			const float* m1 = &in[i + 1].m[0];
+			const float* m2 = &in[i + 2].m[0];
+			const float* m3 = &in[i + 3].m[0];
+			// aRC is row R of column C, across the four matrices.
+			__m128 a00 = _mm_loadu_ps(m0), a10 = _mm_loadu_ps(m1), a20 = _mm_loadu_ps(m2), w0 = _mm_loadu_ps(m3);
+			_MM_TRANSPOSE4_PS(a00, a10, a20, w0);
+			__m128 a01 = _mm_loadu_ps(m0 + 4), a11 = _mm_loadu_ps(m1 + 4), a21 = _mm_loadu_ps(m2 + 4), w1 = _mm_loadu_ps(m3 + 4);
+			_MM_TRANSPOSE4_PS(a01, a11, a21, w1);
+			__m128 a02 = _mm_loadu_ps(m0 + 8), a12 = _mm_loadu_ps(m1 + 8), a22 = _mm_loadu_ps(m2 + 8), w2 = _mm_loadu_ps(m3 + 8);
+			_MM_TRANSPOSE4_PS(a02, a12, a22, w2);
+
+			const __m128 det = _mm_add_ps(_mm_add_ps(
+						_mm_mul_ps(a00, _mm_sub_ps(_mm_mul_ps(a11, a22), _mm_mul_ps(a21, a12))),
+						_mm_mul_ps(a10, _mm_sub_ps(_mm_mul_ps(a21, a02), _mm_mul_ps(a01, a22)))),
+					_mm_mul_ps(a20, _mm_sub_ps(_mm_mul_ps(a01, a12), _mm_mul_ps(a11, a02))));
+			const __m128 sx = _mm_xor_ps(_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a00, a00), _mm_mul_ps(a10, a10)), _mm_mul_ps(a20, a20))), _mm_and_ps(det, sign));
+			const __m128 sy = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a01, a01), _mm_mul_ps(a11, a11)), _mm_mul_ps(a21, a21)));
+			const __m128 sz = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a02, a02), _mm_mul_ps(a12, a12)), _mm_mul_ps(a22, a22)));
+			const __m128 ix = _mm_div_ps(one, sx), iy = _mm_div_ps(one, sy), iz = _mm_div_ps(one, sz);
+			const __m128 r00 = _mm_mul_ps(a00, ix), r11 = _mm_mul_ps(a11, iy), r22 = _mm_mul_ps(a22, iz);
+
+			const __m128 d0 = _mm_add_ps(_mm_add_ps(one, r00), _mm_add_ps(r11, r22));
+			const __m128 d1 = _mm_sub_ps(_mm_add_ps(one, r00), _mm_add_ps(r11, r22));
+			const __m128 d2 = _mm_sub_ps(_mm_add_ps(one, r11), _mm_add_ps(r00, r22));
+			const __m128 d3 = _mm_sub_ps(_mm_add_ps(one, r22), _mm_add_ps(r00, r11));
+			const __m128 wx = _mm_sub_ps(_mm_mul_ps(a21, iy), _mm_mul_ps(a12, iz));
+			const __m128 wy = _mm_sub_ps(_mm_mul_ps(a02, iz), _mm_mul_ps(a20, ix));
+			const __m128 wz = _mm_sub_ps(_mm_mul_ps(a10, ix), _mm_mul_ps(a01, iy));
+			const __m128 xy = _mm_add_ps(_mm_mul_ps(a10, ix), _mm_mul_ps(a01, iy));
+			const __m128 xz = _mm_add_ps(_mm_mul_ps(a02, iz), _mm_mul_ps(a20, ix));
+			const __m128 yz = _mm_add_ps(_mm_mul_ps(a21, iy), _mm_mul_ps(a12, iz));
+
+			// Same order of comparisons as the scalar loop, so both pick the same sign of q.
+			__m128 best = d0, qw = d0, qx = wx, qy = wy, qz = wz;
+			__m128 mask = _mm_cmpgt_ps(d1, best);
+			best = _mm_max_ps(best, d1);
+			qw = detail::select(mask, wx, qw); qx = detail::select(mask, d1, qx); qy = detail::select(mask, xy, qy); qz = detail::select(mask, xz, qz);
+			mask = _mm_cmpgt_ps(d2, best);
+			best = _mm_max_ps(best, d2);
+			qw = detail::select(mask, wy, qw); qx = detail::select(mask, xy, qx); qy = detail::select(mask, d2, qy); qz = detail::select(mask, yz, qz);
+			mask = _mm_cmpgt_ps(d3, best);
+			best = _mm_max_ps(best, d3);
+			qw = detail::select(mask, wz, qw); qx = detail::select(mask, xz, qx); qy = detail::select(mask, yz, qy); qz = detail::select(mask, d3, qz);
+			const __m128 inv = _mm_div_ps(half, _mm_sqrt_ps(best));
+			__m128 q0 = _mm_mul_ps(qw, inv), q1 = _mm_mul_ps(qx, inv), q2 = _mm_mul_ps(qy, inv), q3 = _mm_mul_ps(qz, inv);
+
+			// Back to one transform per register. The scale store starts at the rotation's z, like in compose().
+			__m128 s0 = q3, s1 = sx, s2 = sy, s3 = sz;
+			_MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+			_MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+			const __m128 q[4] = { q0, q1, q2, q3 };
+			const __m128 s[4] = { s0, s1, s2, s3 };
+			for (uint32_t k = 0; k < 4; ++k)
+			{
+				float* p = &out[i + k].translation.v[0];
+				_mm_storeu_ps(p, _mm_loadu_ps(&in[i + k].m[12]));
+				_mm_storeu_ps(p + 3, q[k]);
+				_mm_storeu_ps(p + 6, s[k]);
+			}
+		}
+		for (; i < count; ++i)
+		{
+			out[i] = transform_type<float>::from_mat4(in[i]);
+		}
+	}
+#endif
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "math_funcs.hpp"
+#include "parallel.hpp"
+
+namespace noob
+{
+	// Parent/child transforms flattened into breadth-first order: level 0 holds the roots, level d the nodes at depth d, so
+	// every parent comes before its children. update() recomputes world = parent world * local in one streaming pass per level,
+	// each level split across threads with parallel_for(), and only touches nodes whose local matrix (or an ancestor's) changed.
+	//
+	// Handles returned by add() are stable. Adding nodes reorders the internal arrays, which happens lazily on the next update().
+	template <typename T>
+		class transform_hierarchy
+		{
+			public:
+				static constexpr uint32_t null_node = 0xFFFFFFFF;
+
+				// Nodes per chunk when a level is split across threads.
+				static const size_t grain = 2048;
+
+				// parent must be null_node (for a root) or a handle returned earlier.
+				uint32_t add(uint32_t parent, const noob::mat4_type<T>& local)
+				{
+					const uint32_t handle = static_cast<uint32_t>(index_of.size());
+					const uint32_t d = (parent == null_node) ? 0 : depths[parent] + 1;
+					parent_handles.push_back(parent);
+					depths.push_back(d);
+					index_of.push_back(handle);
+					parents.push_back(parent == null_node ? null_node : index_of[parent]);
+					locals.push_back(local);
+					worlds.push_back(local);
+					dirty.push_back(1);
+					if (d >= level_marked.size()) level_marked.resize(d + 1, 0);
+					level_marked[d] = 1;
+					reorder = true;
+					return handle;
+				}
+
+				void reserve(size_t n)
+				{
+					parent_handles.reserve(n);
+					depths.reserve(n);
+					index_of.reserve(n);
+					parents.reserve(n);
+					locals.reserve(n);
+					worlds.reserve(n);
+					dirty.reserve(n);
+				}
+
+				void clear() noexcept(true)
+				{
+					parent_handles.clear();
+					depths.clear();
+					index_of.clear();
+					parents.clear();
+					locals.clear();
+					worlds.clear();
+					dirty.clear();
+					level_offsets.clear();
+					level_marked.clear();
+					reorder = false;
+				}
+
+				size_t size() const noexcept(true)
+				{
+					return index_of.size();
+				}
+
+				// Valid after update().
+				size_t get_level_count() const noexcept(true)
+				{
+					return level_offsets.empty() ? 0 : level_offsets.size() - 1;
+				}
+
+				uint32_t get_parent(uint32_t handle) const noexcept(true)
+				{
+					return parent_handles[handle];
+				}
+
+				void set_local(uint32_t handle, const noob::mat4_type<T>& local) noexcept(true)
+				{
+					const uint32_t i = index_of[handle];
+					locals[i] = local;
+					dirty[i] = 1;
+					level_marked[depths[handle]] = 1;
+				}
+
+				noob::mat4_type<T> get_local(uint32_t handle) const noexcept(true)
+				{
+					return locals[index_of[handle]];
+				}
+
+				// As of the last update().
+				noob::mat4_type<T> get_world(uint32_t handle) const noexcept(true)
+				{
+					return worlds[index_of[handle]];
+				}
+
+				// World matrices in level order, with indices as given by get_index(); for uploading them all at once.
+				const noob::mat4_type<T>* get_worlds() const noexcept(true)
+				{
+					return worlds.data();
+				}
+
+				uint32_t get_index(uint32_t handle) const noexcept(true)
+				{
+					return index_of[handle];
+				}
+
+				void update()
+				{
+					if (reorder) rebuild();
+
+					const size_t levels = get_level_count();
+					// Whether any world matrix changed on the previous level; if not, a level nobody marked is skipped untouched.
+					bool parent_changed = false;
+					// Children read their parents' flags, so a level's flags are cleared once the next level is done.
+					size_t pending = levels;
+					for (size_t d = 0; d < levels; ++d)
+					{
+						const size_t begin = level_offsets[d];
+						const size_t count = level_offsets[d + 1] - begin;
+						if (!parent_changed && !level_marked[d]) continue;
+						level_marked[d] = 0;
+
+						chunk_changed.assign(noob::parallel_chunks(count, grain), 0);
+						noob::parallel_for(count, grain, [&](size_t chunk, size_t b, size_t e)
+						{
+							chunk_changed[chunk] = (d == 0) ? update_roots(begin + b, begin + e) : update_range(begin + b, begin + e);
+						});
+						parent_changed = std::find(chunk_changed.begin(), chunk_changed.end(), 1) != chunk_changed.end();
+						if (pending != levels) clear_level(pending);
+						pending = d;
+					}
+					if (pending != levels) clear_level(pending);
+				}
+
+			protected:
+				// Counting sort of the handles by depth; stable, so siblings stay in the order they were added.
+				void rebuild()
+				{
+					const size_t n = index_of.size();
+					const uint32_t levels = static_cast<uint32_t>(level_marked.size());
+					level_offsets.assign(levels + 1, 0);
+					for (size_t h = 0; h < n; ++h)
+					{
+						++level_offsets[depths[h] + 1];
+					}
+					for (uint32_t d = 0; d < levels; ++d)
+					{
+						level_offsets[d + 1] += level_offsets[d];
+					}
+
+					std::vector<uint32_t> next_index(n);
+					std::vector<uint32_t> cursor(level_offsets.begin(), level_offsets.end() - 1);
+					for (size_t h = 0; h < n; ++h)
+					{
+						next_index[h] = cursor[depths[h]]++;
+					}
+
+					std::vector<noob::mat4_type<T>> next_locals(n), next_worlds(n);
+					std::vector<uint8_t> next_dirty(n);
+					std::vector<uint32_t> next_parents(n);
+					for (size_t h = 0; h < n; ++h)
+					{
+						const uint32_t from = index_of[h];
+						const uint32_t to = next_index[h];
+						next_locals[to] = locals[from];
+						next_worlds[to] = worlds[from];
+						next_dirty[to] = dirty[from];
+						next_parents[to] = (parent_handles[h] == null_node) ? null_node : next_index[parent_handles[h]];
+					}
+					locals.swap(next_locals);
+					worlds.swap(next_worlds);
+					dirty.swap(next_dirty);
+					parents.swap(next_parents);
+					index_of.swap(next_index);
+					reorder = false;
+				}
+
+				void clear_level(size_t d) noexcept(true)
+				{
+					std::fill(dirty.begin() + level_offsets[d], dirty.begin() + level_offsets[d + 1], static_cast<uint8_t>(0));
+				}
+
+				uint8_t update_roots(size_t begin, size_t end) noexcept(true)
+				{
+					const noob::mat4_type<T>* l = locals.data();
+					noob::mat4_type<T>* w = worlds.data();
+					const uint8_t* flags = dirty.data();
+					uint8_t changed = 0;
+					for (size_t i = begin; i < end; ++i)
+					{
+						if (flags[i])
+						{
+							w[i] = l[i];
+							changed = 1;
+						}
+					}
+					return changed;
+				}
+
+				// A node is recomputed when it was marked, or its parent was (parent flags already include their ancestors').
+				uint8_t update_range(size_t begin, size_t end) noexcept(true)
+				{
+					const noob::mat4_type<T>* l = locals.data();
+					noob::mat4_type<T>* w = worlds.data();
+					const uint32_t* p = parents.data();
+					uint8_t* flags = dirty.data();
+					uint8_t changed = 0;
+					for (size_t i = begin; i < end; ++i)
+					{
+						const uint8_t f = flags[i] | flags[p[i]];
+						flags[i] = f;
+						if (f)
+						{
+							w[i] = w[p[i]] * l[i];
+							changed = 1;
+						}
+					}
+					return changed;
+				}
+
+				// By handle.
+				std::vector<uint32_t> parent_handles, depths, index_of;
+				// By index, in level order.
+				std::vector<uint32_t> parents;
+				std::vector<noob::mat4_type<T>> locals, worlds;
+				std::vector<uint8_t> dirty;
+				std::vector<uint32_t> level_offsets;
+				// Per level: set_local() or add() touched a node on it since the last update().
+				std::vector<uint8_t> level_marked;
+				std::vector<uint8_t> chunk_changed;
+				bool reorder = false;
+		};
+
+	template <typename T>
+		constexpr uint32_t transform_hierarchy<T>::null_node;
+
+	template <typename T>
+		const size_t transform_hierarchy<T>::grain;
+
+	typedef transform_hierarchy<float> transform_hierarchyf;
+	typedef transform_hierarchy<double> transform_hierarchyd;
+}
@@ -9,34 +9,25 @@ namespace noob
 		{
 			vec2_type() noexcept(true) = default;
 
-			vec2_type(T x, T y) noexcept(true)
-			{
-				v[0] = x;
-				v[1] = y;
-			}
+			constexpr vec2_type(T x, T y) noexcept(true) : v{{x, y}} {}
 
-			vec2_type(const vec2_type& vv) noexcept(true)
-			{
-				v[0] = vv.v[0];
-				v[1] = vv.v[1];
-			}
+			vec2_type(const vec2_type&) noexcept(true) = default;
+
+			vec2_type& operator=(const vec2_type&) noexcept(true) = default;
 
 			T& operator[](uint32_t x) noexcept(true)
 			{
 				return v[x];
 			}
 
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return v[x];
 			}
 
-			vec2_type operator+(const vec2_type& rhs) const noexcept(true)
+			constexpr vec2_type operator+(const vec2_type& rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] + rhs[0];
-				vc.v[1] = v[1] + rhs[1];
-				return vc;
+				return vec2_type(v[0] + rhs.v[0], v[1] + rhs.v[1]);
 			}
 
 			vec2_type& operator+=(const vec2_type& rhs) noexcept(true)
@@ -46,12 +37,9 @@ namespace noob
 				return *this; // return self
 			}
 
-			vec2_type operator-(const vec2_type& rhs) const noexcept(true)
+			constexpr vec2_type operator-(const vec2_type& rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] - rhs.v[0];
-				vc.v[1] = v[1] - rhs.v[1];
-				return vc;
+				return vec2_type(v[0] - rhs.v[0], v[1] - rhs.v[1]);
 			}
 
 			vec2_type& operator-=(const vec2_type& rhs) noexcept(true)
@@ -61,36 +49,24 @@ namespace noob
 				return *this;
 			}
 
-			vec2_type operator+(T rhs) const noexcept(true)
+			constexpr vec2_type operator+(T rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] + rhs;
-				vc.v[1] = v[1] + rhs;
-				return vc;
+				return vec2_type(v[0] + rhs, v[1] + rhs);
 			}
 
-			vec2_type operator-(T rhs) const noexcept(true)
+			constexpr vec2_type operator-(T rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] - rhs;
-				vc.v[1] = v[1] - rhs;
-				return vc;
+				return vec2_type(v[0] - rhs, v[1] - rhs);
 			}
 
-			vec2_type operator*(T rhs) const noexcept(true)
+			constexpr vec2_type operator*(T rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] * rhs;
-				vc.v[1] = v[1] * rhs;
-				return vc;
+				return vec2_type(v[0] * rhs, v[1] * rhs);
 			}
 
-			vec2_type operator/(T rhs) const noexcept(true)
+			constexpr vec2_type operator/(T rhs) const noexcept(true)
 			{
-				vec2_type vc;
-				vc.v[0] = v[0] / rhs;
-				vc.v[1] = v[1] / rhs;
-				return vc;
+				return vec2_type(v[0] / rhs, v[1] / rhs);
 			}
 
 			vec2_type& operator*=(T rhs) noexcept(true)
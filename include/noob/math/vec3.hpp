@@ -11,27 +11,13 @@ namespace noob
 		{
 			vec3_type() noexcept(true) = default;
 
-			vec3_type(T x, T y, T z) noexcept(true)
-			{
-				v[0] = x;
-				v[1] = y;
-				v[2] = z;
-			}
+			constexpr vec3_type(T x, T y, T z) noexcept(true) : v{{x, y, z}} {}
 
-			vec3_type(const vec3_type& vv) noexcept(true)
-			{
-				v[0] = vv.v[0];
-				v[1] = vv.v[1];
-				v[2] = vv.v[2];
-			}
+			vec3_type(const vec3_type&) noexcept(true) = default;
 
-			vec3_type operator+(const vec3_type& rhs) const noexcept(true)
+			constexpr vec3_type operator+(const vec3_type& rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] + rhs.v[0];
-				vc.v[1] = v[1] + rhs.v[1];
-				vc.v[2] = v[2] + rhs.v[2];
-				return vc;
+				return vec3_type(v[0] + rhs.v[0], v[1] + rhs.v[1], v[2] + rhs.v[2]);
 			}
 
 			vec3_type& operator+=(const vec3_type& rhs) noexcept(true)
@@ -42,13 +28,9 @@ namespace noob
 				return *this; // return self
 			}
 
-			vec3_type operator-(const vec3_type& rhs) const noexcept(true)
+			constexpr vec3_type operator-(const vec3_type& rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] - rhs.v[0];
-				vc.v[1] = v[1] - rhs.v[1];
-				vc.v[2] = v[2] - rhs.v[2];
-				return vc;
+				return vec3_type(v[0] - rhs.v[0], v[1] - rhs.v[1], v[2] - rhs.v[2]);
 			}
 
 			vec3_type& operator-=(const vec3_type& rhs) noexcept(true)
@@ -59,40 +41,24 @@ namespace noob
 				return *this;
 			}
 
-			vec3_type operator+(T rhs) const noexcept(true)
+			constexpr vec3_type operator+(T rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] + rhs;
-				vc.v[1] = v[1] + rhs;
-				vc.v[2] = v[2] + rhs;
-				return vc;
+				return vec3_type(v[0] + rhs, v[1] + rhs, v[2] + rhs);
 			}
 
-			vec3_type operator-(T rhs) const noexcept(true)
+			constexpr vec3_type operator-(T rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] - rhs;
-				vc.v[1] = v[1] - rhs;
-				vc.v[2] = v[2] - rhs;
-				return vc;
+				return vec3_type(v[0] - rhs, v[1] - rhs, v[2] - rhs);
 			}
 
-			vec3_type operator*(T rhs) const noexcept(true)
+			constexpr vec3_type operator*(T rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] * rhs;
-				vc.v[1] = v[1] * rhs;
-				vc.v[2] = v[2] * rhs;
-				return vc;
+				return vec3_type(v[0] * rhs, v[1] * rhs, v[2] * rhs);
 			}
 
-			vec3_type operator/(T rhs) const noexcept(true)
+			constexpr vec3_type operator/(T rhs) const noexcept(true)
 			{
-				vec3_type vc;
-				vc.v[0] = v[0] / rhs;
-				vc.v[1] = v[1] / rhs;
-				vc.v[2] = v[2] / rhs;
-				return vc;
+				return vec3_type(v[0] / rhs, v[1] / rhs, v[2] / rhs);
 			}
 
 			vec3_type& operator*=(T rhs) noexcept(true)
@@ -103,20 +69,14 @@ namespace noob
 				return *this;
 			}
 
-			vec3_type& operator=(const vec3_type& rhs) noexcept(true)
-			{
-				v[0] = rhs.v[0];
-				v[1] = rhs.v[1];
-				v[2] = rhs.v[2];
-				return *this;
-			}
+			vec3_type& operator=(const vec3_type&) noexcept(true) = default;
 
 			T& operator[](uint32_t x) noexcept(true)
 			{
 				return v[x];
 			}
 
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return v[x];
 			}
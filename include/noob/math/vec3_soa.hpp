@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+
+#include "vec3.hpp"
+
+namespace noob
+{
+	// Structure-of-arrays storage for vec3s: one contiguous stream per component, so the batch functions
+	// in math_funcs.hpp can run as many lanes at once as the target instruction set allows.
+	template <typename T>
+		struct vec3_soa
+		{
+			size_t size() const noexcept(true)
+			{
+				return x.size();
+			}
+
+			void resize(size_t n)
+			{
+				x.resize(n);
+				y.resize(n);
+				z.resize(n);
+			}
+
+			void reserve(size_t n)
+			{
+				x.reserve(n);
+				y.reserve(n);
+				z.reserve(n);
+			}
+
+			void clear() noexcept(true)
+			{
+				x.clear();
+				y.clear();
+				z.clear();
+			}
+
+			void push_back(const vec3_type<T>& arg)
+			{
+				x.push_back(arg.v[0]);
+				y.push_back(arg.v[1]);
+				z.push_back(arg.v[2]);
+			}
+
+			vec3_type<T> get(size_t i) const noexcept(true)
+			{
+				return vec3_type<T>(x[i], y[i], z[i]);
+			}
+
+			void set(size_t i, const vec3_type<T>& arg) noexcept(true)
+			{
+				x[i] = arg.v[0];
+				y[i] = arg.v[1];
+				z[i] = arg.v[2];
+			}
+
+			// AoS -> SoA
+			void gather(const vec3_type<T>* src, size_t count)
+			{
+				resize(count);
+				T* xx = x.data();
+				T* yy = y.data();
+				T* zz = z.data();
+				for (size_t i = 0; i < count; ++i)
+				{
+					xx[i] = src[i].v[0];
+					yy[i] = src[i].v[1];
+					zz[i] = src[i].v[2];
+				}
+			}
+
+			void gather(const std::vector<vec3_type<T>>& src)
+			{
+				gather(src.data(), src.size());
+			}
+
+			// SoA -> AoS. dst must hold size() elements.
+			void scatter(vec3_type<T>* dst) const noexcept(true)
+			{
+				const size_t count = size();
+				const T* xx = x.data();
+				const T* yy = y.data();
+				const T* zz = z.data();
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[i].v[0] = xx[i];
+					dst[i].v[1] = yy[i];
+					dst[i].v[2] = zz[i];
+				}
+			}
+
+			void scatter(std::vector<vec3_type<T>>& dst) const
+			{
+				dst.resize(size());
+				scatter(dst.data());
+			}
+
+			std::vector<T> x, y, z;
+		};
+}
@@ -10,40 +10,19 @@ namespace noob
 		struct vec4_type
 		{
 			vec4_type() noexcept(true)  = default;
-			// vec4_type(const vec4_type<T>& rhs) noexcept(true)  = default;
+			vec4_type(const vec4_type<T>& rhs) noexcept(true)  = default;
 
-			vec4_type(T x, T y, T z, T w) noexcept(true)
-			{
-				v[0] = x;
-				v[1] = y;
-				v[2] = z;
-				v[3] = w;
-			}
+			constexpr vec4_type(T x, T y, T z, T w) noexcept(true) : v{{x, y, z, w}} {}
 
-			vec4_type(const vec3_type<T>& arg, T w) noexcept(true)
-			{
-				v[0] = arg.v[0];
-				v[1] = arg.v[1];
-				v[2] = arg.v[2];
-				v[3] = w;
-			}
+			constexpr vec4_type(const vec3_type<T>& arg, T w) noexcept(true) : v{{arg.v[0], arg.v[1], arg.v[2], w}} {}
 
-			vec4_type(const std::array<T, 4>& arg) noexcept(true)
-			{
-				v[0] = arg[0];
-				v[1] = arg[1];
-				v[2] = arg[2];
-				v[3] = arg[3];
-			}
+			constexpr vec4_type(const std::array<T, 4>& arg) noexcept(true) : v(arg) {}
+
+			vec4_type& operator=(const vec4_type&) noexcept(true) = default;
 
-			vec4_type operator+(const vec4_type& rhs) const noexcept(true)
+			constexpr vec4_type operator+(const vec4_type& rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] + rhs.v[0];
-				vc.v[1] = v[1] + rhs.v[1];
-				vc.v[2] = v[2] + rhs.v[2];
-				vc.v[3] = v[3] + rhs.v[3];
-				return vc;
+				return vec4_type(v[0] + rhs.v[0], v[1] + rhs.v[1], v[2] + rhs.v[2], v[3] + rhs.v[3]);
 			}
 
 			vec4_type& operator+=(const vec4_type& rhs) noexcept(true)
@@ -55,14 +34,9 @@ namespace noob
 				return *this; // return self
 			}
 
-			vec4_type operator-(const vec4_type& rhs) const noexcept(true)
+			constexpr vec4_type operator-(const vec4_type& rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] - rhs.v[0];
-				vc.v[1] = v[1] - rhs.v[1];
-				vc.v[2] = v[2] - rhs.v[2];
-				vc.v[3] = v[3] - rhs.v[3];
-				return vc;
+				return vec4_type(v[0] - rhs.v[0], v[1] - rhs.v[1], v[2] - rhs.v[2], v[3] - rhs.v[3]);
 			}
 
 			vec4_type& operator-=(const vec4_type& rhs) noexcept(true)
@@ -74,44 +48,24 @@ namespace noob
 				return *this;
 			}
 
-			vec4_type operator+(T rhs) const noexcept(true)
+			constexpr vec4_type operator+(T rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] + rhs;
-				vc.v[1] = v[1] + rhs;
-				vc.v[2] = v[2] + rhs;
-				vc.v[3] = v[3] + rhs;
-				return vc;
+				return vec4_type(v[0] + rhs, v[1] + rhs, v[2] + rhs, v[3] + rhs);
 			}
 
-			vec4_type operator-(T rhs) const noexcept(true)
+			constexpr vec4_type operator-(T rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] - rhs;
-				vc.v[1] = v[1] - rhs;
-				vc.v[2] = v[2] - rhs;
-				vc.v[3] = v[3] - rhs;
-				return vc;
+				return vec4_type(v[0] - rhs, v[1] - rhs, v[2] - rhs, v[3] - rhs);
 			}
 
-			vec4_type operator*(T rhs) const noexcept(true)
+			constexpr vec4_type operator*(T rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] * rhs;
-				vc.v[1] = v[1] * rhs;
-				vc.v[2] = v[2] * rhs;
-				vc.v[3] = v[3] * rhs;
-				return vc;
+				return vec4_type(v[0] * rhs, v[1] * rhs, v[2] * rhs, v[3] * rhs);
 			}
 
-			vec4_type operator/(T rhs) const noexcept(true)
+			constexpr vec4_type operator/(T rhs) const noexcept(true)
 			{
-				vec4_type vc;
-				vc.v[0] = v[0] / rhs;
-				vc.v[1] = v[1] / rhs;
-				vc.v[2] = v[2] / rhs;
-				vc.v[3] = v[3] / rhs;
-				return vc;
+				return vec4_type(v[0] / rhs, v[1] / rhs, v[2] / rhs, v[3] / rhs);
 			}
 
 			vec4_type& operator*=(T rhs) noexcept(true)
@@ -128,7 +82,7 @@ namespace noob
 				return v[x];
 			}
 
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return v[x];
 			}
@@ -0,0 +1,210 @@
+#pragma once
+
+// Opt-in expression templates for vec2_type/vec3_type/vec4_type.
+//
+// Wrapping an operand with noob::lazy() makes the arithmetic operators build a small expression tree instead of a vector
+// temporary per operator. Nothing is computed until the expression is converted to a concrete vector, which then
+// computes each component in a single pass:
+//
+//	noob::vec3f p = noob::lazy(a) + (noob::lazy(b) - a) * t;
+//
+// Plain vec*_type arithmetic is untouched unless one side is already an expression. Expressions hold references to their
+// vector operands, so consume them in the same full-expression; don't store one in an auto variable.
+//
+// This is about avoiding temporaries, not speed: the eager operators are inlined, and GCC folds their temporaries away too.
+// With -O2, a chain like a + (b - c) * s + a * s measured 0.83-1.1x the speed of the eager form; don't expect a win.
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+namespace noob
+{
+	template <typename T, uint32_t N> struct vec_of;
+	template <typename T> struct vec_of<T, 2> { typedef vec2_type<T> type; };
+	template <typename T> struct vec_of<T, 3> { typedef vec3_type<T> type; };
+	template <typename T> struct vec_of<T, 4> { typedef vec4_type<T> type; };
+
+	// CRTP base: every expression node knows its component type and count, and evaluates into the matching vector type.
+	template <typename E, typename T, uint32_t N>
+		struct vec_expr
+		{
+			typedef T value_type;
+			static const uint32_t size = N;
+
+			T operator[](uint32_t i) const noexcept(true)
+			{
+				return static_cast<const E&>(*this)[i];
+			}
+
+			typename vec_of<T, N>::type eval() const noexcept(true)
+			{
+				typename vec_of<T, N>::type results;
+				eval_into(results.v, std::integral_constant<uint32_t, 0>());
+				return results;
+			}
+
+			operator typename vec_of<T, N>::type() const noexcept(true)
+			{
+				return eval();
+			}
+
+			// Writes one component per instantiation, so the loop is unrolled even at -O2 and the result stays in registers.
+			template <uint32_t I>
+				void eval_into(std::array<T, N>& results, std::integral_constant<uint32_t, I>) const noexcept(true)
+				{
+					results[I] = static_cast<const E&>(*this)[I];
+					eval_into(results, std::integral_constant<uint32_t, I + 1>());
+				}
+
+			void eval_into(std::array<T, N>&, std::integral_constant<uint32_t, N>) const noexcept(true) {}
+		};
+
+	// Leaf: a reference to an existing vector's components.
+	template <typename T, uint32_t N>
+		struct vec_ref : public vec_expr<vec_ref<T, N>, T, N>
+		{
+			explicit vec_ref(const std::array<T, N>& arg) noexcept(true) : v(arg) {}
+
+			T operator[](uint32_t i) const noexcept(true)
+			{
+				return v[i];
+			}
+
+			const std::array<T, N>& v;
+		};
+
+	struct expr_add { template <typename T> static T apply(T a, T b) noexcept(true) { return a + b; } };
+	struct expr_sub { template <typename T> static T apply(T a, T b) noexcept(true) { return a - b; } };
+	struct expr_mul { template <typename T> static T apply(T a, T b) noexcept(true) { return a * b; } };
+	struct expr_div { template <typename T> static T apply(T a, T b) noexcept(true) { return a / b; } };
+
+	// Component-wise combination of two expressions of the same size.
+	template <typename L, typename R, typename Op>
+		struct vec_binary : public vec_expr<vec_binary<L, R, Op>, typename L::value_type, L::size>
+		{
+			static_assert(L::size == R::size, "vector expressions must have the same number of components");
+
+			vec_binary(const L& l, const R& r) noexcept(true) : lhs(l), rhs(r) {}
+
+			typename L::value_type operator[](uint32_t i) const noexcept(true)
+			{
+				return Op::apply(lhs[i], rhs[i]);
+			}
+
+			const L lhs;
+			const R rhs;
+		};
+
+	// An expression combined with a scalar. ScalarFirst selects s op e[i] instead of e[i] op s.
+	template <typename E, typename Op, bool ScalarFirst>
+		struct vec_scalar : public vec_expr<vec_scalar<E, Op, ScalarFirst>, typename E::value_type, E::size>
+		{
+			typedef typename E::value_type T;
+
+			vec_scalar(const E& e, T s) noexcept(true) : expr(e), scalar(s) {}
+
+			T operator[](uint32_t i) const noexcept(true)
+			{
+				return ScalarFirst ? Op::apply(scalar, expr[i]) : Op::apply(expr[i], scalar);
+			}
+
+			const E expr;
+			const T scalar;
+		};
+
+	template <typename E>
+		struct vec_negate : public vec_expr<vec_negate<E>, typename E::value_type, E::size>
+		{
+			explicit vec_negate(const E& e) noexcept(true) : expr(e) {}
+
+			typename E::value_type operator[](uint32_t i) const noexcept(true)
+			{
+				return -expr[i];
+			}
+
+			const E expr;
+		};
+
+	// Entry points into the expression layer.
+	template <typename T>
+		static vec_ref<T, 2> lazy(const vec2_type<T>& arg) noexcept(true)
+		{
+			return vec_ref<T, 2>(arg.v);
+		}
+
+	template <typename T>
+		static vec_ref<T, 3> lazy(const vec3_type<T>& arg) noexcept(true)
+		{
+			return vec_ref<T, 3>(arg.v);
+		}
+
+	template <typename T>
+		static vec_ref<T, 4> lazy(const vec4_type<T>& arg) noexcept(true)
+		{
+			return vec_ref<T, 4>(arg.v);
+		}
+
+	// Binary operators. A concrete vector may appear on either side as long as the other side is an expression.
+#define NOOB_VEC_EXPR_BINARY_OP(OP, FUNCTOR) \
+	template <typename L, typename R, typename T, uint32_t N> \
+		static vec_binary<L, R, FUNCTOR> operator OP(const vec_expr<L, T, N>& l, const vec_expr<R, T, N>& r) noexcept(true) \
+		{ \
+			return vec_binary<L, R, FUNCTOR>(static_cast<const L&>(l), static_cast<const R&>(r)); \
+		} \
+	template <typename L, typename T, uint32_t N> \
+		static vec_binary<L, vec_ref<T, N>, FUNCTOR> operator OP(const vec_expr<L, T, N>& l, const typename vec_of<T, N>::type& r) noexcept(true) \
+		{ \
+			return vec_binary<L, vec_ref<T, N>, FUNCTOR>(static_cast<const L&>(l), vec_ref<T, N>(r.v)); \
+		} \
+	template <typename R, typename T, uint32_t N> \
+		static vec_binary<vec_ref<T, N>, R, FUNCTOR> operator OP(const typename vec_of<T, N>::type& l, const vec_expr<R, T, N>& r) noexcept(true) \
+		{ \
+			return vec_binary<vec_ref<T, N>, R, FUNCTOR>(vec_ref<T, N>(l.v), static_cast<const R&>(r)); \
+		}
+
+	NOOB_VEC_EXPR_BINARY_OP(+, expr_add)
+	NOOB_VEC_EXPR_BINARY_OP(-, expr_sub)
+
+#undef NOOB_VEC_EXPR_BINARY_OP
+
+	// Scalars are taken as std::common_type<T>::type so they don't take part in deduction and literals like 0.5 convert.
+#define NOOB_VEC_EXPR_SCALAR_OP(OP, FUNCTOR) \
+	template <typename E, typename T, uint32_t N> \
+		static vec_scalar<E, FUNCTOR, false> operator OP(const vec_expr<E, T, N>& e, typename std::common_type<T>::type s) noexcept(true) \
+		{ \
+			return vec_scalar<E, FUNCTOR, false>(static_cast<const E&>(e), s); \
+		}
+
+	NOOB_VEC_EXPR_SCALAR_OP(+, expr_add)
+	NOOB_VEC_EXPR_SCALAR_OP(-, expr_sub)
+	NOOB_VEC_EXPR_SCALAR_OP(*, expr_mul)
+	NOOB_VEC_EXPR_SCALAR_OP(/, expr_div)
+
+#undef NOOB_VEC_EXPR_SCALAR_OP
+
+	// The same four with the scalar on the left, computing s op e[i].
+#define NOOB_VEC_EXPR_SCALAR_FIRST_OP(OP, FUNCTOR) \
+	template <typename E, typename T, uint32_t N> \
+		static vec_scalar<E, FUNCTOR, true> operator OP(typename std::common_type<T>::type s, const vec_expr<E, T, N>& e) noexcept(true) \
+		{ \
+			return vec_scalar<E, FUNCTOR, true>(static_cast<const E&>(e), s); \
+		}
+
+	NOOB_VEC_EXPR_SCALAR_FIRST_OP(+, expr_add)
+	NOOB_VEC_EXPR_SCALAR_FIRST_OP(-, expr_sub)
+	NOOB_VEC_EXPR_SCALAR_FIRST_OP(*, expr_mul)
+	NOOB_VEC_EXPR_SCALAR_FIRST_OP(/, expr_div)
+
+#undef NOOB_VEC_EXPR_SCALAR_FIRST_OP
+
+	template <typename E, typename T, uint32_t N>
+		static vec_negate<E> operator-(const vec_expr<E, T, N>& e) noexcept(true)
+		{
+			return vec_negate<E>(static_cast<const E&>(e));
+		}
+}
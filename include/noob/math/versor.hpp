@@ -12,55 +12,25 @@ namespace noob
 		{
 			versor_type() noexcept(true) = default;
 
-			versor_type(T x, T y, T z, T w) noexcept(true)
-			{
-				q[0] = x;
-				q[1] = y;
-				q[2] = z;
-				q[3] = w;
-			}
+			// Components are stored w first: q[0] is w, q[1..3] are x, y, z.
+			constexpr versor_type(T w, T x, T y, T z) noexcept(true) : q{{w, x, y, z}} {}
 
-			versor_type(const noob::vec3_type<T>& Arg, T w) noexcept(true)
-			{
-				q[0] = Arg[0];
-				q[1] = Arg[1];
-				q[2] = Arg[2];
-				q[3] = w;
-			}
-			versor_type(const std::array<T, 4>& Arg) noexcept(true)
-			{
-				q[0] = Arg[0];
-				q[1] = Arg[1];
-				q[2] = Arg[2];
-				q[3] = Arg[3];
-			}
+			constexpr versor_type(const noob::vec3_type<T>& Arg, T w) noexcept(true) : q{{w, Arg[0], Arg[1], Arg[2]}} {}
 
-			versor_type(const noob::vec4_type<T>& Arg) noexcept(true)
-			{
-				q[0] = Arg[0];
-				q[1] = Arg[1];
-				q[2] = Arg[2];
-				q[3] = Arg[3];
-			}
+			constexpr versor_type(const std::array<T, 4>& Arg) noexcept(true) : q(Arg) {}
+
+			constexpr versor_type(const noob::vec4_type<T>& Arg) noexcept(true) : q(Arg.v) {}
 
-			versor_type operator/(T rhs) const noexcept(true)
+			versor_type(const versor_type&) noexcept(true) = default;
+
+			constexpr versor_type operator/(T rhs) const noexcept(true)
 			{
-				versor_type result;
-				result.q[0] = q[0] / rhs;
-				result.q[1] = q[1] / rhs;
-				result.q[2] = q[2] / rhs;
-				result.q[3] = q[3] / rhs;
-				return result;
+				return versor_type(q[0] / rhs, q[1] / rhs, q[2] / rhs, q[3] / rhs);
 			}
 
-			versor_type operator*(T rhs) const noexcept(true)
+			constexpr versor_type operator*(T rhs) const noexcept(true)
 			{
-				versor_type result;
-				result.q[0] = q[0] * rhs;
-				result.q[1] = q[1] * rhs;
-				result.q[2] = q[2] * rhs;
-				result.q[3] = q[3] * rhs;
-				return result;
+				return versor_type(q[0] * rhs, q[1] * rhs, q[2] * rhs, q[3] * rhs);
 			}
 
 			versor_type operator*(const versor_type& rhs) const noexcept(true)
@@ -89,21 +59,14 @@ namespace noob
 				return normalize (result);
 			}
 
-			versor_type& operator=(const versor_type& rhs) noexcept(true)
-			{
-				q[0] = rhs.q[0];
-				q[1] = rhs.q[1];
-				q[2] = rhs.q[2];
-				q[3] = rhs.q[3];
-				return *this;
-			}
+			versor_type& operator=(const versor_type&) noexcept(true) = default;
 
 			T& operator[](uint32_t x) noexcept(true)
 			{
 				return q[x];
 			}
 		
-			const T& operator[](uint32_t x) const noexcept(true)
+			constexpr const T& operator[](uint32_t x) const noexcept(true)
 			{
 				return q[x];
 			}
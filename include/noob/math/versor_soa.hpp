@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "versor.hpp"
+
+namespace noob
+{
+	// Structure-of-arrays storage for versors: q[k] holds component k (same order as versor_type::q) of every quaternion,
+	// so the batch interpolation functions can blend one joint per SIMD lane.
+	template <typename T>
+		struct versor_soa
+		{
+			size_t size() const noexcept(true)
+			{
+				return q[0].size();
+			}
+
+			void resize(size_t n)
+			{
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					q[k].resize(n);
+				}
+			}
+
+			void reserve(size_t n)
+			{
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					q[k].reserve(n);
+				}
+			}
+
+			void clear() noexcept(true)
+			{
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					q[k].clear();
+				}
+			}
+
+			void push_back(const versor_type<T>& arg)
+			{
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					q[k].push_back(arg.q[k]);
+				}
+			}
+
+			versor_type<T> get(size_t i) const noexcept(true)
+			{
+				versor_type<T> results;
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					results.q[k] = q[k][i];
+				}
+				return results;
+			}
+
+			void set(size_t i, const versor_type<T>& arg) noexcept(true)
+			{
+				for (uint32_t k = 0; k < 4; ++k)
+				{
+					q[k][i] = arg.q[k];
+				}
+			}
+
+			// AoS -> SoA
+			void gather(const versor_type<T>* src, size_t count)
+			{
+				resize(count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					set(i, src[i]);
+				}
+			}
+
+			void gather(const std::vector<versor_type<T>>& src)
+			{
+				gather(src.data(), src.size());
+			}
+
+			// SoA -> AoS. dst must hold size() elements.
+			void scatter(versor_type<T>* dst) const noexcept(true)
+			{
+				const size_t count = size();
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[i] = get(i);
+				}
+			}
+
+			std::array<std::vector<T>, 4> q;
+		};
+}
@@ -0,0 +1,172 @@
+// Consistency checks for noob/math/aabb_tree.hpp. Exits non-zero and names the failing check if any of them fails.
+//
+// Build it next to the headers, eg:
+//	g++ -std=c++14 -O2 -Iinclude -I/usr/include/eigen3 tests/aabb_tree_test.cpp -o aabb_tree_test
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "noob/math/aabb_tree.hpp"
+
+namespace
+{
+	uint32_t failures = 0;
+
+	void check(bool ok, const char* type, const char* what)
+	{
+		if (!ok)
+		{
+			std::fprintf(stderr, "aabb_tree<%s>: %s\n", type, what);
+			++failures;
+		}
+	}
+
+	template <typename T>
+		noob::bbox_type<T> make_box(T x, T y, T z, T size)
+		{
+			noob::bbox_type<T> b;
+			b.min = noob::vec3_type<T>(x, y, z);
+			b.max = noob::vec3_type<T>(x + size, y + size, z + size);
+			return b;
+		}
+
+	// Every overlapping pair of the given leaves' fat boxes, smaller handle first, sorted.
+	template <typename T>
+		std::vector<std::pair<uint32_t, uint32_t>> brute_force_pairs(const noob::aabb_tree<T>& tree, const std::vector<uint32_t>& live)
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			for (size_t i = 0; i < live.size(); ++i)
+			{
+				for (size_t j = i + 1; j < live.size(); ++j)
+				{
+					if (noob::overlaps(tree.get_box(live[i]), tree.get_box(live[j])))
+					{
+						pairs.push_back(std::make_pair(std::min(live[i], live[j]), std::max(live[i], live[j])));
+					}
+				}
+			}
+			std::sort(pairs.begin(), pairs.end());
+			return pairs;
+		}
+
+	// Removing a leaf that set_box() queued for refit() used to leave it queued, and refit() then walked the free list.
+	template <typename T>
+		void test_remove_queued(const char* type)
+		{
+			noob::aabb_tree<T> t(0.1);
+			const uint32_t a = t.insert(make_box<T>(0.0, 0.0, 0.0, 1.0));
+			const uint32_t b = t.insert(make_box<T>(2.0, 0.0, 0.0, 1.0));
+			const uint32_t c = t.insert(make_box<T>(4.0, 0.0, 0.0, 1.0));
+			t.set_box(c, make_box<T>(9.0, 5.0, 5.0, 1.0));
+			t.remove(a);
+			t.remove(c);
+			t.refit();
+			uint32_t hits = 0;
+			t.overlap(make_box<T>(2.0, 0.0, 0.0, 1.0), [&](uint32_t h) { hits += (h == b); });
+			check(t.size() == 1 && hits == 1, type, "remove after set_box left the tree inconsistent");
+		}
+
+	// Removing from the middle of the queues must keep the other queued leaves: the moved ones still report their pairs.
+	template <typename T>
+		void test_remove_keeps_queue(const char* type)
+		{
+			noob::aabb_tree<T> t(0.1);
+			std::vector<uint32_t> h;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				h.push_back(t.insert(make_box<T>(static_cast<T>(i) * 3.0, 0.0, 0.0, 1.0)));
+			}
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			t.find_moved_pairs(pairs);
+			check(pairs.empty(), type, "separated leaves reported a pair");
+
+			// Leaves 0, 1 and 3 each move next to a resting partner; 1 is then removed from the middle of both queues.
+			const uint32_t p0 = t.insert(make_box<T>(50.0, 0.0, 0.0, 1.0));
+			const uint32_t p3 = t.insert(make_box<T>(80.0, 0.0, 0.0, 1.0));
+			t.find_moved_pairs(pairs);
+			pairs.clear();
+			t.set_box(h[0], make_box<T>(50.5, 0.0, 0.0, 1.0));
+			t.set_box(h[1], make_box<T>(60.0, 0.0, 0.0, 1.0));
+			t.set_box(h[3], make_box<T>(80.5, 0.0, 0.0, 1.0));
+			t.remove(h[1]);
+			t.refit();
+			t.find_moved_pairs(pairs);
+			std::sort(pairs.begin(), pairs.end());
+			std::vector<std::pair<uint32_t, uint32_t>> expected;
+			expected.push_back(std::make_pair(std::min(h[0], p0), std::max(h[0], p0)));
+			expected.push_back(std::make_pair(std::min(h[3], p3), std::max(h[3], p3)));
+			std::sort(expected.begin(), expected.end());
+			check(pairs == expected, type, "remove dropped another leaf from the moved queue");
+		}
+
+	// Random inserts, moves and removes, then find_pairs() against a brute-force check of the fat boxes.
+	template <typename T>
+		void test_random(const char* type)
+		{
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<T> pos(0.0, 40.0);
+			std::uniform_int_distribution<uint32_t> op(0, 9);
+			noob::aabb_tree<T> t(0.1);
+			std::vector<uint32_t> live;
+			for (uint32_t step = 0; step < 4000; ++step)
+			{
+				const uint32_t o = op(rng);
+				if (live.empty() || o < 4)
+				{
+					live.push_back(t.insert(make_box<T>(pos(rng), pos(rng), pos(rng), 1.0)));
+				}
+				else if (o < 6)
+				{
+					const size_t i = rng() % live.size();
+					t.remove(live[i]);
+					live[i] = live.back();
+					live.pop_back();
+				}
+				else if (o < 8)
+				{
+					t.set_box(live[rng() % live.size()], make_box<T>(pos(rng), pos(rng), pos(rng), 1.0));
+				}
+				else
+				{
+					t.update(live[rng() % live.size()], make_box<T>(pos(rng), pos(rng), pos(rng), 1.0));
+				}
+				if (step % 97 == 0)
+				{
+					t.refit();
+					std::vector<std::pair<uint32_t, uint32_t>> moved;
+					t.find_moved_pairs(moved);
+				}
+			}
+			t.refit();
+			check(t.size() == live.size(), type, "size() doesn't match the live leaves");
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			t.find_pairs(pairs);
+			std::sort(pairs.begin(), pairs.end());
+			check(pairs == brute_force_pairs(t, live), type, "find_pairs() disagrees with brute force");
+		}
+
+	template <typename T>
+		void run_all(const char* type)
+		{
+			test_remove_queued<T>(type);
+			test_remove_keeps_queue<T>(type);
+			test_random<T>(type);
+		}
+}
+
+int main()
+{
+	run_all<float>("float");
+	run_all<double>("double");
+	if (failures != 0)
+	{
+		std::fprintf(stderr, "%u check(s) failed\n", failures);
+		return 1;
+	}
+	std::printf("aabb_tree: all checks passed\n");
+	return 0;
+}